@@ -16,6 +16,7 @@ export import :chrono;
 export import :logic;
 export import :math;
 export import :memory;
+export import :mpsc_queue;
 export import :ratio;
 export import :spans;
 export import :static_string_builder;
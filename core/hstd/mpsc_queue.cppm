@@ -0,0 +1,117 @@
+module;
+
+#include <array>
+#include <atomic>
+#include <concepts>
+#include <cstddef>
+#include <optional>
+#include <utility>
+
+export module hstd:mpsc_queue;
+
+import :atomic;
+import :math;
+
+namespace hstd {
+
+/**
+ * Lock-free bounded MPSC queue. Producers (e.g. ISRs or host threads) reserve
+ * a slot by a compare-and-swap on the head, and every slot has a sequence
+ * number that indicates whether it is free or holds an element, so that the
+ * consumer never observes a partially written element
+ * @tparam T Element type
+ * @tparam N Queue depth, must be a power of two
+ * @tparam A Atomic type of the positions, e.g. the atomic type of a system
+ * @tparam Align Alignment of the head and the tail. A cache line keeps the
+ * producers from invalidating the tail of the consumer on the host
+ */
+export template <typename T, std::size_t N,
+                 Atomic A = std::atomic<std::size_t>,
+                 std::size_t Align = alignof(A)>
+  requires(IsPowerOf2(N) && std::same_as<typename A::value_type, std::size_t>)
+class MpscQueue {
+ public:
+  MpscQueue() noexcept {
+    for (std::size_t i = 0; i < N; ++i) {
+      slots[i].sequence.store(i, std::memory_order_relaxed);
+    }
+  }
+
+  MpscQueue(const MpscQueue&)            = delete;
+  MpscQueue(MpscQueue&&)                 = delete;
+  MpscQueue& operator=(const MpscQueue&) = delete;
+  MpscQueue& operator=(MpscQueue&&)      = delete;
+
+  /**
+   * Pushes an element to the queue. Safe to call from multiple producers
+   * @param value Element to push
+   * @return Whether the element was pushed, false if the queue was full
+   */
+  bool Push(const T& value) noexcept {
+    auto pos = head.load(std::memory_order_relaxed);
+
+    while (true) {
+      auto&      slot = slots[pos & (N - 1)];
+      const auto diff = static_cast<std::ptrdiff_t>(
+          slot.sequence.load(std::memory_order_acquire) - pos);
+
+      if (diff == 0) {
+        // On failure, pos is updated to the current head
+        if (head.compare_exchange_strong(pos, pos + 1,
+                                         std::memory_order_relaxed)) {
+          slot.value = value;
+          slot.sequence.store(pos + 1, std::memory_order_release);
+          return true;
+        }
+      } else if (diff < 0) {
+        // Slot still holds an element of the previous lap
+        return false;
+      } else {
+        // Another producer reserved the slot in the meantime
+        pos = head.load(std::memory_order_relaxed);
+      }
+    }
+  }
+
+  /**
+   * Pops an element from the queue. Must only be called by the single
+   * consumer
+   * @return Popped element, or std::nullopt if the queue was empty or the
+   * oldest element is not fully written yet
+   */
+  std::optional<T> Pop() noexcept {
+    auto& slot = slots[tail & (N - 1)];
+    if (slot.sequence.load(std::memory_order_acquire) != tail + 1) {
+      return std::nullopt;
+    }
+
+    auto result = std::move(slot.value);
+    slot.value.reset();
+    slot.sequence.store(tail + N, std::memory_order_release);
+    tail++;
+    return result;
+  }
+
+  /**
+   * Empties the queue, and calls a handler on every element in insertion
+   * order. Must only be called by the single consumer
+   * @param handler Handler to call for every element
+   */
+  void ReadAll(std::invocable<const T&> auto handler) {
+    while (auto value = Pop()) {
+      handler(*value);
+    }
+  }
+
+ private:
+  struct Slot {
+    A                sequence{0};   //!< Lap in which the slot is free or full
+    std::optional<T> value{};       //!< Element, if the slot is full
+  };
+
+  alignas(Align) A head{0};             //!< Write position of the producers
+  alignas(Align) std::size_t tail{0};   //!< Read position of the consumer
+  std::array<Slot, N> slots{};
+};
+
+}   // namespace hstd
@@ -8,6 +8,11 @@ export module statechart:core;
 
 import hstd;
 
+import :event_queue;
+import :hierarchy;
+import :trace;
+import :transition_table;
+
 namespace sc {
 
 export template <typename... S>
@@ -70,6 +75,34 @@ struct TransitionList {
   using FindTransition = typename FindTransitionHelper<Src, Event>::Result;
 };
 
+template <typename TrL, typename Event, typename Candidates>
+struct TransitionSourceHelper;
+
+template <typename TrL, typename Event, typename Cur, typename... Rest>
+struct TransitionSourceHelper<TrL, Event, hstd::Types<Cur, Rest...>> {
+  using Result = std::conditional_t<
+      TrL::template ContainsTransition<Cur, Event>(), Cur,
+      typename TransitionSourceHelper<TrL, Event,
+                                      hstd::Types<Rest...>>::Result>;
+};
+
+template <typename TrL, typename Event>
+struct TransitionSourceHelper<TrL, Event, hstd::Types<>> {
+  using Result = void;
+};
+
+/**
+ * State whose transition handles an event in the given state: the state
+ * itself if it has a transition for the event, otherwise its innermost
+ * ancestor that has one. void if the event is not handled
+ * @tparam TrL Transition list
+ * @tparam S State
+ * @tparam Event Event
+ */
+template <typename TrL, typename S, typename Event>
+using TransitionSource =
+    typename TransitionSourceHelper<TrL, Event, Ancestors<S>>::Result;
+
 export template <typename T>
 struct IsInStateImpl {
   [[nodiscard]] constexpr bool operator()(const T&) const noexcept {
@@ -113,7 +146,9 @@ Transitions(Ts...) -> Transitions<Ts...>;
 export template <typename SL, typename EL>
 struct StateChart;
 
-export template <typename Sys, typename SC>
+export template <typename Sys, typename SC, std::size_t QueueDepth = 4,
+                 TableEncoding Enc = TableEncoding::Dense,
+                 TransitionObserver Obs = NullObserver>
 class StateChartRunner;
 
 template <typename... Ss, typename... Es>
@@ -123,44 +158,64 @@ struct StateChart<States<Ss...>, Events<Es...>> {
 
   template <typename... Trs>
   class Chart<Transitions<Trs...>> : Trs... {
-    static constexpr std::size_t NStates = sizeof...(Ss);
-    static constexpr std::size_t NEvents = sizeof...(Es);
     using TrList = typename Transitions<Trs...>::TransitionList;
 
-    template <typename Sys, typename T>
+    template <typename Sys, typename T, std::size_t QD, TableEncoding E,
+              TransitionObserver O>
     friend class StateChartRunner;
 
     using Trs::operator()...;
 
    public:
+    static constexpr std::size_t NStates = sizeof...(Ss);
+    static constexpr std::size_t NEvents = sizeof...(Es);
+
+    /** States of the chart, in the order of their indices */
+    using StateTypes = hstd::Types<Ss...>;
+    /** Events of the chart, in the order of their indices */
+    using EventTypes = hstd::Types<Es...>;
+
     template <typename Si>
       requires(... || std::is_same_v<std::decay_t<Si>, Ss>)
     explicit Chart(Si initial_state, Transitions<Trs...>) noexcept
-        : state{initial_state} {}
+        : state{initial_state} {
+      EnterStates<void>(std::get<std::decay_t<Si>>(state));
+    }
 
    protected:
     using Event = std::variant<Es...>;
 
-    template <typename S, typename E>
+    /**
+     * Applies the transition of state From, which is either S itself or one
+     * of its ancestors, to an event in state S. The transition handler runs
+     * first, as it determines the destination state. Then the exit hooks of
+     * the source states and the entry hooks of the destination states up to
+     * their common ancestor are called
+     * @tparam S Active state
+     * @tparam From State that defines the transition
+     * @tparam E Event type
+     * @param event Event to apply
+     */
+    template <typename S, typename From, typename E>
     void Apply(const std::variant<Es...>& event) noexcept {
-      const E& e = std::get<E>(event);
-      const S& s = std::get<S>(state);
+      const E&    e    = std::get<E>(event);
+      const From& from = std::get<S>(state);
 
-      using ReturnType = decltype((*this)(s, e));
+      using ReturnType = decltype((*this)(from, e));
 
       if constexpr (IsValidState<ReturnType>()) {
-        state.template emplace<ReturnType>((*this)(s, e));
+        TransitTo<S>((*this)(from, e));
       } else if constexpr (hstd::IsInstantiationOfVariadic<ReturnType,
                                                              std::variant<>>) {
-        auto result = (*this)(s, e);
-        ([this]<typename... Rs>(const std::variant<Rs...>& result) {
+        auto result = (*this)(from, e);
+        ([this]<typename... Rs>(std::variant<Rs...>& result) {
           static_assert((... && IsValidState<Rs>()),
                         "Every option in a variant returned by an event "
                         "handler must be a valid state");
 
           (..., ([this, &result]<typename R>(hstd::Marker<R>) {
              if (std::holds_alternative<R>(result)) {
-               state.template emplace<R>(std::move(std::get<R>(result)));
+               TransitTo<S>(std::move(std::get<R>(result)));
              }
            })(hstd::Marker<Rs>()));
         })(result);
@@ -170,6 +225,23 @@ struct StateChart<States<Ss...>, Events<Es...>> {
       }
     }
 
+    /**
+     * Replaces the active state S by a new state, calling the exit and entry
+     * hooks of the states that are left and entered
+     * @tparam S Active state
+     * @tparam D Destination state
+     * @param next New state
+     */
+    template <typename S, typename D>
+    void TransitTo(D&& next) noexcept {
+      using Dst    = std::decay_t<D>;
+      using Common = CommonAncestor<S, Dst>;
+
+      ExitStates<Common>(std::get<S>(state));
+      EnterStates<Common>(
+          state.template emplace<Dst>(std::forward<D>(next)));
+    }
+
     template <typename S>
       requires(... || std::is_same_v<S, Ss>)
     [[nodiscard]] static consteval std::size_t StateIndex() noexcept {
@@ -199,12 +271,14 @@ struct StateChart<States<Ss...>, Events<Es...>> {
             NStates>& table) {
       using StateList = hstd::Types<Ss...>;
       using EventList = hstd::Types<Es...>;
-      if constexpr (TrList::template ContainsTransition<S, E>()) {
-        // const auto SI = *;
+      // Transitions of ancestors are inherited, so that dispatching stays a
+      // single table lookup
+      using From = TransitionSource<TrList, S, E>;
+      if constexpr (!std::is_void_v<From>) {
         table[*StateList::template IndexOf<S>()]
              [*EventList::template IndexOf<E>()] =
                  static_cast<void (Chart::*)(const std::variant<Es...>&)>(
-                     &Chart::template Apply<S, E>);
+                     &Chart::template Apply<S, From, E>);
       }
     }
 
@@ -233,13 +307,37 @@ struct StateChart<States<Ss...>, Events<Es...>> {
   Chart(Si, Tr) -> Chart<Tr>;
 };
 
-template <typename Sys, typename SC>
+/**
+ * Runs a state chart. Events can either be applied immediately, or enqueued
+ * (e.g. from an ISR) to be processed later in a batch
+ * @tparam Sys System, providing the atomic types
+ * @tparam SC State chart type
+ * @tparam QueueDepth Maximum number of enqueued events, must be a power of two
+ * @tparam Enc Transition table encoding. Dense by default, as it has the
+ * fastest lookup, Automatic selects the smallest encoding instead
+ * @tparam Obs Transition observer, e.g. a Tracer. Does nothing by default
+ */
+template <typename Sys, typename SC, std::size_t QueueDepth, TableEncoding Enc,
+          TransitionObserver Obs>
 class StateChartRunner {
+  static constexpr auto Cells = SC::BuildTransitionTable();
+  using Handler = typename decltype(Cells)::value_type::value_type;
+
  public:
-  static constexpr auto JumpTable = SC::BuildTransitionTable();
+  /** Number of transitions in the transition table */
+  static constexpr std::size_t NTransitions = CountTransitions(Cells);
+  /** Number of distinct transition handlers */
+  static constexpr std::size_t NHandlers = CountUniqueHandlers(Cells);
+
+  /** Transition table, in the requested or smallest encoding */
+  static constexpr TransitionTableFor<Enc, Handler, SC::NStates, SC::NEvents,
+                                      NTransitions, NHandlers>
+      JumpTable{Cells};
 
   StateChartRunner(hstd::Marker<Sys>, SC&& chart)
-      : chart{std::move(chart)} {}
+      : chart{std::move(chart)} {
+    observer.OnStart(this->chart.state.index());
+  }
 
   /**
    * Immediately applies an event to the state chart. This method should not
@@ -252,32 +350,12 @@ class StateChartRunner {
     requires(SC::template IsValidEvent<E>())
   [[nodiscard]] bool ApplyEvent(E event) noexcept {
     const auto inner = [&, this] {
-      // Optionally process any pending event
-      if (has_enqueued_event.test_and_set()) {
-        if (enqueued_event.has_value()) {
-          const auto& ee = *enqueued_event;
-
-          const auto ee_idx = ee.index();
-          const auto s_idx  = chart.state.index();
-          if (const auto tr_method = JumpTable[s_idx][ee_idx];
-              tr_method != nullptr) {
-            (chart.*tr_method)(ee);
-          }
-        }
-
-        enqueued_event.reset();
-        has_enqueued_event.clear();
-      }
+      // Process any pending events first, to preserve the event order
+      DrainEnqueuedEvents();
 
       // Process the incoming event
       constexpr auto Ei = SC::template EventIndex<std::decay_t<E>>();
-      if (const auto tr_method = JumpTable[chart.state.index()][Ei];
-          tr_method != nullptr) {
-        (chart.*tr_method)(event);
-        return true;
-      }
-
-      return false;
+      return Dispatch(Ei, typename SC::Event{event});
     };
 
     return hstd::ExclusiveWithAtomicFlag(processing_event, inner)
@@ -286,45 +364,25 @@ class StateChartRunner {
 
   /**
    * Enqueues an event to be processed later. This method should typically
-   * be used from an ISR context
+   * be used from an ISR context, and may be called from multiple contexts
+   * concurrently
    * @tparam E Event type
+   * @return Whether the event was enqueued, false if the queue was full
    */
   template <typename E>
     requires(SC::template IsValidEvent<E>())
   bool EnqueueEvent(E event) noexcept {
-    const auto event_already_enqueued = has_enqueued_event.test_and_set();
-    if (!event_already_enqueued) {
-      enqueued_event = event;
-      return true;
-    }
-
-    return false;
+    return queue.Push(typename SC::Event{event});
   }
 
   /**
-   * Processes any event that was previously enqueued by EnqueueEvent
+   * Processes the events that were previously enqueued by EnqueueEvent in
+   * order. At most QueueDepth events are processed per call, so that an ISR
+   * that keeps enqueueing events cannot starve the caller
    */
   void ProcessEnqueuedEvent() noexcept {
-    if (has_enqueued_event.test()) {
-      const auto inner = [&, this] {
-        if (enqueued_event.has_value()) {
-          const auto ee = *enqueued_event;
-          enqueued_event.reset();
-          has_enqueued_event.clear();
-
-          const auto s_idx  = chart.state.index();
-          const auto ee_idx = ee.index();
-          if (const auto tr_method = JumpTable[s_idx][ee_idx];
-              tr_method != nullptr) {
-            (chart.*tr_method)(ee);
-          }
-        } else {
-          has_enqueued_event.clear();
-        }
-      };
-
-      hstd::ExclusiveWithAtomicFlag(processing_event, inner);
-    }
+    hstd::ExclusiveWithAtomicFlag(processing_event,
+                                  [this] { DrainEnqueuedEvents(); });
   }
 
   /**
@@ -333,6 +391,12 @@ class StateChartRunner {
    */
   auto GetStateIndex() const noexcept { return chart.state.index(); }
 
+  /**
+   * Returns the transition observer, e.g. to read out a trace
+   * @return Transition observer
+   */
+  const Obs& GetObserver() const noexcept { return observer; }
+
   /**
    * Applies a visitor to the current state of the statechart and returns
    * the result
@@ -346,18 +410,56 @@ class StateChartRunner {
   }
 
  private:
-  SC                                chart;
-  std::optional<typename SC::Event> enqueued_event{};
+  /**
+   * Applies up to QueueDepth enqueued events. Must be called while holding
+   * the processing_event flag
+   */
+  void DrainEnqueuedEvents() noexcept {
+    for (std::size_t i = 0; i < QueueDepth; ++i) {
+      const auto ee = queue.Pop();
+      if (!ee.has_value()) {
+        return;
+      }
+
+      Dispatch(ee->index(), *ee);
+    }
+  }
+
+  /**
+   * Applies an event to the state chart and notifies the observer of the
+   * transition
+   * @param event_index Index of the event
+   * @param event Event to apply
+   * @return Whether the event is handled in the active state
+   */
+  bool Dispatch(std::size_t event_index,
+                const typename SC::Event& event) noexcept {
+    const auto from = chart.state.index();
+    if (const auto tr_method = JumpTable.Lookup(from, event_index);
+        tr_method != nullptr) {
+      (chart.*tr_method)(event);
+      observer.OnTransition(from, event_index, chart.state.index());
+      return true;
+    }
+
+    return false;
+  }
+
+  SC                                              chart;
+  EventQueue<Sys, typename SC::Event, QueueDepth> queue{};
 
-  typename Sys::AtomicFlag has_enqueued_event{};
   typename Sys::AtomicFlag processing_event{};
+
+  [[no_unique_address]] Obs observer{};
 };
 
 template <typename T>
 struct IsStateChartRunnerHelper : std::false_type {};
 
-template <typename S, typename T>
-struct IsStateChartRunnerHelper<StateChartRunner<S, T>> : std::true_type {};
+template <typename S, typename T, std::size_t QD, TableEncoding E,
+          TransitionObserver O>
+struct IsStateChartRunnerHelper<StateChartRunner<S, T, QD, E, O>>
+    : std::true_type {};
 
 template <typename T>
 concept IsStateChartRunner = (IsStateChartRunnerHelper<T>::value);
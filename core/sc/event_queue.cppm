@@ -0,0 +1,22 @@
+module;
+
+#include <cstddef>
+
+export module statechart:event_queue;
+
+import hstd;
+
+namespace sc {
+
+/**
+ * Lock-free bounded MPSC queue of state chart events, which producers
+ * (typically ISRs) push to and the runner pops from
+ * @tparam Sys System, providing the atomic type
+ * @tparam T Event type
+ * @tparam N Queue depth, must be a power of two
+ */
+template <typename Sys, typename T, std::size_t N>
+using EventQueue =
+    hstd::MpscQueue<T, N, typename Sys::template Atomic<std::size_t>>;
+
+}   // namespace sc
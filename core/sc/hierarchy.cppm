@@ -0,0 +1,175 @@
+module;
+
+#include <concepts>
+#include <type_traits>
+
+export module statechart:hierarchy;
+
+import hstd;
+
+namespace sc {
+
+/**
+ * Base for a state that is nested in a parent state. Transitions defined for
+ * the parent state apply to all its substates, unless a substate defines a
+ * transition for the same event itself. As a substate derives from its parent,
+ * a parent transition receives the substate as its parent state
+ * @tparam P Parent state
+ */
+export template <typename P>
+  requires std::is_class_v<P>
+struct Substate : P {
+  using Parent = P;
+};
+
+template <typename S>
+struct AncestorsHelper {
+  using Result = hstd::Types<S>;
+};
+
+template <typename S>
+  requires requires { typename S::Parent; }
+struct AncestorsHelper<S> {
+  static_assert(std::derived_from<S, typename S::Parent>,
+                "A substate must derive from its parent, use sc::Substate");
+
+  using Result =
+      hstd::ConcatTypes<hstd::Types<S>,
+                        typename AncestorsHelper<typename S::Parent>::Result>;
+};
+
+/**
+ * The given state followed by all its ancestors, innermost first
+ * @tparam S State
+ */
+template <typename S>
+using Ancestors = typename AncestorsHelper<S>::Result;
+
+template <typename T>
+struct ReverseHelper;
+
+template <>
+struct ReverseHelper<hstd::Types<>> {
+  using Result = hstd::Types<>;
+};
+
+template <typename T, typename... Ts>
+struct ReverseHelper<hstd::Types<T, Ts...>> {
+  using Result =
+      hstd::ConcatTypes<typename ReverseHelper<hstd::Types<Ts...>>::Result,
+                        hstd::Types<T>>;
+};
+
+template <typename S>
+struct StrictAncestorsHelper {
+  using Result = hstd::Types<>;
+};
+
+template <typename S>
+  requires requires { typename S::Parent; }
+struct StrictAncestorsHelper<S> {
+  using Result = Ancestors<typename S::Parent>;
+};
+
+/**
+ * All ancestors of the given state, innermost first
+ * @tparam S State
+ */
+template <typename S>
+using StrictAncestors = typename StrictAncestorsHelper<S>::Result;
+
+template <typename Dst, typename Candidates>
+struct CommonAncestorHelper;
+
+template <typename Dst, typename Cur, typename... Rest>
+struct CommonAncestorHelper<Dst, hstd::Types<Cur, Rest...>> {
+  using Result = std::conditional_t<
+      Ancestors<Dst>::template Contains<Cur>(), Cur,
+      typename CommonAncestorHelper<Dst, hstd::Types<Rest...>>::Result>;
+};
+
+template <typename Dst>
+struct CommonAncestorHelper<Dst, hstd::Types<>> {
+  using Result = void;
+};
+
+/**
+ * Least common ancestor of a transition from Src to Dst, which is neither
+ * exited nor entered by the transition. void if the states have no common
+ * ancestor. A self-transition exits and re-enters the state
+ * @tparam Src Source state
+ * @tparam Dst Destination state
+ */
+template <typename Src, typename Dst>
+using CommonAncestor =
+    typename CommonAncestorHelper<Dst, StrictAncestors<Src>>::Result;
+
+template <typename M>
+struct MemberOwner;
+
+template <typename C, typename M>
+struct MemberOwner<M C::*> {
+  using Type = C;
+};
+
+/** Whether a state declares an entry hook itself, rather than inheriting it */
+template <typename S>
+concept HasOwnEntryHook = requires {
+  &S::OnEntry;
+  requires std::is_same_v<typename MemberOwner<decltype(&S::OnEntry)>::Type,
+                          S>;
+};
+
+/** Whether a state declares an exit hook itself, rather than inheriting it */
+template <typename S>
+concept HasOwnExitHook = requires {
+  &S::OnExit;
+  requires std::is_same_v<typename MemberOwner<decltype(&S::OnExit)>::Type,
+                          S>;
+};
+
+/**
+ * Calls the exit hooks of a state and its ancestors, innermost first, up to
+ * but not including the given ancestor
+ * @tparam Until Ancestor at which to stop, void to exit all ancestors
+ * @param state State that is exited
+ */
+template <typename Until, typename S>
+void ExitStates(S& state) noexcept {
+  [&state]<typename... As>(hstd::Types<As...>) {
+    bool done = false;
+    (..., [&state, &done]<typename A>(hstd::Marker<A>) {
+      done = done || std::is_same_v<A, Until>;
+      if constexpr (HasOwnExitHook<A>) {
+        if (!done) {
+          static_cast<A&>(state).A::OnExit();
+        }
+      }
+    }(hstd::Marker<As>()));
+  }(Ancestors<S>());
+}
+
+/**
+ * Calls the entry hooks of a state and its ancestors, outermost first,
+ * starting below the given ancestor
+ * @tparam From Ancestor below which to start, void to enter all ancestors
+ * @param state State that is entered
+ */
+template <typename From, typename S>
+void EnterStates(S& state) noexcept {
+  [&state]<typename... As>(hstd::Types<As...>) {
+    bool skip = !std::is_same_v<From, void>;
+    (..., [&state, &skip]<typename A>(hstd::Marker<A>) {
+      if constexpr (HasOwnEntryHook<A>) {
+        if (!skip) {
+          static_cast<A&>(state).A::OnEntry();
+        }
+      }
+      if (std::is_same_v<A, From>) {
+        skip = false;
+      }
+    }(hstd::Marker<As>()));
+  }(typename ReverseHelper<Ancestors<S>>::Result());
+}
+
+}   // namespace sc
@@ -1,4 +1,6 @@
 export module statechart;
 
 export import :core;
-export import :callback;
\ No newline at end of file
+export import :callback;
+export import :transition_table;
+export import :trace;
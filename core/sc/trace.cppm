@@ -0,0 +1,218 @@
+module;
+
+#include <array>
+#include <charconv>
+#include <concepts>
+#include <cstddef>
+#include <cstdint>
+#include <string_view>
+
+export module statechart:trace;
+
+import hstd;
+
+namespace sc {
+
+/**
+ * Observer of the transitions of a state chart runner. The runner calls
+ * OnStart once with the initial state, and OnTransition after every applied
+ * transition, while it holds its processing flag
+ */
+export template <typename O>
+concept TransitionObserver = requires(O& o, std::size_t i) {
+  o.OnStart(i);
+  o.OnTransition(i, i, i);
+};
+
+/** Transition observer that does nothing, used when tracing is disabled */
+export struct NullObserver {
+  constexpr void OnStart(std::size_t) noexcept {}
+  constexpr void OnTransition(std::size_t, std::size_t, std::size_t) noexcept {}
+};
+
+/** Clock that provides the timestamps of a trace, e.g. a performance timer */
+export template <typename C>
+concept TraceClock = requires {
+  { C::Get() } -> std::convertible_to<uint32_t>;
+};
+
+/** Single transition in a trace */
+export struct TraceRecord {
+  uint32_t timestamp;   //!< Clock value after the transition
+  uint8_t  from;        //!< Index of the source state
+  uint8_t  event;       //!< Index of the event
+  uint8_t  to;          //!< Index of the destination state
+};
+
+/** Residency statistics of a single state */
+export struct StateStatistics {
+  uint64_t residency{0};   //!< Total clock ticks spent in the state
+  uint32_t n_entries{0};   //!< Number of times the state was entered
+};
+
+/**
+ * Transition observer that records the last N transitions in a ring buffer,
+ * and keeps track of the residency time and number of entries per state. A
+ * transition costs a clock read and a handful of stores
+ * @tparam SC State chart type
+ * @tparam Clock Clock that provides the timestamps
+ * @tparam N Number of records in the ring buffer, must be a power of two
+ */
+export template <typename SC, TraceClock Clock, std::size_t N>
+  requires(hstd::IsPowerOf2(N) && SC::NStates <= 0xFF && SC::NEvents <= 0xFF)
+class Tracer {
+ public:
+  using Chart = SC;
+
+  /** Capacity of the ring buffer */
+  static constexpr std::size_t Capacity = N;
+
+  void OnStart(std::size_t state) noexcept {
+    entered_at = static_cast<uint32_t>(Clock::Get());
+    statistics[state].n_entries++;
+  }
+
+  void OnTransition(std::size_t from, std::size_t event,
+                    std::size_t to) noexcept {
+    const auto now = static_cast<uint32_t>(Clock::Get());
+
+    records[n_transitions++ & (N - 1)] = {
+        .timestamp = now,
+        .from      = static_cast<uint8_t>(from),
+        .event     = static_cast<uint8_t>(event),
+        .to        = static_cast<uint8_t>(to),
+    };
+
+    statistics[from].residency += now - entered_at;
+    statistics[to].n_entries++;
+    entered_at = now;
+  }
+
+  /**
+   * Returns the total number of recorded transitions, including the ones
+   * that were overwritten in the ring buffer
+   * @return Number of transitions
+   */
+  [[nodiscard]] std::size_t GetTransitionCount() const noexcept {
+    return n_transitions;
+  }
+
+  /**
+   * Returns the number of records currently in the ring buffer
+   * @return Number of records
+   */
+  [[nodiscard]] std::size_t GetRecordCount() const noexcept {
+    return n_transitions < N ? n_transitions : N;
+  }
+
+  /**
+   * Returns a record from the ring buffer
+   * @param i Index of the record, 0 being the oldest available record
+   * @return Record
+   */
+  [[nodiscard]] const TraceRecord& GetRecord(std::size_t i) const noexcept {
+    return records[(n_transitions - GetRecordCount() + i) & (N - 1)];
+  }
+
+  /**
+   * Returns the statistics of a state. The residency does not include the
+   * time spent in the active state since it was last entered
+   * @param state State index
+   * @return Statistics
+   */
+  [[nodiscard]] const StateStatistics&
+  GetStateStatistics(std::size_t state) const noexcept {
+    return statistics[state];
+  }
+
+  /** Clears the ring buffer and statistics */
+  void Reset() noexcept {
+    n_transitions = 0;
+    statistics    = {};
+    entered_at    = static_cast<uint32_t>(Clock::Get());
+  }
+
+ private:
+  std::array<TraceRecord, N>               records{};
+  std::array<StateStatistics, SC::NStates> statistics{};
+  std::size_t                              n_transitions{0};
+  uint32_t                                 entered_at{0};
+};
+
+/**
+ * Returns the unqualified name of a type, derived from the name of this
+ * function as reported by the compiler
+ * @tparam T Type
+ * @return Type name
+ */
+export template <typename T>
+consteval std::string_view TypeName() noexcept {
+  std::string_view name = __PRETTY_FUNCTION__;
+
+  // GCC reports "... [with T = ns::Name; ...]", Clang "... [T = ns::Name]"
+  constexpr std::string_view Marker = "T = ";
+  name = name.substr(name.find(Marker) + Marker.size());
+  name = name.substr(0, name.find_first_of(";]"));
+
+  // Strip the qualification, but not the one of template arguments
+  const auto scope = name.substr(0, name.find('<')).rfind("::");
+  return scope == std::string_view::npos ? name : name.substr(scope + 2);
+}
+
+template <typename... Ts>
+consteval auto TypeNames(hstd::Types<Ts...>) noexcept {
+  return std::array<std::string_view, sizeof...(Ts)>{TypeName<Ts>()...};
+}
+
+/**
+ * Writes the trace of a tracer as a human readable timeline, followed by the
+ * residency statistics per state. Intended to be used on the host, after
+ * copying the tracer from the target
+ * @param tracer Tracer to export
+ * @param write Function that is called with consecutive parts of the output
+ */
+export template <typename T, std::invocable<std::string_view> W>
+void WriteTimeline(const T& tracer, W&& write) {
+  using Chart = typename T::Chart;
+
+  static constexpr auto StateNames = TypeNames(typename Chart::StateTypes{});
+  static constexpr auto EventNames = TypeNames(typename Chart::EventTypes{});
+
+  const auto write_number = [&write](uint64_t value) {
+    std::array<char, 20> buf{};
+    const auto [end, _] = std::to_chars(buf.data(), buf.data() + buf.size(),
+                                        value);
+    write(std::string_view{buf.data(), end});
+  };
+
+  const auto n_lost = tracer.GetTransitionCount() - tracer.GetRecordCount();
+  if (n_lost > 0) {
+    write("... ");
+    write_number(n_lost);
+    write(" earlier transitions\n");
+  }
+
+  for (std::size_t i = 0; i < tracer.GetRecordCount(); ++i) {
+    const auto& record = tracer.GetRecord(i);
+    write_number(record.timestamp);
+    write(": ");
+    write(StateNames[record.from]);
+    write(" --");
+    write(EventNames[record.event]);
+    write("--> ");
+    write(StateNames[record.to]);
+    write("\n");
+  }
+
+  for (std::size_t s = 0; s < StateNames.size(); ++s) {
+    const auto& stats = tracer.GetStateStatistics(s);
+    write(StateNames[s]);
+    write(": ");
+    write_number(stats.n_entries);
+    write(" entries, ");
+    write_number(stats.residency);
+    write(" ticks\n");
+  }
+}
+
+}   // namespace sc
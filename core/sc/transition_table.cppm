@@ -0,0 +1,296 @@
+module;
+
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <type_traits>
+
+export module statechart:transition_table;
+
+namespace sc {
+
+/** Encoding of the transition table of a state chart */
+export enum class TableEncoding {
+  /**
+   * Selects the smallest encoding, see SelectTableEncoding. Opt-in for charts
+   * that are tight on memory, as indexed and sparse lookups are slower than
+   * dense ones
+   */
+  Automatic,
+  /** Full NStates x NEvents table of handlers */
+  Dense,
+  /** NStates x NEvents table of indices into a table of unique handlers */
+  Indexed,
+  /** Per state list of (event, handler) pairs */
+  Sparse,
+};
+
+/**
+ * Full NStates x NEvents transition table of handlers
+ * @tparam H Handler type, typically a member function pointer
+ * @tparam NS Number of states
+ * @tparam NE Number of events
+ */
+export template <typename H, std::size_t NS, std::size_t NE>
+struct DenseTable {
+  static constexpr auto Encoding = TableEncoding::Dense;
+
+  using Cells = std::array<std::array<H, NE>, NS>;
+
+  /** Size of the table in bytes */
+  static constexpr std::size_t SizeBytes = sizeof(Cells);
+
+  consteval explicit DenseTable(const Cells& cells)
+      : cells{cells} {}
+
+  /**
+   * Looks up the handler of an event in a state
+   * @param s State index
+   * @param e Event index
+   * @return Handler, or nullptr if the event is not handled in the state
+   */
+  [[nodiscard]] constexpr H Lookup(std::size_t s,
+                                   std::size_t e) const noexcept {
+    return cells[s][e];
+  }
+
+  Cells cells;
+};
+
+/**
+ * Counts the number of non-empty cells in a transition table
+ * @param cells Transition table cells
+ * @return Number of transitions
+ */
+export template <typename H, std::size_t NS, std::size_t NE>
+consteval std::size_t
+CountTransitions(const std::array<std::array<H, NE>, NS>& cells) {
+  std::size_t n = 0;
+  for (const auto& row : cells) {
+    for (const auto& cell : row) {
+      n += cell != nullptr ? 1 : 0;
+    }
+  }
+  return n;
+}
+
+/**
+ * Counts the number of distinct handlers in a transition table
+ * @param cells Transition table cells
+ * @return Number of unique handlers
+ */
+export template <typename H, std::size_t NS, std::size_t NE>
+consteval std::size_t
+CountUniqueHandlers(const std::array<std::array<H, NE>, NS>& cells) {
+  std::array<H, NS * NE> unique{};
+  std::size_t            n = 0;
+  for (const auto& row : cells) {
+    for (const auto& cell : row) {
+      if (cell != nullptr
+          && std::find(unique.begin(), unique.begin() + n, cell)
+                 == unique.begin() + n) {
+        unique[n++] = cell;
+      }
+    }
+  }
+  return n;
+}
+
+/** Smallest unsigned type that can hold the given value */
+template <std::size_t Max>
+using IndexType = std::conditional_t<
+    Max <= std::numeric_limits<uint8_t>::max(), uint8_t,
+    std::conditional_t<Max <= std::numeric_limits<uint16_t>::max(), uint16_t,
+                       uint32_t>>;
+
+/**
+ * NStates x NEvents table of small indices into a deduplicated table of
+ * handlers. Index 0 means that the event is not handled. A StateChartRunner
+ * has a distinct handler per transition, so there the saving comes from
+ * storing an index instead of a handler per cell, not from deduplication
+ * @tparam H Handler type
+ * @tparam NS Number of states
+ * @tparam NE Number of events
+ * @tparam NH Number of unique handlers, see CountUniqueHandlers
+ */
+export template <typename H, std::size_t NS, std::size_t NE, std::size_t NH>
+struct IndexedTable {
+  static constexpr auto Encoding = TableEncoding::Indexed;
+
+  using Index = IndexType<NH>;
+
+  /** Size of the table in bytes */
+  static constexpr std::size_t SizeBytes =
+      sizeof(std::array<std::array<Index, NE>, NS>)
+      + sizeof(std::array<H, NH + 1>);
+
+  consteval explicit IndexedTable(
+      const std::array<std::array<H, NE>, NS>& cells) {
+    std::size_t n_handlers = 0;
+    for (std::size_t s = 0; s < NS; ++s) {
+      for (std::size_t e = 0; e < NE; ++e) {
+        if (cells[s][e] == nullptr) {
+          continue;
+        }
+
+        // Deduplicate handlers, index 0 is reserved for "no transition"
+        std::size_t idx = 1;
+        while (idx <= n_handlers && handlers[idx] != cells[s][e]) {
+          idx++;
+        }
+        if (idx > n_handlers) {
+          handlers[++n_handlers] = cells[s][e];
+        }
+
+        indices[s][e] = static_cast<Index>(idx);
+      }
+    }
+  }
+
+  /**
+   * Looks up the handler of an event in a state
+   * @param s State index
+   * @param e Event index
+   * @return Handler, or nullptr if the event is not handled in the state
+   */
+  [[nodiscard]] constexpr H Lookup(std::size_t s,
+                                   std::size_t e) const noexcept {
+    return handlers[indices[s][e]];
+  }
+
+  std::array<std::array<Index, NE>, NS> indices{};
+  std::array<H, NH + 1>                 handlers{};
+};
+
+/**
+ * Per state list of (event, handler) pairs, for charts where most events are
+ * not handled in most states
+ * @tparam H Handler type
+ * @tparam NS Number of states
+ * @tparam NE Number of events
+ * @tparam NT Number of transitions
+ */
+export template <typename H, std::size_t NS, std::size_t NE, std::size_t NT>
+struct SparseTable {
+  static constexpr auto Encoding = TableEncoding::Sparse;
+
+  using EventIndex = IndexType<NE>;
+  using Offset     = IndexType<NT>;
+
+  /** Size of the table in bytes */
+  static constexpr std::size_t SizeBytes =
+      sizeof(std::array<Offset, NS + 1>) + sizeof(std::array<EventIndex, NT>)
+      + sizeof(std::array<H, NT>);
+
+  consteval explicit SparseTable(
+      const std::array<std::array<H, NE>, NS>& cells) {
+    std::size_t n = 0;
+    for (std::size_t s = 0; s < NS; ++s) {
+      offsets[s] = static_cast<Offset>(n);
+      for (std::size_t e = 0; e < NE; ++e) {
+        if (cells[s][e] != nullptr) {
+          events[n]   = static_cast<EventIndex>(e);
+          handlers[n] = cells[s][e];
+          n++;
+        }
+      }
+    }
+    offsets[NS] = static_cast<Offset>(n);
+  }
+
+  /**
+   * Looks up the handler of an event in a state
+   * @param s State index
+   * @param e Event index
+   * @return Handler, or nullptr if the event is not handled in the state
+   */
+  [[nodiscard]] constexpr H Lookup(std::size_t s,
+                                   std::size_t e) const noexcept {
+    for (std::size_t i = offsets[s]; i < offsets[s + 1]; ++i) {
+      if (events[i] == e) {
+        return handlers[i];
+      }
+    }
+    return nullptr;
+  }
+
+  std::array<Offset, NS + 1> offsets{};
+  std::array<EventIndex, NT> events{};
+  std::array<H, NT>          handlers{};
+};
+
+/**
+ * Selects the smallest encoding of a transition table. The indexed encoding
+ * is used when it is smaller than the dense one, and the sparse encoding only
+ * when it is less than half the size of the best constant-time encoding, as
+ * its lookup scans the transitions of the active state. Both trade lookup
+ * latency for size, which is why the dense encoding is the default
+ * @tparam H Handler type
+ * @tparam NS Number of states
+ * @tparam NE Number of events
+ * @tparam NT Number of transitions
+ * @tparam NH Number of unique handlers
+ * @return Selected encoding
+ */
+export template <typename H, std::size_t NS, std::size_t NE, std::size_t NT,
+                 std::size_t NH = NT>
+consteval TableEncoding SelectTableEncoding() {
+  constexpr auto DenseSize   = DenseTable<H, NS, NE>::SizeBytes;
+  constexpr auto IndexedSize = IndexedTable<H, NS, NE, NH>::SizeBytes;
+  constexpr auto SparseSize  = SparseTable<H, NS, NE, NT>::SizeBytes;
+
+  constexpr auto ConstantTimeSize = std::min(DenseSize, IndexedSize);
+  if constexpr (2 * SparseSize < ConstantTimeSize) {
+    return TableEncoding::Sparse;
+  } else if constexpr (IndexedSize < DenseSize) {
+    return TableEncoding::Indexed;
+  } else {
+    return TableEncoding::Dense;
+  }
+}
+
+template <TableEncoding Enc, typename H, std::size_t NS, std::size_t NE,
+          std::size_t NT, std::size_t NH>
+struct TableForHelper;
+
+template <typename H, std::size_t NS, std::size_t NE, std::size_t NT,
+          std::size_t NH>
+struct TableForHelper<TableEncoding::Automatic, H, NS, NE, NT, NH>
+    : TableForHelper<SelectTableEncoding<H, NS, NE, NT, NH>(), H, NS, NE, NT,
+                     NH> {};
+
+template <typename H, std::size_t NS, std::size_t NE, std::size_t NT,
+          std::size_t NH>
+struct TableForHelper<TableEncoding::Dense, H, NS, NE, NT, NH> {
+  using Result = DenseTable<H, NS, NE>;
+};
+
+template <typename H, std::size_t NS, std::size_t NE, std::size_t NT,
+          std::size_t NH>
+struct TableForHelper<TableEncoding::Indexed, H, NS, NE, NT, NH> {
+  using Result = IndexedTable<H, NS, NE, NH>;
+};
+
+template <typename H, std::size_t NS, std::size_t NE, std::size_t NT,
+          std::size_t NH>
+struct TableForHelper<TableEncoding::Sparse, H, NS, NE, NT, NH> {
+  using Result = SparseTable<H, NS, NE, NT>;
+};
+
+/**
+ * Transition table type for the given encoding
+ * @tparam Enc Table encoding
+ * @tparam H Handler type
+ * @tparam NS Number of states
+ * @tparam NE Number of events
+ * @tparam NT Number of transitions
+ * @tparam NH Number of unique handlers
+ */
+export template <TableEncoding Enc, typename H, std::size_t NS, std::size_t NE,
+                 std::size_t NT, std::size_t NH = NT>
+using TransitionTableFor =
+    typename TableForHelper<Enc, H, NS, NE, NT, NH>::Result;
+
+}   // namespace sc
@@ -1,13 +1,19 @@
 module;
 
+#include <cstdint>
 #include <functional>
 #include <optional>
+#include <span>
 #include <string>
+#include <vector>
 
 export module hal.sil:gpio;
 
 import hal.abstract;
 
+import :scheduler;
+import :vcd;
+
 namespace sil {
 
 /**
@@ -26,6 +32,137 @@ export enum class Edge {
   Falling = 1,   //!< Falling edge
 };
 
+/**
+ * Edge of a GPIO, with the time at which it occurred
+ */
+export struct EdgeRecord {
+  TimePointUs timestamp;   //!< Time of the edge
+  Edge        edge;        //!< Edge type
+};
+
+/**
+ * Preallocated ring buffer of the most recent edges of a GPIO. When the ring
+ * is full, the oldest edges are overwritten
+ */
+export class EdgeCapture {
+ public:
+  /**
+   * Enables capturing, discarding all captured edges
+   * @param capacity Capacity of the ring in edges, 0 disables capturing
+   */
+  void Enable(std::size_t capacity);
+
+  /**
+   * Captures an edge
+   * @param timestamp Time of the edge
+   * @param edge Edge type
+   */
+  void Write(TimePointUs timestamp, Edge edge) noexcept {
+    if (records.empty()) {
+      return;
+    }
+
+    if (GetCount() == records.size()) {
+      read_pos++;
+      n_dropped++;
+    }
+
+    records[write_pos++ % records.size()] = {
+        .timestamp = timestamp,
+        .edge      = edge,
+    };
+  }
+
+  /**
+   * Returns the number of edges in the ring
+   * @return Number of edges
+   */
+  [[nodiscard]] std::size_t GetCount() const noexcept {
+    return write_pos - read_pos;
+  }
+
+  /**
+   * Returns an edge from the ring
+   * @param i Index of the edge, 0 being the oldest edge in the ring
+   * @return Edge
+   */
+  [[nodiscard]] const EdgeRecord& operator[](std::size_t i) const noexcept {
+    return records[(read_pos + i) % records.size()];
+  }
+
+  /**
+   * Moves the oldest edges out of the ring
+   * @param timestamps Buffer for the timestamps in microseconds
+   * @param edges Buffer for the edge types, of the same size
+   * @return Number of edges read
+   */
+  std::size_t Read(std::span<uint64_t> timestamps, std::span<uint8_t> edges);
+
+  /**
+   * Returns the number of edges that were overwritten before they were read
+   * @return Number of dropped edges
+   */
+  [[nodiscard]] std::size_t GetDropCount() const noexcept { return n_dropped; }
+
+ private:
+  std::vector<EdgeRecord> records{};
+  std::size_t             read_pos{0};    //!< Monotonic read position
+  std::size_t             write_pos{0};   //!< Monotonic write position
+  std::size_t             n_dropped{0};
+};
+
+/**
+ * Options of a waveform analysis
+ */
+export struct WaveformOptions {
+  /** Pulses shorter than this are glitches, and removed before the analysis */
+  DurationUs glitch_threshold{0};
+  /** Width of a bin of the period jitter histogram */
+  DurationUs jitter_bin_width{1};
+};
+
+/**
+ * Properties of a square wave
+ */
+export struct WaveformAnalysis {
+  std::size_t n_periods{0};          //!< Number of full periods
+  std::size_t n_glitches{0};         //!< Number of removed glitches
+  double      mean_frequency{0};     //!< Mean frequency in Hz
+  double      mean_duty_cycle{0};    //!< Mean duty cycle
+  DurationUs  min_period{0};         //!< Shortest period
+  DurationUs  max_period{0};         //!< Longest period
+  double      min_duty_cycle{0};     //!< Lowest duty cycle
+  double      max_duty_cycle{0};     //!< Highest duty cycle
+  double      period_stddev_us{0};   //!< Standard deviation of the period
+};
+
+/**
+ * Analyzes the square wave of a sequence of edges, measuring the periods from
+ * rising edge to rising edge
+ * @param edges Edges, oldest first
+ * @param opts Analysis options
+ * @param jitter_histogram Histogram of the deviation of the periods from the
+ * mean period. The center bin starts at the mean period, deviations outside of
+ * the histogram are counted in the outermost bins. May be empty
+ * @return Analysis result
+ */
+export WaveformAnalysis AnalyzeWaveform(std::span<const EdgeRecord> edges,
+                                        const WaveformOptions&      opts,
+                                        std::span<uint64_t> jitter_histogram);
+
+/**
+ * Analyzes the square wave of the edges that are in a capture ring. The edges
+ * are not consumed, but edges that were read from the ring before are not part
+ * of the analysis
+ * @param capture Captured edges
+ * @param opts Analysis options
+ * @param jitter_histogram Histogram of the period deviation, see above
+ * @return Analysis result
+ */
+export WaveformAnalysis
+AnalyzeWaveform(const EdgeCapture& capture, const WaveformOptions& opts,
+                std::span<uint64_t> jitter_histogram);
+
 /**
  * General purpose input-output, can serve as a GPI, GPO or GPIO
  */
@@ -33,13 +170,15 @@ export class Gpio {
  public:
   /**
    * Constructor
+   * @param sched Scheduler that provides the timestamps of captured edges
    * @param name GPIO name
    * @param direction Direction of the GPIO
    * @param initial_state Initial state of the GPIO
    */
-  Gpio(std::string name, const GpioDirection direction,
+  Gpio(const Scheduler& sched, std::string name, const GpioDirection direction,
        const bool initial_state = false) noexcept
-      : dir{direction}
+      : sched{sched}
+      , dir{direction}
       , state{initial_state}
       , name{std::move(name)} {}
 
@@ -54,8 +193,8 @@ export class Gpio {
    * @param value Pin value to write
    */
   void Write(bool value) noexcept {
-    if (value != state && edge_callback.has_value()) {
-      (*edge_callback)(value ? Edge::Rising : Edge::Falling);
+    if (value != state) {
+      OnEdge(value ? Edge::Rising : Edge::Falling);
     }
     state = value;
   }
@@ -65,9 +204,7 @@ export class Gpio {
    */
   void Toggle() noexcept {
     const auto new_state = !state;
-    if (edge_callback.has_value()) {
-      (*edge_callback)(new_state ? Edge::Rising : Edge::Falling);
-    }
+    OnEdge(new_state ? Edge::Rising : Edge::Falling);
     state = new_state;
   }
 
@@ -96,12 +233,48 @@ export class Gpio {
    */
   [[nodiscard]] const std::string& GetName() const& noexcept { return name; }
 
+  /**
+   * Returns the capture ring of the edges of the GPIO
+   * @return Edge capture ring
+   */
+  EdgeCapture& GetEdgeCapture() & noexcept { return edge_capture; }
+
+  /**
+   * Starts recording the level of the GPIO, by declaring it in the current
+   * scope of a VCD writer
+   * @param writer VCD writer, which must outlive the recording
+   */
+  void AttachVcd(VcdWriter& writer) {
+    vcd_var = writer.AddVar(name, 1, state);
+    vcd     = &writer;
+  }
+
+  /**
+   * Stops recording the level of the GPIO
+   */
+  void DetachVcd() noexcept { vcd = nullptr; }
+
  private:
-  GpioDirection dir;
-  bool          state;
-  std::string   name;
+  void OnEdge(Edge edge) noexcept {
+    edge_capture.Write(sched.Now(), edge);
+    if (vcd != nullptr) {
+      vcd->Change(vcd_var, edge == Edge::Rising);
+    }
+    if (edge_callback.has_value()) {
+      (*edge_callback)(edge);
+    }
+  }
+
+  const Scheduler& sched;
+  GpioDirection    dir;
+  bool             state;
+  std::string      name;
 
   std::optional<std::function<void(Edge)>> edge_callback{std::nullopt};
+  EdgeCapture                              edge_capture{};
+
+  VcdWriter*       vcd{nullptr};   //!< Recording VCD writer, if any
+  VcdWriter::VarId vcd_var{0};     //!< Level variable in the VCD
 };
 
 static_assert(hal::Gpi<Gpio>);
@@ -0,0 +1,128 @@
+module;
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <vector>
+
+module hal.sil;
+
+namespace sil {
+
+void EdgeCapture::Enable(std::size_t capacity) {
+  records.assign(capacity, EdgeRecord{});
+  read_pos  = 0;
+  write_pos = 0;
+  n_dropped = 0;
+}
+
+std::size_t EdgeCapture::Read(std::span<uint64_t> timestamps,
+                              std::span<uint8_t>  edges) {
+  const auto n = std::min({GetCount(), timestamps.size(), edges.size()});
+
+  for (std::size_t i = 0; i < n; ++i) {
+    const auto& record = (*this)[i];
+    timestamps[i]      = record.timestamp.count();
+    edges[i]           = static_cast<uint8_t>(record.edge);
+  }
+
+  read_pos += n;
+  return n;
+}
+
+WaveformAnalysis AnalyzeWaveform(const EdgeCapture&     capture,
+                                 const WaveformOptions& opts,
+                                 std::span<uint64_t>    jitter_histogram) {
+  std::vector<EdgeRecord> edges{};
+  edges.reserve(capture.GetCount());
+  for (std::size_t i = 0; i < capture.GetCount(); ++i) {
+    edges.push_back(capture[i]);
+  }
+
+  return AnalyzeWaveform(edges, opts, jitter_histogram);
+}
+
+WaveformAnalysis AnalyzeWaveform(std::span<const EdgeRecord> captured,
+                                 const WaveformOptions&      opts,
+                                 std::span<uint64_t>         jitter_histogram) {
+  WaveformAnalysis result{};
+
+  // Remove pulses that are shorter than the glitch threshold, by dropping
+  // both of their edges
+  std::vector<EdgeRecord> edges{};
+  edges.reserve(captured.size());
+  for (const auto& record : captured) {
+    if (!edges.empty()
+        && record.timestamp - edges.back().timestamp < opts.glitch_threshold) {
+      edges.pop_back();
+      result.n_glitches++;
+    } else {
+      edges.push_back(record);
+    }
+  }
+
+  // Periods from rising edge to rising edge, with the high time in between
+  std::vector<DurationUs> periods{};
+  double                  sum_duty_cycle = 0.0;
+  result.min_duty_cycle                  = 1.0;
+
+  for (std::size_t i = 0; i + 2 < edges.size(); ++i) {
+    if (edges[i].edge != Edge::Rising || edges[i + 1].edge != Edge::Falling
+        || edges[i + 2].edge != Edge::Rising) {
+      continue;
+    }
+
+    const auto period = edges[i + 2].timestamp - edges[i].timestamp;
+    const auto high   = edges[i + 1].timestamp - edges[i].timestamp;
+    const auto duty_cycle =
+        static_cast<double>(high.count()) / static_cast<double>(period.count());
+
+    periods.push_back(period);
+    sum_duty_cycle += duty_cycle;
+    result.min_duty_cycle = std::min(result.min_duty_cycle, duty_cycle);
+    result.max_duty_cycle = std::max(result.max_duty_cycle, duty_cycle);
+  }
+
+  std::ranges::fill(jitter_histogram, 0);
+
+  result.n_periods = periods.size();
+  if (periods.empty()) {
+    result.min_duty_cycle = 0.0;
+    return result;
+  }
+
+  const auto [min, max] = std::ranges::minmax(periods);
+  result.min_period     = min;
+  result.max_period     = max;
+
+  double sum_us = 0.0;
+  for (const auto period : periods) {
+    sum_us += static_cast<double>(period.count());
+  }
+  const auto n       = static_cast<double>(periods.size());
+  const auto mean_us = sum_us / n;
+
+  result.mean_frequency  = 1'000'000.0 / mean_us;
+  result.mean_duty_cycle = sum_duty_cycle / n;
+
+  double sum_sq_dev = 0.0;
+  for (const auto period : periods) {
+    const auto dev_us = static_cast<double>(period.count()) - mean_us;
+    sum_sq_dev += dev_us * dev_us;
+
+    if (!jitter_histogram.empty() && opts.jitter_bin_width.count() > 0) {
+      const auto n_bins = static_cast<double>(jitter_histogram.size());
+      const auto width  = static_cast<double>(opts.jitter_bin_width.count());
+      const auto bin = std::floor(dev_us / width) + std::floor(n_bins / 2.0);
+      jitter_histogram[static_cast<std::size_t>(
+          std::clamp(bin, 0.0, n_bins - 1.0))]++;
+    }
+  }
+  result.period_stddev_us = std::sqrt(sum_sq_dev / n);
+
+  return result;
+}
+
+}   // namespace sil
@@ -3,15 +3,23 @@ module;
 #include <algorithm>
 #include <atomic>
 #include <chrono>
+#include <cstddef>
 #include <deque>
+#include <exception>
 #include <functional>
 #include <iostream>
 #include <latch>
+#include <limits>
 #include <map>
+#include <memory>
 #include <mutex>
+#include <optional>
+#include <string>
+#include <string_view>
 #include <thread>
 #include <tuple>
 #include <variant>
+#include <vector>
 
 export module hal.sil:scheduler;
 
@@ -30,7 +38,15 @@ export enum class SchedulerState {
   Stopping,
 };
 
-enum class RunType {
+/**
+ * Execution backend for simulated tasks
+ */
+export enum class ExecutionBackend {
+  Threads,   //!< Every task runs on its own host thread
+  Fibers,    //!< All tasks run as fibers on the thread running the scheduler
+};
+
+export enum class RunType {
   Synchronous,
   Asynchronous,
 };
@@ -42,12 +58,14 @@ inline constexpr unsigned LowestPriorityLevel        = 10'000;
 
 export class Scheduler;
 
-using ItemPrio = std::tuple<unsigned, unsigned>;
+export using ItemPrio = std::tuple<unsigned, unsigned>;
 
 inline constexpr ItemPrio HighestPrio = {HighestPriorityLevel, 0};
 inline constexpr ItemPrio LowestPrio  = {LowestPriorityLevel, 0};
 
-class SchedulerItem {
+struct PriorityBracket;
+
+export class SchedulerItem {
  public:
   SchedulerItem()          = default;
   virtual ~SchedulerItem() = default;
@@ -77,18 +95,122 @@ class SchedulerItem {
    */
   [[nodiscard]] virtual std::optional<TimePointUs> GetTimeout() const = 0;
 
+  /**
+   * Returns whether the item waits on a synchronization primitive, and can
+   * therefore become pending before its timeout
+   * @return Whether the item waits on a synchronization primitive
+   */
+  [[nodiscard]] virtual bool IsWaitingOnSyncPrimitive() const = 0;
+
   /**
    * Runs the scheduler item until it enters a blocking state
    */
   virtual RunType Run() = 0;
+
+ private:
+  friend class Scheduler;
+  friend class TimeoutQueue;
+
+  static constexpr auto NotQueued = std::numeric_limits<std::size_t>::max();
+
+  /**
+   * Position of the item in the scheduler queues
+   */
+  struct QueueState {
+    PriorityBracket* bracket{nullptr};      //!< Bracket, set at startup
+    TimePointUs      timeout{};             //!< Timeout in the timeout queue
+    uint64_t         seq{0};                //!< Order among equal timeouts
+    std::size_t      heap_idx{NotQueued};   //!< Index in the timeout queue
+    std::size_t      sync_idx{NotQueued};   //!< Index in the sync list
+    bool             ready{false};          //!< Whether in the ready list
+  };
+
+  QueueState queue_state{};   //!< Position in the scheduler queues
 };
 
-class ThreadItem final : public SchedulerItem {
+/**
+ * Indexed binary min-heap of item timeouts. Items with equal timeouts are
+ * ordered by the time they were queued
+ */
+export class TimeoutQueue {
+ public:
+  /**
+   * Queues an item, or moves it if it is already queued
+   * @param item Item to queue
+   * @param timeout Timeout of the item
+   */
+  void Update(SchedulerItem& item, TimePointUs timeout);
+
+  /**
+   * Removes an item from the queue, if it is queued
+   * @param item Item to remove
+   */
+  void Remove(SchedulerItem& item);
+
+  /**
+   * Returns the item with the earliest timeout
+   * @return Item with the earliest timeout, or nullptr if the queue is empty
+   */
+  [[nodiscard]] SchedulerItem* Top() const noexcept;
+
+ private:
+  static bool Less(const SchedulerItem* a, const SchedulerItem* b) noexcept;
+
+  void Place(std::size_t idx, SchedulerItem* item) noexcept;
+  void SiftUp(std::size_t idx) noexcept;
+  void SiftDown(std::size_t idx) noexcept;
+
+  std::vector<SchedulerItem*> heap{};        //!< Heap of queued items
+  uint64_t                    next_seq{0};   //!< Sequence number of next item
+};
+
+/**
+ * Items of a single priority that are ready to run or may become ready
+ */
+struct PriorityBracket {
+  ItemPrio prio;   //!< Priority of the items in the bracket
+
+  //! Items whose timeout expired, in order of expiry
+  std::deque<SchedulerItem*> ready{};
+  //! Items waiting on a synchronization primitive, in order of blocking
+  std::vector<SchedulerItem*> sync_waiting{};
+};
+
+/**
+ * Execution statistics of a simulated task, in simulated time
+ */
+export struct TaskStats {
+  DurationUs  cpu_time{0};        //!< CPU time charged to the task
+  DurationUs  blocked_time{0};    //!< Time from blocking until running again
+  std::size_t n_activations{0};   //!< Number of times the task was resumed
+  std::size_t n_preemptions{0};   //!< Number of times the task was preempted
+};
+
+/**
+ * Scheduler item that runs a simulated task. Implements the blocking logic
+ * shared by all execution backends
+ */
+class TaskItem : public SchedulerItem {
+  /**
+   * Blocking condition due to a synchronization primitive. The unblock
+   * predicate lives on the stack of the blocked task, so it is referenced
+   * instead of being copied into a type-erased function
+   */
   struct SyncPrimitiveBlock {
-    void*                 ptr;
-    std::function<bool()> check_unblock;
+    void*       ptr;                       //!< Synchronization primitive
+    const void* predicate;                 //!< Unblock predicate
+    bool (*check_unblock)(const void*);    //!< Invokes the unblock predicate
+
+    /**
+     * Returns whether the task can unblock
+     * @return Whether the unblock predicate is fulfilled
+     */
+    [[nodiscard]] bool CheckUnblock() const {
+      return check_unblock(predicate);
+    }
   };
 
+ protected:
   enum class UnblockReason {
     Timeout,
     SyncPrimitive,
@@ -97,38 +219,39 @@ class ThreadItem final : public SchedulerItem {
  public:
   /**
    * Constructor
-   * @param id Thread ID
-   * @param prio Thread priority
-   * @param mtx System mutex
+   * @param name Task name
+   * @param prio Task priority
+   * @param index Index of the task in the order of creation
    */
-  ThreadItem(std::thread::id id, unsigned prio, std::mutex& mtx);
-
-  ~ThreadItem() final = default;
+  TaskItem(std::string name, unsigned prio, std::size_t index);
 
-  ItemPrio GetPriority() const final;
-
-  bool                       IsRunning() const final;
-  bool                       IsPending(TimePointUs time) const final;
-  std::optional<TimePointUs> GetTimeout() const final;
-
-  RunType Run() final;
+  /**
+   * Returns the name of the task
+   * @return Task name
+   */
+  [[nodiscard]] const std::string& GetName() const noexcept { return name; }
 
   /**
-   * Initializes the thread. This sets its timeout to the epoch and acquires
-   * an initial lock on the system mutex
-   * @param sched Scheduler reference
-   * @param startup_latch Latch for keeping track of initialization
+   * Returns the index of the task in the order of creation
+   * @return Task index
    */
-  void Initialize(Scheduler& sched, std::latch& startup_latch);
+  [[nodiscard]] std::size_t GetIndex() const noexcept { return index; }
 
   /**
-   * Marks the thread as stopped and releases the lock on the system mutex for
-   * good
+   * Returns whether the task is busy with CPU time that was charged to it
+   * @return Whether the task is busy
    */
-  void MarkStopped();
+  [[nodiscard]] bool IsBusy() const noexcept { return busy; }
+
+  ItemPrio GetPriority() const final;
+
+  bool                       IsRunning() const final;
+  bool                       IsPending(TimePointUs time) const final;
+  std::optional<TimePointUs> GetTimeout() const final;
+  bool                       IsWaitingOnSyncPrimitive() const final;
 
   /**
-   * Blocks the thread until the given time point
+   * Blocks the task until the given time point
    * @param time Time point until which to block
    * @param sched Scheduler reference
    */
@@ -141,13 +264,18 @@ class ThreadItem final : public SchedulerItem {
   std::variant<TimeoutExpired, typename std::invoke_result_t<T>::value_type>
   BlockOnSyncPrimitive(void* primitive, const T& check_unblock,
                        hstd::Duration auto timeout, Scheduler& sched) {
+    ChargeHostTime(sched);
+
     // Set timeout and sync primitive block
     const auto time_us   = std::chrono::duration_cast<DurationUs>(timeout);
     block_timeout_at     = time_us;
-    sync_primitive_block = {.ptr           = primitive,
-                            .check_unblock = [check_unblock]() {
-                              return check_unblock().has_value();
-                            }};
+    sync_primitive_block = {
+        .ptr           = primitive,
+        .predicate     = &check_unblock,
+        .check_unblock = [](const void* predicate) {
+          return (*static_cast<const T*>(predicate))().has_value();
+        },
+    };
 
     // Wait until woken
     const auto reason = BlockUntilWoken(sched);
@@ -162,44 +290,206 @@ class ThreadItem final : public SchedulerItem {
   }
 
   /**
-   * Yields the thread
+   * Yields the task
    * @param sched Scheduler reference
    */
   void Yield(Scheduler& sched);
 
- private:
-  void          BlockUntilUs(DurationUs time, Scheduler& sched);
+  /**
+   * Charges CPU time to the task, after the host CPU time that it ran for
+   * since it was resumed, if the scheduler has a CPU scale
+   * @param cost CPU time
+   * @param sched Scheduler reference
+   */
+  void ChargeCpuTime(DurationUs cost, Scheduler& sched);
+
+  /**
+   * Keeps the task busy for an amount of CPU time. The task does not run in
+   * the meantime, but lower-priority tasks do not run either
+   * @param cost CPU time
+   * @param sched Scheduler reference
+   */
+  void BlockBusy(DurationUs cost, Scheduler& sched);
+
+  /**
+   * Records that the task was preempted by a higher-priority task. If the
+   * task is busy, it finishes later by the CPU time that the other task takes
+   * @param delay CPU time that the other task takes
+   */
+  void MarkPreempted(DurationUs delay = DurationUs{0}) noexcept;
+
+  /**
+   * Returns the execution statistics of the task
+   * @return Execution statistics
+   */
+  [[nodiscard]] const TaskStats& GetStats() const noexcept { return stats; }
+
+ protected:
+  /**
+   * Blocks until the scheduler wakes the task and returns why it was woken
+   * @param sched Scheduler reference
+   * @return Unblock reason
+   */
   UnblockReason BlockUntilWoken(Scheduler& sched);
 
-  std::thread::id   id;              //!< Thread ID
-  unsigned          prio;            //!< Thread priority
-  bool              running{true};   //!< Whether the thread is running
-  std::atomic<bool> wakeup_requested{
-      false};   //!< Whether a wakeup of the thread is requested
+  /**
+   * Hands control back to the scheduler, and returns once the scheduler runs
+   * the task again
+   * @param sched Scheduler reference
+   */
+  virtual void Suspend(Scheduler& sched) = 0;
 
-  std::condition_variable      cv;   //!< Thread condition variable
-  std::unique_lock<std::mutex> lk;   //!< Thread lock on system mutex
+  /**
+   * Records the first run of a task that does not start by resuming from a
+   * block, and starts measuring the host CPU time that it runs for
+   */
+  void MarkStarted() noexcept;
+
+  std::string name;            //!< Task name
+  unsigned    prio;            //!< Task priority
+  std::size_t index;           //!< Index in the order of creation
+  bool        running{true};   //!< Whether the task is running
 
   std::optional<TimePointUs>
       block_timeout_at{};   //!< Timeout expiry time point
+
+ private:
+  void BlockUntilUs(DurationUs time, Scheduler& sched);
+
+  /**
+   * Charges the host CPU time that the task ran for since it was resumed,
+   * scaled to the simulated target, if the scheduler has a CPU scale
+   * @param sched Scheduler reference
+   */
+  void ChargeHostTime(Scheduler& sched);
+
+  TaskStats stats{};       //!< Execution statistics
+  bool      busy{false};   //!< Whether the task is blocked for CPU time
+
+  //! Host CPU time at which the task was resumed, if measured
+  std::optional<std::chrono::nanoseconds> host_resumed_at{};
+  //! Scaled host CPU time below the simulated resolution, yet to be charged
+  double uncharged_us{0.0};
+
   std::optional<SyncPrimitiveBlock>
       sync_primitive_block{};   //!< Blocking condition due to synchronization
   //!< primitive
 };
 
+/**
+ * Task that runs on its own host thread. Control is handed over between the
+ * scheduler and the thread with a condition variable
+ */
+class ThreadItem final : public TaskItem {
+ public:
+  /**
+   * Constructor
+   * @param id Thread ID
+   * @param name Task name
+   * @param prio Thread priority
+   * @param index Index of the task in the order of creation
+   * @param mtx System mutex
+   */
+  ThreadItem(std::thread::id id, std::string name, unsigned prio,
+             std::size_t index, std::mutex& mtx);
+
+  ~ThreadItem() final = default;
+
+  RunType Run() final;
+
+  /**
+   * Initializes the thread. This sets its timeout to the epoch and acquires
+   * an initial lock on the system mutex
+   * @param sched Scheduler reference
+   * @param startup_latch Latch for keeping track of initialization
+   */
+  void Initialize(Scheduler& sched, std::latch& startup_latch);
+
+  /**
+   * Marks the thread as stopped and releases the lock on the system mutex for
+   * good
+   */
+  void MarkStopped();
+
+ private:
+  void Suspend(Scheduler& sched) final;
+
+  std::thread::id   id;   //!< Thread ID
+  std::atomic<bool> wakeup_requested{
+      false};   //!< Whether a wakeup of the thread is requested
+
+  std::condition_variable      cv;   //!< Thread condition variable
+  std::unique_lock<std::mutex> lk;   //!< Thread lock on system mutex
+};
+
+/**
+ * Task that runs as a fiber with its own stack on the thread that runs the
+ * scheduler. Control is handed over by switching stacks in user space, so a
+ * context switch does not involve the kernel scheduler
+ */
+class FiberItem final : public TaskItem {
+  struct Context;
+
+ public:
+  /**
+   * Constructor. The fiber starts running at the simulated epoch
+   * @param name Task name
+   * @param prio Task priority
+   * @param index Index of the task in the order of creation
+   * @param fn Task function
+   * @param stack_size Size of the fiber stack in bytes
+   */
+  FiberItem(std::string name, unsigned prio, std::size_t index,
+            std::function<void()> fn, std::size_t stack_size);
+
+  ~FiberItem() final;
+
+  RunType Run() final;
+
+  /**
+   * Returns the fiber that is running on the calling host thread
+   * @return Running fiber, or nullptr if no fiber is running
+   */
+  [[nodiscard]] static FiberItem* Current() noexcept;
+
+ private:
+  void Suspend(Scheduler& sched) final;
+
+  /**
+   * Entry point of the fiber. Runs the task function, and hands control back
+   * to the scheduler for good when it returns
+   */
+  void Main() noexcept;
+
+  static void Trampoline(unsigned hi, unsigned lo) noexcept;
+
+  std::function<void()>    fn;                   //!< Task function
+  std::unique_ptr<Context> ctx;                  //!< Fiber and caller context
+  std::exception_ptr       exception{nullptr};   //!< Exception thrown by task
+};
+
 class ExternalEventItem final : public SchedulerItem {
  public:
-  explicit ExternalEventItem(unsigned prio = 0);
+  /**
+   * Constructor
+   * @param sched Scheduler that runs the event
+   * @param prio Event priority
+   */
+  explicit ExternalEventItem(Scheduler& sched, unsigned prio = 0);
 
   void RegisterPendingAction(TimePointUs           timestamp,
                              std::function<void()> callback);
 
+  /** Discards the pending action, if any */
+  void ClearPendingAction();
+
   [[nodiscard]] bool HasPendingAction() const;
 
   [[nodiscard]] ItemPrio GetPriority() const final;
   [[nodiscard]] bool     IsRunning() const final;
   [[nodiscard]] bool     IsPending(TimePointUs time) const final;
   [[nodiscard]] std::optional<TimePointUs> GetTimeout() const final;
+  [[nodiscard]] bool IsWaitingOnSyncPrimitive() const final;
 
   RunType Run() final;
 
@@ -209,6 +499,7 @@ class ExternalEventItem final : public SchedulerItem {
     TimePointUs           timestamp;
   };
 
+  Scheduler*            sched;              //!< Scheduler running the event
   std::optional<Action> pending_action{};   //!< Pending external action
   unsigned              priority{0};        //!< External action priority
 };
@@ -230,8 +521,32 @@ export struct GetBlockTimeoutOpts {
  */
 export class Scheduler {
  public:
+  /** Default stack size of a fiber */
+  static constexpr std::size_t DefaultFiberStackSize = 512 * 1024;
+
   [[nodiscard]] SchedulerState GetState() const noexcept;
 
+  /**
+   * Selects the execution backend of tasks that are created afterwards. Must
+   * be called before any task is created
+   * @param new_backend Execution backend
+   */
+  void SetExecutionBackend(ExecutionBackend new_backend);
+
+  /**
+   * Returns the execution backend of new tasks
+   * @return Execution backend
+   */
+  [[nodiscard]] ExecutionBackend GetExecutionBackend() const noexcept;
+
+  /**
+   * Returns whether the complete simulation state lives in the memory of the
+   * process, i.e. no task runs on a thread of its own. A snapshot of such a
+   * scheduler, e.g. a forked process, can continue the simulation
+   * @return Whether the scheduler can be snapshotted
+   */
+  [[nodiscard]] bool IsSnapshotSafe() const noexcept;
+
   void Start();
 
   /**
@@ -262,6 +577,44 @@ export class Scheduler {
    */
   void Shutdown(std::size_t max_wakeups = 100);
 
+  /**
+   * Charges CPU time to the current task. The task continues once it received
+   * the CPU time, which takes longer if higher-priority tasks preempt it.
+   * Lower-priority tasks do not run in the meantime
+   * @param cost CPU time that the code of the task takes on the target
+   */
+  void ChargeCurrentTask(hstd::Duration auto cost) {
+    GetCurrentThread().ChargeCpuTime(
+        std::chrono::duration_cast<DurationUs>(cost), *this);
+  }
+
+  /**
+   * Sets the scale of the calibrated cost model, which charges the host CPU
+   * time that tasks run for to them, scaled to the simulated target
+   * @param scale Simulated time per host CPU time, e.g. 4.0 if the target
+   * runs the code four times slower than the host. 0 disables the model
+   */
+  void SetCpuScale(double scale);
+
+  /**
+   * Returns the scale of the calibrated cost model
+   * @return Simulated time per host CPU time, 0 if the model is disabled
+   */
+  [[nodiscard]] double GetCpuScale() const noexcept { return cpu_scale; }
+
+  /**
+   * Sets the stream that a report of the execution statistics of all tasks
+   * is written to at shutdown
+   * @param os Report stream, or nullptr to disable the report
+   */
+  void SetCpuReportStream(std::ostream* os) noexcept { cpu_report = os; }
+
+  /**
+   * Formats a report of the execution statistics of all tasks
+   * @return Report
+   */
+  [[nodiscard]] std::string FormatCpuReport() const;
+
   /**
    * Blocks the current thread for the given amount of time
    * @param time Time to block the current thread for
@@ -327,8 +680,23 @@ export class Scheduler {
 
   /**
    * Initializes the current thread. Must be called at the simulated epoch.
+   * @param name Task name
+   * @param prio Task priority
    */
-  void InitializeThread(unsigned prio);
+  void InitializeThread(std::string_view name, unsigned prio);
+
+  /**
+   * Creates a task that runs as a fiber. Must be called at the simulated
+   * epoch, before the scheduler is started
+   * @param name Task name
+   * @param prio Task priority
+   * @param fn Task function
+   * @param stack_size Size of the fiber stack in bytes, rounded up to whole
+   * pages. An overflow of the stack faults on a guard page below it
+   */
+  void SpawnFiber(std::string_view name, unsigned prio,
+                  std::function<void()> fn,
+                  std::size_t           stack_size = DefaultFiberStackSize);
 
   /**
    * Announces that the current thread is done and can be joined
@@ -346,30 +714,109 @@ export class Scheduler {
    */
   TimePointUs Now() const noexcept { return now.load(); }
 
+  /**
+   * Returns the number of tasks that were created
+   * @return Number of tasks
+   */
+  [[nodiscard]] std::size_t GetTaskCount() const noexcept;
+
+  /**
+   * Returns the name of a task
+   * @param index Task index, in the order of creation
+   * @return Task name
+   */
+  [[nodiscard]] const std::string& GetTaskName(std::size_t index) const;
+
+  /**
+   * Returns the execution statistics of a task
+   * @param index Task index, in the order of creation
+   * @return Execution statistics
+   */
+  [[nodiscard]] const TaskStats& GetTaskStats(std::size_t index) const;
+
+  /**
+   * Sets a callback that is invoked with the index of a task whenever the
+   * task starts running, and with false whenever it blocks again. A task that
+   * is busy with charged CPU time runs until the time is used up, except while
+   * a busy higher-priority task preempts it
+   * @param cb Callback to set
+   */
+  void SetTaskRunCallback(std::function<void(std::size_t, bool)> cb);
+
+  /**
+   * Clears the task run callback
+   */
+  void ClearTaskRunCallback();
+
  private:
-  struct PriorityBracket {
-    ItemPrio                   prio;
-    std::size_t                rr_idx{0};
-    std::deque<SchedulerItem*> items;
-  };
+  friend class ExternalEventItem;
+  friend class TaskItem;
 
   static constexpr auto Epoch = TimePointUs{};
 
   void InitializePriorityBrackets();
 
   /**
-   * Returns the ThreadState associated with the thread in which the function
-   * is called
-   * @return Current thread state
+   * Updates the position of an item in the timeout queue and the sync lists.
+   * Must be called whenever the timeout or blocking state of an item changes
+   * outside of its Run method
+   * @param item Item to update
    */
-  ThreadItem& GetCurrentThread() &;
+  void UpdateQueues(SchedulerItem& item);
 
   /**
-   * Returns the ThreadState associated with the thread in which the function
-   * is called
-   * @return Current thread state
+   * Moves all items whose timeout expired from the timeout queue to the ready
+   * list of their priority bracket
    */
-  const ThreadItem& GetCurrentThread() const&;
+  void PromoteDueItems();
+
+  /**
+   * Takes the next item to run from a priority bracket: the item whose
+   * timeout expired first, otherwise the first item that is unblocked by a
+   * synchronization primitive
+   * @param bracket Priority bracket
+   * @return Item to run, or nullptr if no item of the bracket is pending
+   */
+  SchedulerItem* TakePendingItem(PriorityBracket& bracket);
+
+  /**
+   * Returns whether any item of a priority bracket is pending
+   * @param bracket Priority bracket
+   * @return Whether any item is pending
+   */
+  bool HasPendingItem(const PriorityBracket& bracket) const;
+
+  /**
+   * Runs an item until it blocks, and updates its position in the queues
+   * @param item Item to run
+   */
+  void RunItem(SchedulerItem& item);
+
+  /**
+   * Returns the task that is currently running, i.e. the fiber that is running
+   * or otherwise the task associated with the calling thread
+   * @return Current task
+   */
+  TaskItem& GetCurrentThread() &;
+
+  /**
+   * Returns the task that is currently running, i.e. the fiber that is running
+   * or otherwise the task associated with the calling thread
+   * @return Current task
+   */
+  const TaskItem& GetCurrentThread() const&;
+
+  /**
+   * Throws the error that the calling thread is not a simulated task. Kept
+   * out of line, so that looking up the current task stays cheap
+   */
+  [[noreturn]] static void ThrowNoCurrentThread();
+
+  /**
+   * Returns whether the caller runs in a simulated task
+   * @return Whether the caller is a simulated task
+   */
+  bool IsCalledFromTask() const;
 
   /**
    * Yields the current thread, allowing higher-priority threads to run
@@ -390,7 +837,7 @@ export class Scheduler {
    * @return Earliest time point at which any thread will unblock due to timeout
    */
   std::optional<TimePointUs>
-  GetNextBlockTimeout(GetBlockTimeoutOpts opts = {}) const;
+  GetNextBlockTimeout(GetBlockTimeoutOpts opts = {});
 
   /**
    * Returns whether all threads have stopped
@@ -398,19 +845,53 @@ export class Scheduler {
    */
   bool AllThreadsStopped() const;
 
+  /**
+   * Keeps a task busy for an amount of CPU time. Tasks that are busy already
+   * have a lower priority, as the task could not run otherwise, so they are
+   * preempted by it
+   * @param task Task to charge
+   * @param cost CPU time
+   */
+  void ChargeTask(TaskItem& task, DurationUs cost);
+
+  /**
+   * Invokes the task run callback, if any
+   * @param task Task that starts or stops running
+   * @param running Whether the task runs
+   */
+  void ReportTaskRun(const TaskItem& task, bool running) const;
+
+  /**
+   * Returns the priority of the highest-priority busy task. Items of lower
+   * priority do not run until it is done
+   * @return Priority of the highest-priority busy task, or the lowest
+   * priority if no task is busy
+   */
+  ItemPrio GetBusyPriority() const noexcept;
+
   std::size_t                 announced_threads_count{0};
   std::atomic<SchedulerState> state{SchedulerState::Stopped};
+  ExecutionBackend            backend{ExecutionBackend::Threads};
   std::atomic<TimePointUs>    now{Epoch};
 
   std::map<std::thread::id, ThreadItem> threads{};
+  std::deque<FiberItem>                 fibers{};
+  std::vector<TaskItem*>                tasks{};   //!< In order of creation
   std::deque<ExternalEventItem>         external_events{};
   std::deque<PriorityBracket>           priority_brackets{};
+  TimeoutQueue                          timeouts{};
   std::mutex                            sys_mtx{};
   std::atomic<bool>                     running_thread_is_blocked{};
   std::atomic<unsigned>                 entry_id{0};
 
   std::unique_lock<std::mutex> sys_lk{sys_mtx};
   std::unique_ptr<std::latch>  startup_latch{nullptr};
+
+  std::optional<std::function<void(std::size_t, bool)>> task_run_callback{};
+
+  std::vector<TaskItem*> busy_tasks{};          //!< Tasks that use the CPU
+  double                 cpu_scale{0.0};        //!< Calibrated cost scale
+  std::ostream*          cpu_report{nullptr};   //!< Report at shutdown
 };
 
 }   // namespace sil
\ No newline at end of file
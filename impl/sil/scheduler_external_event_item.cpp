@@ -3,13 +3,15 @@ module;
 #include <chrono>
 #include <functional>
 #include <tuple>
+#include <utility>
 
 module hal.sil;
 
 namespace sil {
 
-ExternalEventItem::ExternalEventItem(unsigned prio)
-    : priority{prio} {}
+ExternalEventItem::ExternalEventItem(Scheduler& sched, unsigned prio)
+    : sched{&sched}
+    , priority{prio} {}
 
 void ExternalEventItem::RegisterPendingAction(TimePointUs           timestamp,
                                               std::function<void()> callback) {
@@ -23,6 +25,13 @@ void ExternalEventItem::RegisterPendingAction(TimePointUs           timestamp,
       .callback  = callback,
       .timestamp = timestamp,
   };
+
+  sched->UpdateQueues(*this);
+}
+
+void ExternalEventItem::ClearPendingAction() {
+  pending_action.reset();
+  sched->UpdateQueues(*this);
 }
 
 bool ExternalEventItem::HasPendingAction() const {
@@ -39,7 +48,7 @@ bool ExternalEventItem::IsRunning() const {
 
 bool ExternalEventItem::IsPending(TimePointUs time) const {
   if (pending_action.has_value()) {
-    return pending_action->timestamp == time;
+    return pending_action->timestamp <= time;
   }
 
   return false;
@@ -49,14 +58,21 @@ std::optional<TimePointUs> ExternalEventItem::GetTimeout() const {
   return pending_action.transform([](const Action& a) { return a.timestamp; });
 }
 
+bool ExternalEventItem::IsWaitingOnSyncPrimitive() const {
+  return false;
+}
+
 RunType ExternalEventItem::Run() {
   if (!pending_action) {
     throw std::runtime_error{
         "Cannot run ExternalEventItem when it has no pending action"};
   }
 
-  pending_action->callback();
+  // The action is taken out first, so that the callback can register the
+  // next one
+  auto action = std::move(*pending_action);
   pending_action.reset();
+  action.callback();
   return RunType::Synchronous;
 }
 
@@ -0,0 +1,156 @@
+module;
+
+// macOS only exposes the ucontext API with the X/Open interface enabled
+#if defined(__APPLE__) && !defined(_XOPEN_SOURCE)
+#define _XOPEN_SOURCE 600
+#endif
+
+#include <cstddef>
+#include <cstdint>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <utility>
+
+#include <sys/mman.h>
+#include <ucontext.h>
+#include <unistd.h>
+
+module hal.sil;
+
+namespace sil {
+
+namespace {
+
+/** Fiber that is running on this host thread */
+thread_local FiberItem* current_fiber = nullptr;
+
+/**
+ * Fiber stack with an inaccessible guard page below it, so that a stack
+ * overflow faults instead of silently corrupting other memory. The pages are
+ * mapped on demand, so the host only commits the pages that the task actually
+ * touches
+ */
+class FiberStack {
+ public:
+  /**
+   * Constructor
+   * @param size Usable size of the stack in bytes, rounded up to whole pages
+   */
+  explicit FiberStack(std::size_t size) {
+    const auto page_size = static_cast<std::size_t>(sysconf(_SC_PAGESIZE));
+    usable_size          = (size + page_size - 1) / page_size * page_size;
+    mapped_size          = usable_size + page_size;
+
+    mapping = mmap(nullptr, mapped_size, PROT_READ | PROT_WRITE,
+                   MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    if (mapping == MAP_FAILED) {
+      throw std::runtime_error{"Unable to allocate fiber stack"};
+    }
+
+    // Stacks grow down on all supported hosts
+    if (mprotect(mapping, page_size, PROT_NONE) != 0) {
+      munmap(mapping, mapped_size);
+      throw std::runtime_error{"Unable to protect fiber stack guard page"};
+    }
+  }
+
+  FiberStack(const FiberStack&)            = delete;
+  FiberStack& operator=(const FiberStack&) = delete;
+
+  ~FiberStack() { munmap(mapping, mapped_size); }
+
+  /** Lowest address of the usable stack, just above the guard page */
+  [[nodiscard]] void* Base() const noexcept {
+    return static_cast<std::byte*>(mapping) + (mapped_size - usable_size);
+  }
+
+  /** Usable size of the stack in bytes */
+  [[nodiscard]] std::size_t Size() const noexcept { return usable_size; }
+
+ private:
+  void*       mapping{nullptr};   //!< Mapping of the guard page and stack
+  std::size_t mapped_size{0};     //!< Size of the mapping
+  std::size_t usable_size{0};     //!< Size of the stack above the guard page
+};
+
+}   // namespace
+
+struct FiberItem::Context {
+  explicit Context(std::size_t stack_size)
+      : stack{stack_size} {}
+
+  FiberStack stack;    //!< Fiber stack
+  ucontext_t fiber;    //!< Saved context of the fiber
+  ucontext_t caller;   //!< Saved context of the scheduler
+};
+
+FiberItem::FiberItem(std::string name, unsigned prio, std::size_t index,
+                     std::function<void()> fn, std::size_t stack_size)
+    : TaskItem{std::move(name), prio, index}
+    , fn{std::move(fn)}
+    , ctx{std::make_unique<Context>(stack_size)} {
+  if (getcontext(&ctx->fiber) != 0) {
+    throw std::runtime_error{"Unable to create fiber context"};
+  }
+
+  ctx->fiber.uc_stack.ss_sp   = ctx->stack.Base();
+  ctx->fiber.uc_stack.ss_size = ctx->stack.Size();
+  ctx->fiber.uc_link          = nullptr;
+
+  // makecontext only passes int arguments, so the pointer is split in two
+  const auto self = reinterpret_cast<uintptr_t>(this);
+  makecontext(&ctx->fiber, reinterpret_cast<void (*)()>(&Trampoline), 2,
+              static_cast<unsigned>(static_cast<uint64_t>(self) >> 32U),
+              static_cast<unsigned>(self & 0xFFFF'FFFFU));
+
+  // Run at the simulated epoch, like a thread that is initialized
+  block_timeout_at = TimePointUs{0};
+}
+
+FiberItem::~FiberItem() = default;
+
+FiberItem* FiberItem::Current() noexcept {
+  return current_fiber;
+}
+
+RunType FiberItem::Run() {
+  auto* const prev_fiber = std::exchange(current_fiber, this);
+  swapcontext(&ctx->caller, &ctx->fiber);
+  current_fiber = prev_fiber;
+
+  // Exceptions cannot unwind across stacks, so they are rethrown here
+  if (exception != nullptr) {
+    std::rethrow_exception(std::exchange(exception, nullptr));
+  }
+
+  return RunType::Synchronous;
+}
+
+void FiberItem::Suspend(Scheduler&) {
+  swapcontext(&ctx->fiber, &ctx->caller);
+}
+
+void FiberItem::Main() noexcept {
+  MarkStarted();
+
+  try {
+    fn();
+  } catch (...) {
+    exception = std::current_exception();
+  }
+
+  // Hand control back for good, the fiber is never resumed
+  running = false;
+  setcontext(&ctx->caller);
+}
+
+void FiberItem::Trampoline(unsigned hi, unsigned lo) noexcept {
+  const auto self = static_cast<uintptr_t>((static_cast<uint64_t>(hi) << 32U)
+                                           | static_cast<uint64_t>(lo));
+  reinterpret_cast<FiberItem*>(self)->Main();
+}
+
+}   // namespace sil
@@ -1,12 +1,19 @@
 module;
 
 #include <algorithm>
+#include <cstddef>
 #include <format>
+#include <functional>
 #include <iostream>
 #include <latch>
 #include <mutex>
+#include <optional>
 #include <ranges>
+#include <string>
+#include <string_view>
 #include <thread>
+#include <utility>
+#include <vector>
 
 module hal.sil;
 
@@ -14,10 +21,45 @@ import hstd;
 
 namespace sil {
 
+namespace {
+
+/**
+ * Task thread that runs on this host thread, with the scheduler that owns it.
+ * Avoids looking up the thread map for every scheduler call of a task
+ */
+struct CurrentThread {
+  const Scheduler* sched{nullptr};
+  ThreadItem*      thread{nullptr};
+};
+
+thread_local CurrentThread current_thread{};
+
+}   // namespace
+
 SchedulerState Scheduler::GetState() const noexcept {
   return state.load();
 }
 
+void Scheduler::SetExecutionBackend(ExecutionBackend new_backend) {
+  if (state.load() != SchedulerState::Stopped || announced_threads_count > 0
+      || !fibers.empty()) {
+    throw std::runtime_error{
+        "Scheduler::SetExecutionBackend() must be called before any task is "
+        "created."};
+  }
+
+  backend = new_backend;
+}
+
+ExecutionBackend Scheduler::GetExecutionBackend() const noexcept {
+  return backend;
+}
+
+bool Scheduler::IsSnapshotSafe() const noexcept {
+  // Fibers are part of the process memory, threads do not survive a fork
+  return announced_threads_count == 0 && threads.empty();
+}
+
 void Scheduler::Start() {
   // Create a startup latch with the amount of announced threads
   startup_latch = std::make_unique<std::latch>(announced_threads_count);
@@ -55,7 +97,7 @@ void Scheduler::Start() {
 
 void Scheduler::RunUntil(TimePointUs time, bool inclusive) {
   // Ensure RunUntil is not called from one of the simulated task threads
-  if (threads.contains(std::this_thread::get_id())) {
+  if (IsCalledFromTask()) {
     throw std::runtime_error{
         "Scheduler::RunUntil() cannot be called from a simulated task "
         "thread."};
@@ -87,7 +129,7 @@ void Scheduler::RunUntil(TimePointUs time, bool inclusive) {
 
 bool Scheduler::RunUntilNextTimePoint(TimePointUs upper_bound) {
   // Ensure RunUntil is not called from one of the simulated task threads
-  if (threads.contains(std::this_thread::get_id())) {
+  if (IsCalledFromTask()) {
     throw std::runtime_error{
         "Scheduler::RunUntil() cannot be called from a simulated task "
         "thread."};
@@ -155,35 +197,39 @@ void Scheduler::Shutdown(std::size_t max_wakeups) {
                       max_wakeups)};
     }
   }
+
+  if (cpu_report != nullptr) {
+    *cpu_report << FormatCpuReport() << std::flush;
+  }
 }
 
 void Scheduler::CheckSyncPrimitivePreemption() {
   const auto preempted_prio = GetCurrentThread().GetPriority();
 
+  PromoteDueItems();
+
   for (const auto& bracket : priority_brackets) {
-    if (bracket.prio <= preempted_prio) {
+    if (bracket.prio >= preempted_prio) {
       return;
     }
 
-    for (const auto& thread : bracket.items) {
-      if (thread->IsPending(Now())) {
-        YieldCurrentThread();
-        return;
-      }
+    if (HasPendingItem(bracket)) {
+      GetCurrentThread().MarkPreempted();
+      YieldCurrentThread();
+      return;
     }
   }
 }
 
 ExternalEventItem& Scheduler::RegisterExternalEvent(unsigned prio) & {
-  external_events.push_back(ExternalEventItem{prio});
-  return external_events.back();
+  return external_events.emplace_back(*this, prio);
 }
 
 void Scheduler::AnnounceThread() {
   announced_threads_count++;
 }
 
-void Scheduler::InitializeThread(unsigned prio) {
+void Scheduler::InitializeThread(std::string_view name, unsigned prio) {
   if (now.load() != Epoch || state.load() != SchedulerState::Stopped) {
     throw std::runtime_error{std::format(
         "Scheduler::InitializeThread() can only be called when the scheduler "
@@ -193,6 +239,7 @@ void Scheduler::InitializeThread(unsigned prio) {
 
   // Lock the system mutex to ensure the startup latch has been created
   std::latch* startup_latch_ptr = nullptr;
+  ThreadItem* thread            = nullptr;
   {
     std::scoped_lock lk{sys_mtx};
 
@@ -202,17 +249,41 @@ void Scheduler::InitializeThread(unsigned prio) {
           std::format("Thread {} was already initialized.", tid)};
     }
 
-    threads.emplace(std::piecewise_construct, std::forward_as_tuple(tid),
-                    std::forward_as_tuple(tid, prio, sys_mtx));
+    thread = &threads
+                  .emplace(std::piecewise_construct,
+                           std::forward_as_tuple(tid),
+                           std::forward_as_tuple(tid, std::string{name}, prio,
+                                                 tasks.size(), sys_mtx))
+                  .first->second;
+    tasks.push_back(thread);
+    current_thread = {.sched = this, .thread = thread};
 
     startup_latch_ptr = startup_latch.get();
   }
 
-  GetCurrentThread().Initialize(*this, *startup_latch_ptr);
+  thread->Initialize(*this, *startup_latch_ptr);
+}
+
+void Scheduler::SpawnFiber(std::string_view name, unsigned prio,
+                           std::function<void()> fn, std::size_t stack_size) {
+  if (now.load() != Epoch || state.load() != SchedulerState::Stopped) {
+    throw std::runtime_error{std::format(
+        "Scheduler::SpawnFiber() can only be called when the scheduler is "
+        "still at the simulated epoch and is not started, got {} and {}.",
+        now.load(), std::to_underlying(state.load()))};
+  }
+
+  tasks.push_back(&fibers.emplace_back(std::string{name}, prio, tasks.size(),
+                                       std::move(fn), stack_size));
 }
 
 void Scheduler::DeInitializeThread() {
-  GetCurrentThread().MarkStopped();
+  if (current_thread.sched != this) {
+    ThrowNoCurrentThread();
+  }
+
+  current_thread.thread->MarkStopped();
+  current_thread = {};
 
   // Indicate current thread is "blocked", so that the scheduler thread
   // can continue
@@ -220,39 +291,97 @@ void Scheduler::DeInitializeThread() {
   running_thread_is_blocked.notify_all();
 }
 
+std::size_t Scheduler::GetTaskCount() const noexcept {
+  return tasks.size();
+}
+
+const std::string& Scheduler::GetTaskName(std::size_t index) const {
+  return tasks.at(index)->GetName();
+}
+
+const TaskStats& Scheduler::GetTaskStats(std::size_t index) const {
+  return tasks.at(index)->GetStats();
+}
+
+void Scheduler::SetCpuScale(double scale) {
+  if (!(scale >= 0.0)) {
+    throw std::runtime_error{
+        std::format("{} is not a valid CPU scale, must be at least 0", scale)};
+  }
+
+  cpu_scale = scale;
+}
+
+std::string Scheduler::FormatCpuReport() const {
+  const auto elapsed_us = static_cast<double>(now.load().count());
+  const auto percentage = [elapsed_us](DurationUs time) {
+    return elapsed_us > 0.0
+               ? 100.0 * static_cast<double>(time.count()) / elapsed_us
+               : 0.0;
+  };
+
+  std::size_t name_width = std::string_view{"total"}.size();
+  for (const auto* task : tasks) {
+    name_width = std::max(name_width, task->GetName().size());
+  }
+
+  auto report = std::format(
+      "CPU report at {} us\n{:<{}}  {:>12}  {:>7}  {:>12}  {:>11}  {:>11}\n",
+      now.load().count(), "task", name_width, "cpu [us]", "cpu [%]",
+      "blocked [us]", "activations", "preemptions");
+
+  DurationUs total{0};
+  for (const auto* task : tasks) {
+    const auto& stats = task->GetStats();
+    total += stats.cpu_time;
+
+    report += std::format(
+        "{:<{}}  {:>12}  {:>7.2f}  {:>12}  {:>11}  {:>11}\n", task->GetName(),
+        name_width, stats.cpu_time.count(), percentage(stats.cpu_time),
+        stats.blocked_time.count(), stats.n_activations, stats.n_preemptions);
+  }
+
+  report += std::format("{:<{}}  {:>12}  {:>7.2f}\n", "total", name_width,
+                        total.count(), percentage(total));
+  return report;
+}
+
+void Scheduler::SetTaskRunCallback(std::function<void(std::size_t, bool)> cb) {
+  task_run_callback = std::move(cb);
+}
+
+void Scheduler::ClearTaskRunCallback() {
+  task_run_callback = std::nullopt;
+}
+
 void Scheduler::MarkCurrentItemBlocked() {
   running_thread_is_blocked.store(true);
   running_thread_is_blocked.notify_all();
 }
 
 void Scheduler::InitializePriorityBrackets() {
-  // Add threads to the priority brackets
+  std::vector<SchedulerItem*> items{};
   for (auto& thread : threads | std::views::values) {
-    auto bracket_it = std::ranges::find_if(
-        priority_brackets, [&thread](const PriorityBracket& pb) {
-          return pb.prio == thread.GetPriority();
-        });
-
-    if (bracket_it == priority_brackets.end()) {
-      priority_brackets.emplace_back(PriorityBracket{
-          .prio = thread.GetPriority(), .rr_idx = 0, .items = {&thread}});
-    } else {
-      bracket_it->items.push_back(&thread);
-    }
+    items.push_back(&thread);
+  }
+  for (auto& fiber : fibers) {
+    items.push_back(&fiber);
   }
-
-  // Add the external events to the brackets
   for (auto& event : external_events) {
-    auto bracket_it = std::ranges::find_if(
-        priority_brackets, [&event](const PriorityBracket& pb) {
-          return pb.prio == event.GetPriority();
-        });
-
-    if (bracket_it == priority_brackets.end()) {
-      priority_brackets.emplace_back(PriorityBracket{
-          .prio = event.GetPriority(), .rr_idx = 0, .items = {&event}});
-    } else {
-      bracket_it->items.push_back(&event);
+    items.push_back(&event);
+  }
+
+  const auto find_bracket = [this](ItemPrio prio) {
+    return std::ranges::find_if(
+        priority_brackets,
+        [prio](const PriorityBracket& pb) { return pb.prio == prio; });
+  };
+
+  // Create a bracket per priority, highest priority first
+  for (const auto* item : items) {
+    if (find_bracket(item->GetPriority()) == priority_brackets.end()) {
+      priority_brackets.emplace_back(
+          PriorityBracket{.prio = item->GetPriority()});
     }
   }
 
@@ -260,78 +389,195 @@ void Scheduler::InitializePriorityBrackets() {
                     [](const PriorityBracket& a, const PriorityBracket& b) {
                       return a.prio < b.prio;
                     });
+
+  // Assign the items to their brackets and queue their timeouts. Brackets are
+  // not moved anymore from here on
+  for (auto* item : items) {
+    item->queue_state.bracket = &*find_bracket(item->GetPriority());
+    UpdateQueues(*item);
+  }
 }
 
-const ThreadItem& Scheduler::GetCurrentThread() const& {
-  const auto tid = std::this_thread::get_id();
-  if (!threads.contains(tid)) {
-    throw std::runtime_error{std::format(
-        "No ThreadState was constructed for this thread (id {}).", tid)};
+void Scheduler::UpdateQueues(SchedulerItem& item) {
+  auto& qs = item.queue_state;
+
+  // Items are queued once the scheduler starts
+  if (qs.bracket == nullptr) {
+    return;
+  }
+
+  const auto running = item.IsRunning();
+
+  // Due items are in the ready list instead of the timeout queue
+  if (!qs.ready) {
+    if (const auto timeout = item.GetTimeout(); running && timeout) {
+      timeouts.Update(item, *timeout);
+    } else {
+      timeouts.Remove(item);
+    }
   }
 
-  return threads.at(tid);
+  // Items are (re-)added at the end of the sync list, for round-robin
+  // scheduling among items of equal priority
+  auto& sync_waiting = qs.bracket->sync_waiting;
+  if (qs.sync_idx != SchedulerItem::NotQueued) {
+    sync_waiting.erase(sync_waiting.begin()
+                       + static_cast<std::ptrdiff_t>(qs.sync_idx));
+    for (auto i = qs.sync_idx; i < sync_waiting.size(); ++i) {
+      sync_waiting[i]->queue_state.sync_idx = i;
+    }
+    qs.sync_idx = SchedulerItem::NotQueued;
+  }
+
+  if (running && item.IsWaitingOnSyncPrimitive()) {
+    qs.sync_idx = sync_waiting.size();
+    sync_waiting.push_back(&item);
+  }
 }
 
-ThreadItem& Scheduler::GetCurrentThread() & {
-  const auto tid = std::this_thread::get_id();
-  if (!threads.contains(tid)) {
-    throw std::runtime_error{std::format(
-        "No ThreadState was constructed for this thread (id {}).", tid)};
+void Scheduler::PromoteDueItems() {
+  const auto time = now.load();
+
+  for (auto* item = timeouts.Top();
+       item != nullptr && item->queue_state.timeout <= time;
+       item = timeouts.Top()) {
+    timeouts.Remove(*item);
+    item->queue_state.ready = true;
+    item->queue_state.bracket->ready.push_back(item);
+  }
+}
+
+SchedulerItem* Scheduler::TakePendingItem(PriorityBracket& bracket) {
+  const auto time = now.load();
+
+  while (!bracket.ready.empty()) {
+    auto* item = bracket.ready.front();
+    bracket.ready.pop_front();
+    item->queue_state.ready = false;
+
+    if (item->IsRunning() && item->IsPending(time)) {
+      return item;
+    }
+
+    // The item is no longer pending, e.g. because it stopped
+    UpdateQueues(*item);
+  }
+
+  for (auto* item : bracket.sync_waiting) {
+    if (item->IsRunning() && item->IsPending(time)) {
+      // The timeout is no longer relevant once the item runs
+      timeouts.Remove(*item);
+      return item;
+    }
   }
 
-  return threads.at(tid);
+  return nullptr;
 }
 
-void Scheduler::YieldCurrentThread() {
-  GetCurrentThread().Yield(*this);
+bool Scheduler::HasPendingItem(const PriorityBracket& bracket) const {
+  const auto is_pending = [time = now.load()](const SchedulerItem* item) {
+    return item->IsRunning() && item->IsPending(time);
+  };
+
+  return std::ranges::any_of(bracket.ready, is_pending)
+         || std::ranges::any_of(bracket.sync_waiting, is_pending);
 }
 
-bool Scheduler::HandleNextItem() {
-  bool thread_ran = false;
-  for (auto& bracket : priority_brackets) {
-    for (std::size_t i = 0; i < bracket.items.size(); i++) {
-      auto& item =
-          bracket.items.at((i + bracket.rr_idx) % bracket.items.size());
+void Scheduler::RunItem(SchedulerItem& item) {
+  // Only look up the task when someone observes the run state
+  auto* const task = task_run_callback.has_value()
+                         ? dynamic_cast<TaskItem*>(&item)
+                         : nullptr;
 
-      if (!item->IsRunning()) {
-        continue;
-      }
+  // A busy task keeps running until its CPU time is used up, so it was
+  // reported as running already
+  if (task != nullptr && !task->IsBusy()) {
+    ReportTaskRun(*task, true);
+  }
 
-      if (item->IsPending(now.load())) {
-        // Mark the scheduler as running
-        running_thread_is_blocked.store(false);
+  // Mark the scheduler as running
+  running_thread_is_blocked.store(false);
 
-        // Wake up the thread
-        const auto run_type = item->Run();
+  // Wake up the thread
+  const auto run_type = item.Run();
 
-        // If the action is running asynchronously, block until the woken thread
-        // is blocked again
-        if (run_type == RunType::Asynchronous) {
-          running_thread_is_blocked.wait(false);
-        } else {
-          running_thread_is_blocked.store(true);
-        }
+  // If the action is running asynchronously, block until the woken thread
+  // is blocked again
+  if (run_type == RunType::Asynchronous) {
+    running_thread_is_blocked.wait(false);
+  } else {
+    running_thread_is_blocked.store(true);
+  }
 
-        // Restart the full iteration
-        thread_ran = true;
-        break;
-      }
+  if (task != nullptr && !task->IsBusy()) {
+    ReportTaskRun(*task, false);
+  }
+
+  // The item changed its timeout or blocking state while running
+  UpdateQueues(item);
+}
+
+const TaskItem& Scheduler::GetCurrentThread() const& {
+  if (const auto* fiber = FiberItem::Current(); fiber != nullptr) {
+    return *fiber;
+  }
+
+  if (current_thread.sched != this) [[unlikely]] {
+    ThrowNoCurrentThread();
+  }
+
+  return *current_thread.thread;
+}
+
+TaskItem& Scheduler::GetCurrentThread() & {
+  if (auto* fiber = FiberItem::Current(); fiber != nullptr) {
+    return *fiber;
+  }
+
+  if (current_thread.sched != this) [[unlikely]] {
+    ThrowNoCurrentThread();
+  }
+
+  return *current_thread.thread;
+}
+
+void Scheduler::ThrowNoCurrentThread() {
+  throw std::runtime_error{
+      std::format("No ThreadState was constructed for this thread (id {}).",
+                  std::this_thread::get_id())};
+}
+
+bool Scheduler::IsCalledFromTask() const {
+  return FiberItem::Current() != nullptr || current_thread.sched == this;
+}
+
+void Scheduler::YieldCurrentThread() {
+  GetCurrentThread().Yield(*this);
+}
+
+bool Scheduler::HandleNextItem() {
+  PromoteDueItems();
+
+  const auto busy_prio = GetBusyPriority();
+  for (auto& bracket : priority_brackets) {
+    // Lower-priority items wait until the CPU is no longer busy
+    if (bracket.prio > busy_prio) {
+      break;
     }
 
-    if (thread_ran) {
-      bracket.rr_idx = (bracket.rr_idx + 1) % bracket.items.size();
-      return thread_ran;
+    if (auto* item = TakePendingItem(bracket); item != nullptr) {
+      RunItem(*item);
+      return true;
     }
   }
 
-  return thread_ran;
+  return false;
 }
 
 std::optional<TimePointUs>
-Scheduler::GetNextBlockTimeout(GetBlockTimeoutOpts opts) const {
-  std::optional<TimePointUs> next_timeout{std::nullopt};
-
-  ItemPrio min_prio = opts.min_prio;
+Scheduler::GetNextBlockTimeout(GetBlockTimeoutOpts opts) {
+  // Items that wait for a busy CPU do not run at their timeout
+  ItemPrio min_prio = std::min(opts.min_prio, GetBusyPriority());
 
   if (opts.higher_than_current_prio) {
     const auto current_thread_prio = GetCurrentThread().GetPriority();
@@ -340,31 +586,85 @@ Scheduler::GetNextBlockTimeout(GetBlockTimeoutOpts opts) const {
     }
   }
 
-  for (const auto& bracket : priority_brackets) {
-    for (const auto& item : bracket.items) {
-      if (const auto to = item->GetTimeout();
-          to && (next_timeout == std::nullopt || to < next_timeout)) {
-        // Handle "exclude_now"
-        if (opts.exclude_now && *to > now.load()) {
-          continue;
-        }
+  // All items that are due now are in the ready lists, so all timeouts in the
+  // timeout queue are in the future
+  PromoteDueItems();
 
-        // Handle minimum priority
-        if (*to == now.load() && item->GetPriority() > min_prio) {
-          continue;
-        }
+  std::optional<TimePointUs> next_timeout{std::nullopt};
 
-        next_timeout = to;
+  if (!opts.exclude_now) {
+    for (const auto& bracket : priority_brackets) {
+      // Handle minimum priority
+      if (bracket.prio > min_prio) {
+        break;
+      }
+
+      for (const auto* item : bracket.ready) {
+        if (const auto to = item->GetTimeout();
+            item->IsRunning() && to
+            && (next_timeout == std::nullopt || to < next_timeout)) {
+          next_timeout = to;
+        }
       }
     }
   }
 
-  return next_timeout;
+  if (next_timeout.has_value()) {
+    return next_timeout;
+  }
+
+  if (const auto* item = timeouts.Top(); item != nullptr) {
+    return item->queue_state.timeout;
+  }
+
+  return std::nullopt;
+}
+
+void Scheduler::ChargeTask(TaskItem& task, DurationUs cost) {
+  if (cost == DurationUs{0}) {
+    return;
+  }
+
+  for (auto* busy_task : busy_tasks) {
+    busy_task->MarkPreempted(cost);
+    UpdateQueues(*busy_task);
+  }
+
+  // Only the most recently charged task uses the CPU, the others are
+  // preempted until it is done
+  if (!busy_tasks.empty()) {
+    ReportTaskRun(*busy_tasks.back(), false);
+  }
+
+  busy_tasks.push_back(&task);
+  task.BlockBusy(cost, *this);
+  std::erase(busy_tasks, &task);
+
+  if (!busy_tasks.empty()) {
+    ReportTaskRun(*busy_tasks.back(), true);
+  }
+}
+
+void Scheduler::ReportTaskRun(const TaskItem& task, bool running) const {
+  if (task_run_callback.has_value()) {
+    (*task_run_callback)(task.GetIndex(), running);
+  }
+}
+
+ItemPrio Scheduler::GetBusyPriority() const noexcept {
+  ItemPrio prio = LowestPrio;
+  for (const auto* task : busy_tasks) {
+    prio = std::min(prio, task->GetPriority());
+  }
+  return prio;
 }
 
 bool Scheduler::AllThreadsStopped() const {
   return std::ranges::all_of(
-      threads, [](const auto& kvp) { return !kvp.second.IsRunning(); });
+             threads,
+             [](const auto& kvp) { return !kvp.second.IsRunning(); })
+         && std::ranges::all_of(
+             fibers, [](const FiberItem& fiber) { return !fiber.IsRunning(); });
 }
 
 }   // namespace sil
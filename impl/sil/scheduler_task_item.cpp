@@ -0,0 +1,158 @@
+module;
+
+#include <chrono>
+#include <cmath>
+#include <cstddef>
+#include <optional>
+#include <string>
+#include <utility>
+
+#include <time.h>
+
+module hal.sil;
+
+namespace sil {
+
+namespace {
+
+/**
+ * Returns the CPU time that the calling host thread consumed
+ * @return Host CPU time
+ */
+std::chrono::nanoseconds HostCpuTime() noexcept {
+  timespec ts{};
+  clock_gettime(CLOCK_THREAD_CPUTIME_ID, &ts);
+  return std::chrono::seconds{ts.tv_sec} + std::chrono::nanoseconds{ts.tv_nsec};
+}
+
+}   // namespace
+
+TaskItem::TaskItem(std::string name, unsigned prio, std::size_t index)
+    : SchedulerItem{}
+    , name{std::move(name)}
+    , prio{prio}
+    , index{index} {}
+
+ItemPrio TaskItem::GetPriority() const {
+  return {ThreadPriorityLevel, prio};
+}
+
+bool TaskItem::IsRunning() const {
+  return running;
+}
+
+bool TaskItem::IsPending(TimePointUs time) const {
+  if (block_timeout_at.has_value() && *block_timeout_at <= time) {
+    return true;
+  }
+
+  if (sync_primitive_block.has_value()
+      && sync_primitive_block->CheckUnblock()) {
+    return true;
+  }
+
+  return false;
+}
+
+std::optional<TimePointUs> TaskItem::GetTimeout() const {
+  return block_timeout_at;
+}
+
+bool TaskItem::IsWaitingOnSyncPrimitive() const {
+  return sync_primitive_block.has_value();
+}
+
+void TaskItem::BlockUntilUs(DurationUs time, Scheduler& sched) {
+  ChargeHostTime(sched);
+
+  block_timeout_at = time;
+  BlockUntilWoken(sched);
+}
+
+void TaskItem::Yield(Scheduler& sched) {
+  ChargeHostTime(sched);
+
+  block_timeout_at = sched.Now();
+  BlockUntilWoken(sched);
+}
+
+void TaskItem::ChargeCpuTime(DurationUs cost, Scheduler& sched) {
+  // The task ran on the host up to here, which comes before the work it
+  // charges
+  ChargeHostTime(sched);
+  sched.ChargeTask(*this, cost);
+}
+
+void TaskItem::BlockBusy(DurationUs cost, Scheduler& sched) {
+  stats.cpu_time += cost;
+
+  busy             = true;
+  block_timeout_at = sched.Now() + cost;
+  BlockUntilWoken(sched);
+  busy = false;
+}
+
+void TaskItem::MarkPreempted(DurationUs delay) noexcept {
+  stats.n_preemptions++;
+
+  if (busy && block_timeout_at.has_value()) {
+    *block_timeout_at += delay;
+  }
+}
+
+void TaskItem::MarkStarted() noexcept {
+  stats.n_activations++;
+  host_resumed_at = HostCpuTime();
+}
+
+void TaskItem::ChargeHostTime(Scheduler& sched) {
+  if (!host_resumed_at.has_value() || sched.GetCpuScale() <= 0.0) {
+    host_resumed_at = std::nullopt;
+    return;
+  }
+
+  // Measuring continues from here, as the task keeps running if the charge
+  // does not block it
+  const auto host_now = HostCpuTime();
+  const auto host_us  = std::chrono::duration<double, std::micro>{
+      host_now - std::exchange(*host_resumed_at, host_now)};
+
+  // Parts of a microsecond are carried over to the next charge
+  uncharged_us += host_us.count() * sched.GetCpuScale();
+
+  const auto cost_us = std::floor(uncharged_us);
+  uncharged_us -= cost_us;
+
+  sched.ChargeTask(*this, DurationUs{static_cast<uint64_t>(cost_us)});
+}
+
+TaskItem::UnblockReason TaskItem::BlockUntilWoken(Scheduler& sched) {
+  const auto blocked_at = sched.Now();
+
+  Suspend(sched);
+
+  // Time spent busy is CPU time, which is counted when it is charged
+  if (!busy) {
+    stats.blocked_time += sched.Now() - blocked_at;
+    stats.n_activations++;
+  }
+  host_resumed_at = sched.GetCpuScale() > 0.0
+                        ? std::optional{HostCpuTime()}
+                        : std::nullopt;
+
+  // Determine unblock reason
+  auto reason = UnblockReason::Timeout;
+
+  if (sync_primitive_block.has_value()
+      && sync_primitive_block->CheckUnblock()) {
+    reason = UnblockReason::SyncPrimitive;
+  }
+
+  // Clear all unblock reasons
+  block_timeout_at     = std::nullopt;
+  sync_primitive_block = std::nullopt;
+
+  return reason;
+}
+
+}   // namespace sil
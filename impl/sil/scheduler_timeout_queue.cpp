@@ -0,0 +1,103 @@
+module;
+
+#include <cstddef>
+#include <vector>
+
+module hal.sil;
+
+namespace sil {
+
+void TimeoutQueue::Update(SchedulerItem& item, TimePointUs timeout) {
+  auto& qs   = item.queue_state;
+  qs.timeout = timeout;
+  qs.seq     = next_seq++;
+
+  if (qs.heap_idx == SchedulerItem::NotQueued) {
+    heap.push_back(&item);
+    qs.heap_idx = heap.size() - 1;
+    SiftUp(qs.heap_idx);
+  } else {
+    // The new timeout may be earlier or later than the previous one
+    SiftUp(qs.heap_idx);
+    SiftDown(qs.heap_idx);
+  }
+}
+
+void TimeoutQueue::Remove(SchedulerItem& item) {
+  const auto idx = item.queue_state.heap_idx;
+  if (idx == SchedulerItem::NotQueued) {
+    return;
+  }
+
+  item.queue_state.heap_idx = SchedulerItem::NotQueued;
+
+  auto* const last = heap.back();
+  heap.pop_back();
+  if (last == &item) {
+    return;
+  }
+
+  // Move the last item into the hole, and restore the heap property
+  Place(idx, last);
+  SiftUp(idx);
+  SiftDown(last->queue_state.heap_idx);
+}
+
+SchedulerItem* TimeoutQueue::Top() const noexcept {
+  return heap.empty() ? nullptr : heap.front();
+}
+
+bool TimeoutQueue::Less(const SchedulerItem* a,
+                        const SchedulerItem* b) noexcept {
+  const auto& qa = a->queue_state;
+  const auto& qb = b->queue_state;
+  return qa.timeout < qb.timeout
+         || (qa.timeout == qb.timeout && qa.seq < qb.seq);
+}
+
+void TimeoutQueue::Place(std::size_t idx, SchedulerItem* item) noexcept {
+  heap[idx]                  = item;
+  item->queue_state.heap_idx = idx;
+}
+
+void TimeoutQueue::SiftUp(std::size_t idx) noexcept {
+  auto* const item = heap[idx];
+
+  while (idx > 0) {
+    const auto parent = (idx - 1) / 2;
+    if (!Less(item, heap[parent])) {
+      break;
+    }
+
+    Place(idx, heap[parent]);
+    idx = parent;
+  }
+
+  Place(idx, item);
+}
+
+void TimeoutQueue::SiftDown(std::size_t idx) noexcept {
+  auto* const item = heap[idx];
+
+  while (true) {
+    const auto left = 2 * idx + 1;
+    if (left >= heap.size()) {
+      break;
+    }
+
+    const auto right    = left + 1;
+    const auto smallest = (right < heap.size() && Less(heap[right], heap[left]))
+                              ? right
+                              : left;
+    if (!Less(heap[smallest], item)) {
+      break;
+    }
+
+    Place(idx, heap[smallest]);
+    idx = smallest;
+  }
+
+  Place(idx, item);
+}
+
+}   // namespace sil
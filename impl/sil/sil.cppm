@@ -4,4 +4,5 @@ export import :gpio;
 export import :spi;
 export import :system;
 export import :scheduler;
-export import :uart;
\ No newline at end of file
+export import :uart;
+export import :vcd;
\ No newline at end of file
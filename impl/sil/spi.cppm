@@ -1,5 +1,6 @@
 module;
 
+#include <algorithm>
 #include <bit>
 #include <chrono>
 #include <cstdint>
@@ -23,6 +24,7 @@ import hstd;
 import hal.abstract;
 
 import :scheduler;
+import :vcd;
 
 namespace sil {
 
@@ -68,6 +70,18 @@ export class SpiMaster : public ::hal::UsedPeripheral {
    * Clears the SPI MOSI callback
    */
   virtual void ClearMosiCallback() = 0;
+
+  /**
+   * Starts recording the MOSI and MISO data, by declaring a scope with the SPI
+   * master in a VCD writer
+   * @param writer VCD writer, which must outlive the recording
+   */
+  virtual void AttachVcd(VcdWriter& writer) = 0;
+
+  /**
+   * Stops recording the MOSI and MISO data
+   */
+  virtual void DetachVcd() noexcept = 0;
 };
 
 /**
@@ -99,6 +113,11 @@ class BlockingSpiMaster final : public SpiMaster {
   bool TransmitBlocking(std::span<Data> data, hstd::Duration auto) {
     const auto t0 = sched.Now();
 
+    if (vcd != nullptr) {
+      vcd->ChangeFrame(vcd_mosi, t0, t0 + TransmissionTime(data.size()),
+                       std::span<const Data>{data});
+    }
+
     for (std::size_t i = 0; i < data.size(); ++i) {
       // Simulate byte-for-byte transmission delays
       const auto byte = data[i];
@@ -151,6 +170,13 @@ class BlockingSpiMaster final : public SpiMaster {
           "before the previous completed"};
     }
 
+    // The data is clocked in before it is available, but not before now
+    if (vcd != nullptr) {
+      const auto duration = std::min(TransmissionTime(rx_data.size()),
+                                     timestamp - sched.Now());
+      vcd->ChangeFrame(vcd_miso, timestamp - duration, timestamp, rx_data);
+    }
+
     pending_miso_buf.reserve(rx_data.size());
     std::ranges::copy(rx_data, std::back_inserter(pending_miso_buf));
 
@@ -176,6 +202,16 @@ class BlockingSpiMaster final : public SpiMaster {
 
   void ClearMosiCallback() final { mosi_callback = {}; }
 
+  void AttachVcd(VcdWriter& writer) final {
+    writer.BeginScope(name);
+    vcd_mosi = writer.AddVar("mosi", DataSize);
+    vcd_miso = writer.AddVar("miso", 8);
+    writer.EndScope();
+    vcd = &writer;
+  }
+
+  void DetachVcd() noexcept final { vcd = nullptr; }
+
  private:
   [[nodiscard]] constexpr DurationUs
   TransmissionTime(std::size_t n_bytes) const {
@@ -194,6 +230,10 @@ class BlockingSpiMaster final : public SpiMaster {
   ExternalEventItem&     miso_evt;
   std::vector<std::byte> pending_miso_buf{};
   std::deque<std::byte>  miso_buf{};
+
+  VcdWriter*       vcd{nullptr};   //!< Recording VCD writer, if any
+  VcdWriter::VarId vcd_mosi{0};    //!< MOSI data in the VCD
+  VcdWriter::VarId vcd_miso{0};    //!< MISO data, as bytes, in the VCD
 };
 
 static_assert(hal::BlockingDuplexSpiMaster<BlockingSpiMaster<>>);
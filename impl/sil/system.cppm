@@ -1,10 +1,15 @@
 module;
 
+#include <cstddef>
 #include <cstdint>
 #include <format>
 #include <functional>
+#include <iostream>
 #include <memory>
 #include <span>
+#include <stdexcept>
+#include <string>
+#include <utility>
 #include <vector>
 
 export module hal.sil:system;
@@ -13,27 +18,69 @@ import :gpio;
 import :scheduler;
 import :uart;
 import :spi;
+import :vcd;
 
 namespace sil {
 
+/**
+ * Simulated device, consisting of a scheduler and peripherals. Any number of
+ * systems can exist side by side. Code running in a simulated task finds its
+ * system through System::Current(), which returns the system that is bound to
+ * the calling host thread
+ */
 export class System {
-  friend std::unique_ptr<System> std::make_unique<System>();
-
-  static std::unique_ptr<System>& instance_ptr() noexcept {
-    static std::unique_ptr<System> inst_ptr{nullptr};
-    return inst_ptr;
+  static System*& current_ptr() noexcept {
+    thread_local System* current{nullptr};
+    return current;
   }
 
  public:
-  static System& instance() noexcept {
-    auto& inst_ptr = instance_ptr();
-    if (inst_ptr == nullptr) {
-      inst_ptr = std::make_unique<System>();
+  /**
+   * Binds a system to the calling thread for the lifetime of the scope, and
+   * restores the previously bound system afterwards
+   */
+  class Scope {
+   public:
+    explicit Scope(System& sys) noexcept
+        : prev{std::exchange(current_ptr(), &sys)} {}
+
+    Scope(const Scope&)            = delete;
+    Scope& operator=(const Scope&) = delete;
+
+    ~Scope() { current_ptr() = prev; }
+
+   private:
+    System* prev;   //!< Previously bound system
+  };
+
+  System() = default;
+
+  System(const System&)            = delete;
+  System& operator=(const System&) = delete;
+
+  /**
+   * Returns the system that is bound to the calling thread
+   * @return Current system
+   */
+  static System& Current() {
+    auto* sys = current_ptr();
+    if (sys == nullptr) {
+      throw std::runtime_error{"No SIL system is bound to this thread"};
     }
-    return *inst_ptr;
+    return *sys;
   }
 
-  static void Reset() { instance_ptr().reset(); }
+  /**
+   * Returns the system that is bound to the calling thread, if any
+   * @return Current system, or nullptr if no system is bound
+   */
+  static System* CurrentOrNull() noexcept { return current_ptr(); }
+
+  /**
+   * Binds a system to the calling thread
+   * @param sys System to bind, or nullptr to unbind the current system
+   */
+  static void SetCurrent(System* sys) noexcept { current_ptr() = sys; }
 
   /**
    * Sets an error callback for the system
@@ -62,8 +109,8 @@ export class System {
 
   Gpio& DefineGpio(std::string_view name, GpioDirection direction,
                    bool initial_state = false) {
-    return *gpios.emplace_back(
-        std::make_unique<Gpio>(std::string{name}, direction, initial_state));
+    return *gpios.emplace_back(std::make_unique<Gpio>(
+        sched, std::string{name}, direction, initial_state));
   }
 
   [[nodiscard]] std::size_t GetGpioCount() const noexcept {
@@ -115,9 +162,93 @@ export class System {
    */
   Scheduler& GetScheduler() & noexcept { return sched; }
 
- private:
-  System() {}
+  /**
+   * Returns whether a snapshot of the system, e.g. a forked process, can
+   * continue the simulation. A VCD recording is not safe to snapshot, as the
+   * snapshot would write to the same file as the system
+   * @return Whether the system can be snapshotted
+   */
+  [[nodiscard]] bool IsSnapshotSafe() const noexcept {
+    return vcd == nullptr && sched.IsSnapshotSafe();
+  }
 
+  /**
+   * Starts recording the run state of the tasks, the GPIO levels and the data
+   * of the UARTs and SPI masters to a VCD file. Tasks and peripherals that
+   * are defined afterwards are not recorded
+   * @param path Path of the VCD file
+   * @param buffer_size Size of the write buffer in bytes
+   */
+  void StartVcd(const std::string& path,
+                std::size_t buffer_size = VcdWriter::DefaultBufferSize) {
+    if (vcd != nullptr) {
+      throw std::runtime_error{"A VCD recording is already running"};
+    }
+
+    auto writer = std::make_unique<VcdWriter>(sched, path, buffer_size);
+
+    std::vector<VcdWriter::VarId> task_vars{};
+    writer->BeginScope("tasks");
+    for (std::size_t i = 0; i < sched.GetTaskCount(); ++i) {
+      task_vars.push_back(writer->AddVar(sched.GetTaskName(i), 1, 0));
+    }
+    writer->EndScope();
+
+    writer->BeginScope("gpio");
+    for (auto& gpio : gpios) {
+      gpio->AttachVcd(*writer);
+    }
+    writer->EndScope();
+
+    writer->BeginScope("uart");
+    for (auto& uart : uarts) {
+      uart->AttachVcd(*writer);
+    }
+    writer->EndScope();
+
+    writer->BeginScope("spi");
+    for (auto& spi_master : spi_masters) {
+      spi_master->AttachVcd(*writer);
+    }
+    writer->EndScope();
+
+    writer->EndDefinitions();
+
+    sched.SetTaskRunCallback(
+        [w = writer.get(), task_vars = std::move(task_vars)](std::size_t task,
+                                                             bool running) {
+          if (task < task_vars.size()) {
+            w->Change(task_vars[task], running);
+          }
+        });
+
+    vcd = std::move(writer);
+  }
+
+  /**
+   * Stops the VCD recording, if any, and closes the file
+   */
+  void StopVcd() {
+    if (vcd == nullptr) {
+      return;
+    }
+
+    sched.ClearTaskRunCallback();
+    for (auto& gpio : gpios) {
+      gpio->DetachVcd();
+    }
+    for (auto& uart : uarts) {
+      uart->DetachVcd();
+    }
+    for (auto& spi_master : spi_masters) {
+      spi_master->DetachVcd();
+    }
+
+    const auto writer = std::move(vcd);
+    writer->Close();
+  }
+
+ private:
   Scheduler sched{};
 
   std::vector<std::unique_ptr<Gpio>>      gpios{};
@@ -125,6 +256,9 @@ export class System {
   std::vector<std::unique_ptr<SpiMaster>> spi_masters{};
 
   std::optional<std::function<void(const char*)>> error_callback{};
+
+  //! Running VCD recording. Destroyed first, which closes the file
+  std::unique_ptr<VcdWriter> vcd{nullptr};
 };
 
 }   // namespace sil
@@ -132,14 +266,41 @@ export class System {
 using ErrorCallback           = void (*)(const char*);
 using GpioEdgeCallback        = void (*)(int);
 using UartTransmitCallback    = void (*)(const uint8_t*, std::size_t);
+using UartTransmitStartCallback =
+    void (*)(uint64_t, uint64_t, const uint8_t*, std::size_t);
 using SpiMisoSizeHintCallback = void (*)(std::size_t);
 using SpiMosiCallback         = void (*)(const uint8_t*, std::size_t);
 
+/** Opaque handle to a system, as seen by the host */
+using SystemHandle = sil::System*;
+
+/** Result of a waveform analysis, as seen by the host */
+struct GpioWaveformAnalysis {
+  uint64_t n_periods;
+  uint64_t n_glitches;
+  double   mean_frequency_hz;
+  double   mean_duty_cycle;
+  uint64_t min_period_us;
+  uint64_t max_period_us;
+  double   min_duty_cycle;
+  double   max_duty_cycle;
+  double   period_stddev_us;
+};
+
+/** Execution statistics of a task, as seen by the host */
+struct SchedTaskStats {
+  uint64_t cpu_time_us;
+  uint64_t blocked_time_us;
+  uint64_t n_activations;
+  uint64_t n_preemptions;
+};
+
 namespace {
 
 /**
  * Helper function for performing an action with a GPIO given its index
  * @tparam T Return type
+ * @param sys System that owns the peripheral
  * @param index GPIO index
  * @param err_value Value to return in case the GPIO could not be found, or an
  * error occurs
@@ -147,10 +308,10 @@ namespace {
  * @return Result of inner function, or error value in case of a failure
  */
 template <typename T, std::invocable<sil::Gpio&> F>
-T WithGpio(std::size_t index, T err_value, F inner)
+T WithGpio(sil::System& sys, std::size_t index, T err_value, F inner)
   requires(!std::is_same_v<std::invoke_result_t<F, sil::Gpio&>, void>)
 {
-  auto& sys = sil::System::instance();
+  const sil::System::Scope scope{sys};
 
   try {
     auto* gpio = sys.GetGpio(index);
@@ -170,6 +331,7 @@ T WithGpio(std::size_t index, T err_value, F inner)
 /**
  * Helper function for performing an action with a GPIO given its index
  * @tparam T Return type
+ * @param sys System that owns the peripheral
  * @param index GPIO index
  * @param err_value Value to return in case the GPIO could not be found, or an
  * error occurs
@@ -177,10 +339,10 @@ T WithGpio(std::size_t index, T err_value, F inner)
  * @return Result of inner function, or error value in case of a failure
  */
 template <std::invocable<sil::Gpio&> F>
-void WithGpio(std::size_t index, F inner)
+void WithGpio(sil::System& sys, std::size_t index, F inner)
   requires(std::is_same_v<std::invoke_result_t<F, sil::Gpio&>, void>)
 {
-  auto& sys = sil::System::instance();
+  const sil::System::Scope scope{sys};
 
   try {
     auto* gpio = sys.GetGpio(index);
@@ -198,6 +360,7 @@ void WithGpio(std::size_t index, F inner)
 /**
  * Helper function for performing an action with a UART given its index
  * @tparam T Return type
+ * @param sys System that owns the peripheral
  * @param index UART index
  * @param err_value Value to return in case the UART could not be found, or an
  * error occurs
@@ -205,9 +368,9 @@ void WithGpio(std::size_t index, F inner)
  * @return Result of inner function, or error value in case of a failure
  */
 template <typename T>
-T WithUart(std::size_t index, T err_value,
+T WithUart(sil::System& sys, std::size_t index, T err_value,
            std::invocable<sil::Uart&> auto inner) {
-  auto& sys = sil::System::instance();
+  const sil::System::Scope scope{sys};
 
   try {
     auto* uart = sys.GetUart(index);
@@ -227,6 +390,7 @@ T WithUart(std::size_t index, T err_value,
 /**
  * Helper function for performing an action with a SPI master given its index
  * @tparam T Return type
+ * @param sys System that owns the peripheral
  * @param index SPI master index
  * @param err_value Value to return in case the UART could not be found, or an
  * error occurs
@@ -234,9 +398,9 @@ T WithUart(std::size_t index, T err_value,
  * @return Result of inner function, or error value in case of a failure
  */
 template <typename T>
-T WithSpiMaster(std::size_t index, T err_value,
+T WithSpiMaster(sil::System& sys, std::size_t index, T err_value,
                 std::invocable<sil::SpiMaster&> auto inner) {
-  auto& sys = sil::System::instance();
+  const sil::System::Scope scope{sys};
 
   try {
     auto* spi_master = sys.GetSpiMaster(index);
@@ -257,16 +421,59 @@ T WithSpiMaster(std::size_t index, T err_value,
 
 extern "C" {
 
-[[maybe_unused]] void SetErrorCallback(ErrorCallback cb) {
-  sil::System::instance().SetErrorCallback(cb);
+[[nodiscard]] SystemHandle Sil_CreateSystem() {
+  try {
+    return new sil::System{};
+  } catch (std::exception&) {
+    return nullptr;
+  }
 }
 
-[[maybe_unused]] void ClearErrorCallback() {
-  sil::System::instance().ClearErrorCallback();
+[[maybe_unused]] void Sil_DestroySystem(SystemHandle handle) {
+  if (sil::System::CurrentOrNull() == handle) {
+    sil::System::SetCurrent(nullptr);
+  }
+  delete handle;
 }
 
-[[maybe_unused]] void Sched_Start() {
-  auto& sys = sil::System::instance();
+[[maybe_unused]] void Sil_SetCurrentSystem(SystemHandle handle) {
+  sil::System::SetCurrent(handle);
+}
+
+[[maybe_unused]] void SetErrorCallback(SystemHandle handle, ErrorCallback cb) {
+  handle->SetErrorCallback(cb);
+}
+
+[[maybe_unused]] void ClearErrorCallback(SystemHandle handle) {
+  handle->ClearErrorCallback();
+}
+
+[[maybe_unused]] bool Sched_SetExecutionBackend(SystemHandle handle,
+                                                int          backend) {
+  auto&                    sys = *handle;
+  const sil::System::Scope scope{sys};
+
+  try {
+    switch (backend) {
+    case static_cast<int>(sil::ExecutionBackend::Threads):
+    case static_cast<int>(sil::ExecutionBackend::Fibers):
+      sys.GetScheduler().SetExecutionBackend(
+          static_cast<sil::ExecutionBackend>(backend));
+      return true;
+    default:
+      sys.HandleError(
+          std::format("{} is not a valid execution backend", backend));
+      return false;
+    }
+  } catch (std::exception& e) {
+    sys.HandleException(e);
+    return false;
+  }
+}
+
+[[maybe_unused]] void Sched_Start(SystemHandle handle) {
+  auto&                    sys = *handle;
+  const sil::System::Scope scope{sys};
 
   try {
     sys.GetScheduler().Start();
@@ -275,8 +482,9 @@ extern "C" {
   }
 }
 
-[[maybe_unused]] void Sched_RunUntil(uint64_t time_us) {
-  auto& sys = sil::System::instance();
+[[maybe_unused]] void Sched_RunUntil(SystemHandle handle, uint64_t time_us) {
+  auto&                    sys = *handle;
+  const sil::System::Scope scope{sys};
 
   try {
     sys.GetScheduler().RunUntil(sil::TimePointUs{time_us});
@@ -285,8 +493,10 @@ extern "C" {
   }
 }
 
-[[nodiscard]] bool Sched_RunUntilNextTimePoint(uint64_t upper_bound) {
-  auto& sys = sil::System::instance();
+[[nodiscard]] bool Sched_RunUntilNextTimePoint(SystemHandle handle,
+                                               uint64_t     upper_bound) {
+  auto&                    sys = *handle;
+  const sil::System::Scope scope{sys};
 
   try {
     return sys.GetScheduler().RunUntilNextTimePoint(
@@ -297,8 +507,10 @@ extern "C" {
   }
 }
 
-[[maybe_unused]] void Sched_Shutdown(std::size_t max_iters) {
-  auto& sys = sil::System::instance();
+[[maybe_unused]] void Sched_Shutdown(SystemHandle handle,
+                                     std::size_t  max_iters) {
+  auto&                    sys = *handle;
+  const sil::System::Scope scope{sys};
 
   try {
     sys.GetScheduler().Shutdown(max_iters);
@@ -307,13 +519,109 @@ extern "C" {
   }
 }
 
-[[maybe_unused]] uint64_t Sched_Now() {
-  auto& sys = sil::System::instance();
+[[maybe_unused]] bool Sil_StartVcdRecording(SystemHandle handle,
+                                            const char*  path,
+                                            std::size_t  buffer_size) {
+  auto&                    sys = *handle;
+  const sil::System::Scope scope{sys};
+
+  try {
+    sys.StartVcd(path, buffer_size);
+    return true;
+  } catch (std::exception& e) {
+    sys.HandleException(e);
+    return false;
+  }
+}
+
+[[maybe_unused]] bool Sil_StopVcdRecording(SystemHandle handle) {
+  auto&                    sys = *handle;
+  const sil::System::Scope scope{sys};
+
+  try {
+    sys.StopVcd();
+    return true;
+  } catch (std::exception& e) {
+    sys.HandleException(e);
+    return false;
+  }
+}
+
+[[maybe_unused]] bool Sched_IsSnapshotSafe(SystemHandle handle) {
+  auto&                    sys = *handle;
+  const sil::System::Scope scope{sys};
+  return sys.IsSnapshotSafe();
+}
+
+[[maybe_unused]] uint64_t Sched_Now(SystemHandle handle) {
+  auto&                    sys = *handle;
+  const sil::System::Scope scope{sys};
   return sys.GetScheduler().Now().count();
 }
 
-[[maybe_unused]] std::size_t Gpio_GetGpioCount() {
-  auto& sys = sil::System::instance();
+[[maybe_unused]] bool Sched_SetCpuScale(SystemHandle handle, double scale) {
+  auto&                    sys = *handle;
+  const sil::System::Scope scope{sys};
+
+  try {
+    sys.GetScheduler().SetCpuScale(scale);
+    return true;
+  } catch (std::exception& e) {
+    sys.HandleException(e);
+    return false;
+  }
+}
+
+[[maybe_unused]] void Sched_EnableCpuReport(SystemHandle handle, bool enable) {
+  auto&                    sys = *handle;
+  const sil::System::Scope scope{sys};
+  sys.GetScheduler().SetCpuReportStream(enable ? &std::cout : nullptr);
+}
+
+[[maybe_unused]] std::size_t Sched_GetTaskCount(SystemHandle handle) {
+  auto&                    sys = *handle;
+  const sil::System::Scope scope{sys};
+  return sys.GetScheduler().GetTaskCount();
+}
+
+[[maybe_unused]] const char* Sched_GetTaskName(SystemHandle handle,
+                                               std::size_t  index) {
+  auto&                    sys = *handle;
+  const sil::System::Scope scope{sys};
+
+  try {
+    return sys.GetScheduler().GetTaskName(index).c_str();
+  } catch (std::exception& e) {
+    sys.HandleException(e);
+    return nullptr;
+  }
+}
+
+[[maybe_unused]] bool Sched_GetTaskStats(SystemHandle    handle,
+                                         std::size_t     index,
+                                         SchedTaskStats* result) {
+  auto&                    sys = *handle;
+  const sil::System::Scope scope{sys};
+
+  try {
+    const auto& stats = sys.GetScheduler().GetTaskStats(index);
+
+    *result = {
+        .cpu_time_us     = stats.cpu_time.count(),
+        .blocked_time_us = stats.blocked_time.count(),
+        .n_activations   = stats.n_activations,
+        .n_preemptions   = stats.n_preemptions,
+    };
+    return true;
+  } catch (std::exception& e) {
+    sys.HandleException(e);
+    return false;
+  }
+}
+
+[[maybe_unused]] std::size_t Gpio_GetGpioCount(SystemHandle handle) {
+  auto&                    sys = *handle;
+  const sil::System::Scope scope{sys};
 
   try {
     return sys.GetGpioCount();
@@ -323,8 +631,10 @@ extern "C" {
   }
 }
 
-[[maybe_unused]] const char* Gpio_GetGpioName(std::size_t index) {
-  auto& sys = sil::System::instance();
+[[maybe_unused]] const char* Gpio_GetGpioName(SystemHandle handle,
+                                              std::size_t  index) {
+  auto&                    sys = *handle;
+  const sil::System::Scope scope{sys};
 
   try {
     const auto* gpio = sys.GetGpio(index);
@@ -340,8 +650,10 @@ extern "C" {
   }
 }
 
-[[maybe_unused]] void Gpio_SetInputPinState(std::size_t index, bool state) {
-  WithGpio(index, [state](sil::Gpio& gpio) {
+[[maybe_unused]] void Gpio_SetInputPinState(SystemHandle handle,
+                                            std::size_t  index,
+                                            bool         state) {
+  WithGpio(*handle, index, [state](sil::Gpio& gpio) {
     if (gpio.direction() != sil::GpioDirection::Input) {
       throw std::runtime_error{std::format(
           "Cannot set GPIO state for non-input pin {}", gpio.GetName())};
@@ -351,8 +663,9 @@ extern "C" {
   });
 }
 
-[[maybe_unused]] bool Gpio_GetOutputPinState(std::size_t index) {
-  return WithGpio(index, false, [](sil::Gpio& gpio) {
+[[maybe_unused]] bool Gpio_GetOutputPinState(SystemHandle handle,
+                                             std::size_t  index) {
+  return WithGpio(*handle, index, false, [](sil::Gpio& gpio) {
     if (gpio.direction() != sil::GpioDirection::Output) {
       throw std::runtime_error{std::format(
           "Cannot get GPIO state for non-output pin {}", gpio.GetName())};
@@ -362,9 +675,10 @@ extern "C" {
   });
 }
 
-[[maybe_unused]] void Gpio_SetOutputPinEdgeCallback(std::size_t      index,
+[[maybe_unused]] void Gpio_SetOutputPinEdgeCallback(SystemHandle     handle,
+                                                    std::size_t      index,
                                                     GpioEdgeCallback callback) {
-  WithGpio(index, [callback](sil::Gpio& gpio) {
+  WithGpio(*handle, index, [callback](sil::Gpio& gpio) {
     if (gpio.direction() != sil::GpioDirection::Output) {
       throw std::runtime_error{
           std::format("Cannot set GPIO edge callback for non-output pin {}",
@@ -376,8 +690,9 @@ extern "C" {
   });
 }
 
-[[maybe_unused]] void Gpio_ClearOutputPinEdgeCallback(std::size_t index) {
-  WithGpio(index, [](sil::Gpio& gpio) {
+[[maybe_unused]] void Gpio_ClearOutputPinEdgeCallback(SystemHandle handle,
+                                                      std::size_t  index) {
+  WithGpio(*handle, index, [](sil::Gpio& gpio) {
     if (gpio.direction() != sil::GpioDirection::Output) {
       throw std::runtime_error{
           std::format("Cannot set GPIO edge callback for non-output pin {}",
@@ -388,8 +703,66 @@ extern "C" {
   });
 }
 
-[[maybe_unused]] std::size_t Uart_GetUartCount() {
-  auto& sys = sil::System::instance();
+[[maybe_unused]] bool Gpio_EnableEdgeCapture(SystemHandle handle,
+                                             std::size_t  index,
+                                             std::size_t  capacity) {
+  return WithGpio(*handle, index, false, [capacity](sil::Gpio& gpio) {
+    gpio.GetEdgeCapture().Enable(capacity);
+    return true;
+  });
+}
+
+[[maybe_unused]] std::size_t Gpio_ReadEdges(SystemHandle handle,
+                                            std::size_t  index,
+                                            uint64_t*    timestamps_us,
+                                            uint8_t*     edges,
+                                            std::size_t  len) {
+  return WithGpio(*handle, index, std::size_t{0},
+                  [timestamps_us, edges, len](sil::Gpio& gpio) {
+                    return gpio.GetEdgeCapture().Read(
+                        std::span{timestamps_us, len}, std::span{edges, len});
+                  });
+}
+
+[[maybe_unused]] std::size_t Gpio_GetEdgeCaptureDropCount(SystemHandle handle,
+                                                          std::size_t  index) {
+  return WithGpio(*handle, index, std::size_t{0}, [](sil::Gpio& gpio) {
+    return gpio.GetEdgeCapture().GetDropCount();
+  });
+}
+
+[[maybe_unused]] bool
+Gpio_AnalyzeWaveform(SystemHandle handle, std::size_t index,
+                     uint64_t glitch_threshold_us, uint64_t jitter_bin_width_us,
+                     uint64_t* jitter_histogram, std::size_t n_jitter_bins,
+                     GpioWaveformAnalysis* result) {
+  return WithGpio(*handle, index, false, [&](sil::Gpio& gpio) {
+    const auto analysis = sil::AnalyzeWaveform(
+        gpio.GetEdgeCapture(),
+        {
+            .glitch_threshold = sil::DurationUs{glitch_threshold_us},
+            .jitter_bin_width = sil::DurationUs{jitter_bin_width_us},
+        },
+        std::span{jitter_histogram, n_jitter_bins});
+
+    *result = {
+        .n_periods         = analysis.n_periods,
+        .n_glitches        = analysis.n_glitches,
+        .mean_frequency_hz = analysis.mean_frequency,
+        .mean_duty_cycle   = analysis.mean_duty_cycle,
+        .min_period_us     = analysis.min_period.count(),
+        .max_period_us     = analysis.max_period.count(),
+        .min_duty_cycle    = analysis.min_duty_cycle,
+        .max_duty_cycle    = analysis.max_duty_cycle,
+        .period_stddev_us  = analysis.period_stddev_us,
+    };
+    return true;
+  });
+}
+
+[[maybe_unused]] std::size_t Uart_GetUartCount(SystemHandle handle) {
+  auto&                    sys = *handle;
+  const sil::System::Scope scope{sys};
 
   try {
     return sys.GetUartCount();
@@ -399,26 +772,31 @@ extern "C" {
   }
 }
 
-[[maybe_unused]] const char* Uart_GetUartName(std::size_t index) {
-  return WithUart<const char*>(
-      index, nullptr, [](auto& uart) { return uart.GetName().c_str(); });
+[[maybe_unused]] const char* Uart_GetUartName(SystemHandle handle,
+                                              std::size_t  index) {
+  return WithUart<const char*>(*handle, index, nullptr, [](auto& uart) {
+    return uart.GetName().c_str();
+  });
 }
 
-[[maybe_unused]] bool Uart_SimulateReceive(std::size_t    index,
+[[maybe_unused]] bool Uart_SimulateReceive(SystemHandle   handle,
+                                           std::size_t    index,
                                            uint64_t       timestamp_us,
                                            const uint8_t* data,
                                            std::size_t    data_len) {
-  return WithUart(index, false, [timestamp_us, data, data_len](auto& uart) {
-    uart.SimulateRx(
-        sil::TimePointUs{timestamp_us},
-        hstd::ReinterpretSpan<std::byte>(std::span{data, data_len}));
-    return true;
-  });
+  return WithUart(
+      *handle, index, false, [timestamp_us, data, data_len](auto& uart) {
+        uart.SimulateRx(
+            sil::TimePointUs{timestamp_us},
+            hstd::ReinterpretSpan<std::byte>(std::span{data, data_len}));
+        return true;
+      });
 }
 
-[[maybe_unused]] bool Uart_SetTransmitCallback(std::size_t          index,
+[[maybe_unused]] bool Uart_SetTransmitCallback(SystemHandle         handle,
+                                               std::size_t          index,
                                                UartTransmitCallback cb) {
-  return WithUart(index, false, [cb](auto& uart) {
+  return WithUart(*handle, index, false, [cb](auto& uart) {
     uart.SetTxCallback([cb](std::span<const std::byte> data) {
       const auto data_u8 = hstd::ReinterpretSpan<uint8_t>(data);
       (*cb)(data_u8.data(), data_u8.size());
@@ -427,8 +805,97 @@ extern "C" {
   });
 }
 
-[[maybe_unused]] std::size_t Spi_GetSpiMasterCount() {
-  auto& sys = sil::System::instance();
+[[maybe_unused]] bool
+Uart_SimulateReceiveBatch(SystemHandle handle, std::size_t index,
+                          const uint64_t* timestamps_us, const uint8_t* data,
+                          const std::size_t* chunk_lens, std::size_t n_chunks) {
+  const auto now = handle->GetScheduler().Now();
+
+  return WithUart(*handle, index, false,
+                  [now, timestamps_us, data, chunk_lens, n_chunks](auto& uart) {
+                    // Validate all chunks first, so that either all or none
+                    // of them are queued
+                    for (std::size_t i = 0; i < n_chunks; ++i) {
+                      if (sil::TimePointUs{timestamps_us[i]} < now) {
+                        throw std::runtime_error{std::format(
+                            "Cannot simulate receive event in the past, "
+                            "chunk {} of the batch is at {} us",
+                            i, timestamps_us[i])};
+                      }
+                    }
+
+                    // Chunks are stored back to back in the data buffer
+                    std::size_t offset = 0;
+                    for (std::size_t i = 0; i < n_chunks; ++i) {
+                      uart.SimulateRx(
+                          sil::TimePointUs{timestamps_us[i]},
+                          hstd::ReinterpretSpan<std::byte>(
+                              std::span{data + offset, chunk_lens[i]}));
+                      offset += chunk_lens[i];
+                    }
+                    return true;
+                  });
+}
+
+[[maybe_unused]] bool Uart_ClearTransmitCallback(SystemHandle handle,
+                                                 std::size_t  index) {
+  return WithUart(*handle, index, false, [](auto& uart) {
+    uart.ClearTxCallback();
+    return true;
+  });
+}
+
+[[maybe_unused]] bool Uart_EnableTxCapture(SystemHandle handle,
+                                           std::size_t  index,
+                                           std::size_t  capacity) {
+  return WithUart(*handle, index, false, [capacity](auto& uart) {
+    uart.GetTxCapture().Enable(capacity);
+    return true;
+  });
+}
+
+[[maybe_unused]] std::size_t Uart_ReadTxCapture(SystemHandle handle,
+                                                std::size_t  index,
+                                                uint8_t*     buf,
+                                                std::size_t  len) {
+  return WithUart(*handle, index, std::size_t{0}, [buf, len](auto& uart) {
+    return uart.GetTxCapture().Read(
+        hstd::ReinterpretSpanMut<std::byte>(std::span{buf, len}));
+  });
+}
+
+[[maybe_unused]] std::size_t Uart_GetTxCaptureDropCount(SystemHandle handle,
+                                                        std::size_t  index) {
+  return WithUart(*handle, index, std::size_t{0}, [](auto& uart) {
+    return uart.GetTxCapture().GetDropCount();
+  });
+}
+
+[[maybe_unused]] bool
+Uart_SetTransmitStartCallback(SystemHandle handle, std::size_t index,
+                              UartTransmitStartCallback cb) {
+  return WithUart(*handle, index, false, [cb](auto& uart) {
+    uart.SetTxStartCallback([cb](sil::TimePointUs            start,
+                                 sil::TimePointUs            end,
+                                 std::span<const std::byte> data) {
+      const auto data_u8 = hstd::ReinterpretSpan<uint8_t>(data);
+      (*cb)(start.count(), end.count(), data_u8.data(), data_u8.size());
+    });
+    return true;
+  });
+}
+
+[[maybe_unused]] bool Uart_ClearTransmitStartCallback(SystemHandle handle,
+                                                      std::size_t  index) {
+  return WithUart(*handle, index, false, [](auto& uart) {
+    uart.ClearTxStartCallback();
+    return true;
+  });
+}
+
+[[maybe_unused]] std::size_t Spi_GetSpiMasterCount(SystemHandle handle) {
+  auto&                    sys = *handle;
+  const sil::System::Scope scope{sys};
 
   try {
     return sys.GetSpiMasterCount();
@@ -438,18 +905,21 @@ extern "C" {
   }
 }
 
-[[maybe_unused]] const char* Spi_GetSpiMasterName(std::size_t index) {
-  return WithSpiMaster<const char*>(index, nullptr, [](auto& spi_master) {
-    return spi_master.GetName().c_str();
-  });
+[[maybe_unused]] const char* Spi_GetSpiMasterName(SystemHandle handle,
+                                                  std::size_t  index) {
+  return WithSpiMaster<const char*>(
+      *handle, index, nullptr,
+      [](auto& spi_master) { return spi_master.GetName().c_str(); });
 }
 
-[[maybe_unused]] bool Spi_SimulateSpiMasterMiso(std::size_t    index,
+[[maybe_unused]] bool Spi_SimulateSpiMasterMiso(SystemHandle   handle,
+                                                std::size_t    index,
                                                 uint64_t       timestamp_us,
                                                 const uint8_t* data,
                                                 std::size_t    data_len) {
   return WithSpiMaster(
-      index, false, [timestamp_us, data, data_len](auto& spi_master) {
+      *handle, index, false,
+      [timestamp_us, data, data_len](auto& spi_master) {
         spi_master.SimulateMisoData(
             sil::TimePointUs{timestamp_us},
             hstd::ReinterpretSpan<std::byte>(std::span{data, data_len}));
@@ -458,25 +928,27 @@ extern "C" {
 }
 
 [[maybe_unused]] bool
-Spi_SetSpiMasterMisoSizeHintCallback(std::size_t             index,
+Spi_SetSpiMasterMisoSizeHintCallback(SystemHandle            handle,
+                                     std::size_t             index,
                                      SpiMisoSizeHintCallback callback) {
-  return WithSpiMaster(index, false, [callback](auto& spi_master) {
+  return WithSpiMaster(*handle, index, false, [callback](auto& spi_master) {
     spi_master.SetMisoSizeHintCallback(callback);
     return true;
   });
 }
 
 [[maybe_unused]] bool
-Spi_ClearSpiMasterMisoSizeHintCallback(std::size_t index) {
-  return WithSpiMaster(index, false, [](auto& spi_master) {
+Spi_ClearSpiMasterMisoSizeHintCallback(SystemHandle handle, std::size_t index) {
+  return WithSpiMaster(*handle, index, false, [](auto& spi_master) {
     spi_master.ClearMisoSizeHintCallback();
     return true;
   });
 }
 
-[[maybe_unused]] bool Spi_SetSpiMasterMosiCallback(std::size_t     index,
+[[maybe_unused]] bool Spi_SetSpiMasterMosiCallback(SystemHandle    handle,
+                                                   std::size_t     index,
                                                    SpiMosiCallback cb) {
-  return WithSpiMaster(index, false, [cb](auto& spi_master) {
+  return WithSpiMaster(*handle, index, false, [cb](auto& spi_master) {
     spi_master.SetMosiCallback([cb](std::span<const std::byte> data) {
       const auto data_u8 = hstd::ReinterpretSpan<uint8_t>(data);
       (*cb)(data_u8.data(), data_u8.size());
@@ -485,8 +957,9 @@ Spi_ClearSpiMasterMisoSizeHintCallback(std::size_t index) {
   });
 }
 
-[[maybe_unused]] bool Spi_ClearSpiMasterMosiCallback(std::size_t index) {
-  return WithSpiMaster(index, false, [](auto& spi_master) {
+[[maybe_unused]] bool Spi_ClearSpiMasterMosiCallback(SystemHandle handle,
+                                                     std::size_t  index) {
+  return WithSpiMaster(*handle, index, false, [](auto& spi_master) {
     spi_master.ClearMosiCallback();
     return true;
   });
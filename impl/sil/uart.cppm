@@ -1,8 +1,10 @@
 module;
 
+#include <algorithm>
 #include <bit>
 #include <chrono>
 #include <cstdint>
+#include <deque>
 #include <format>
 #include <functional>
 #include <memory>
@@ -19,11 +21,72 @@ import hstd;
 import hal.abstract;
 
 import :scheduler;
+import :vcd;
 
 import rtos.concepts;
 
 namespace sil {
 
+/**
+ * Ring buffer that captures transmitted frames, so that the host can drain
+ * them in bulk. Every record consists of a header with the timestamp and the
+ * size of the frame, followed by its data. When the ring is full, the oldest
+ * records are dropped
+ */
+export class TxCapture {
+ public:
+  /** Size of a record header: 64-bit timestamp and 32-bit frame size */
+  static constexpr std::size_t HeaderSize = sizeof(uint64_t) + sizeof(uint32_t);
+
+  /**
+   * Enables capturing, discarding all captured records
+   * @param capacity Capacity of the ring in bytes, 0 disables capturing
+   */
+  void Enable(std::size_t capacity);
+
+  /**
+   * Returns whether capturing is enabled
+   * @return Whether capturing is enabled
+   */
+  [[nodiscard]] bool IsEnabled() const noexcept { return !buf.empty(); }
+
+  /**
+   * Captures a frame
+   * @param timestamp Time at which the transmission of the frame ended
+   * @param data Frame data
+   */
+  void Write(TimePointUs timestamp, std::span<const std::byte> data);
+
+  /**
+   * Moves as many complete records as fit into a buffer, oldest first
+   * @param into Buffer to read into
+   * @return Number of bytes read
+   */
+  std::size_t Read(std::span<std::byte> into);
+
+  /**
+   * Returns the number of frames that were dropped, because the ring was full
+   * or the frame did not fit into the ring at all
+   * @return Number of dropped frames
+   */
+  [[nodiscard]] std::size_t GetDropCount() const noexcept { return n_dropped; }
+
+ private:
+  void CopyIn(std::span<const std::byte> data);
+  void CopyOut(std::size_t pos, std::span<std::byte> into) const;
+
+  /**
+   * Returns the size of the record at the read position, including its header
+   * @return Record size
+   */
+  [[nodiscard]] std::size_t OldestRecordSize() const;
+
+  std::vector<std::byte> buf{};
+  std::size_t            read_pos{0};    //!< Monotonic read position
+  std::size_t            write_pos{0};   //!< Monotonic write position
+  std::size_t            n_dropped{0};
+};
+
 export class Uart;
 
 export class Uart : public ::hal::UsedPeripheral {
@@ -31,6 +94,12 @@ export class Uart : public ::hal::UsedPeripheral {
   Uart()          = default;
   virtual ~Uart() = default;
 
+  /**
+   * Returns the capture ring of transmitted frames
+   * @return TX capture ring
+   */
+  TxCapture& GetTxCapture() & noexcept { return tx_capture; }
+
   /**
    * Returns the name of the UART
    * @return Name of the UART
@@ -56,6 +125,36 @@ export class Uart : public ::hal::UsedPeripheral {
    * Clears the UART transmit callback
    */
   virtual void ClearTxCallback() = 0;
+
+  /**
+   * Sets the UART transmit start callback, which is invoked when a
+   * transmission starts, with the start and end time of the transmission.
+   * Allows shared media to know about a frame before it completes
+   * @param callback Callback to be invoked upon the start of a transmission
+   */
+  virtual void SetTxStartCallback(
+      std::function<void(TimePointUs, TimePointUs, std::span<const std::byte>)>
+          callback) = 0;
+
+  /**
+   * Clears the UART transmit start callback
+   */
+  virtual void ClearTxStartCallback() = 0;
+
+  /**
+   * Starts recording the transmitted and received bytes, by declaring a scope
+   * with the UART in a VCD writer
+   * @param writer VCD writer, which must outlive the recording
+   */
+  virtual void AttachVcd(VcdWriter& writer) = 0;
+
+  /**
+   * Stops recording the transmitted and received bytes
+   */
+  virtual void DetachVcd() noexcept = 0;
+
+ protected:
+  TxCapture tx_capture{};   //!< Capture of transmitted frames
 };
 
 export template <rtos::concepts::Rtos OS>
@@ -102,19 +201,30 @@ class RtosUart final : public Uart {
     pending_tx_buf.resize(data.size());
     std::ranges::copy(data, pending_tx_buf.begin());
 
-    tx_evt.RegisterPendingAction(sched.Now() + TransmissionTime(data.size()),
-                                 [this] {
-                                   // Invoke callback
-                                   if (tx_callback.has_value()) {
-                                     (*tx_callback)(pending_tx_buf);
-                                   }
-
-                                   // Set transmitted bit
-                                   auto& [eg, bitmask] = tx_event_group;
-                                   if (eg != nullptr) {
-                                     eg->SetBitsFromInterrupt(bitmask);
-                                   }
-                                 });
+    const auto tx_start = sched.Now();
+    const auto tx_end   = tx_start + TransmissionTime(data.size());
+    if (tx_start_callback.has_value()) {
+      (*tx_start_callback)(tx_start, tx_end, pending_tx_buf);
+    }
+    if (vcd != nullptr) {
+      vcd->ChangeFrame(vcd_tx, tx_start, tx_end,
+                       std::span<const std::byte>{pending_tx_buf});
+    }
+
+    tx_evt.RegisterPendingAction(tx_end, [this, tx_end] {
+      tx_capture.Write(tx_end, pending_tx_buf);
+
+      // Invoke callback
+      if (tx_callback.has_value()) {
+        (*tx_callback)(pending_tx_buf);
+      }
+
+      // Set transmitted bit
+      auto& [eg, bitmask] = tx_event_group;
+      if (eg != nullptr) {
+        eg->SetBitsFromInterrupt(bitmask);
+      }
+    });
   }
 
   std::optional<std::span<std::byte>> Receive(std::span<std::byte> into,
@@ -122,20 +232,36 @@ class RtosUart final : public Uart {
     Receive(into, event_group, RxDoneBit);
 
     if (event_group.Wait(RxDoneBit, timeout).has_value()) {
-      return rx_buf;
+      return rx_received;
     }
 
+    // The buffer must not be written after the call returns
+    rx_buf.reset();
     return {};
   }
 
+  /**
+   * Receives the next chunk into a buffer. Every call receives a single chunk,
+   * chunks that are due before the next call are held until then
+   * @param into Buffer to receive into
+   * @param event_group Event group to notify once the chunk was received
+   * @param bitmask Bits to set in the event group
+   */
   void Receive(std::span<std::byte> into, typename OS::EventGroup& event_group,
                uint32_t bitmask) {
     rx_buf         = into;
     rx_event_group = std::make_tuple(&event_group, bitmask);
+
+    // A held chunk is delivered right away
+    if (!rx_evt.HasPendingAction()) {
+      ScheduleNextRx();
+    }
   }
 
   /**
-   * Simulates a receive on the UART at a given timestamp
+   * Simulates a receive on the UART at a given timestamp. Any number of
+   * receives can be queued, receives with equal timestamps happen in the order
+   * in which they were simulated
    * @param timestamp Timestamp at which the receive should happen
    * @param rx_data Data to receive
    */
@@ -145,28 +271,27 @@ class RtosUart final : public Uart {
       throw std::runtime_error{"Cannot simulate receive event in the past"};
     }
 
-    if (rx_evt.HasPendingAction()) {
-      throw std::runtime_error{std::format(
-          "A simulated RX on UART {} is still pending, cannot add new event",
-          name)};
+    // The bytes arrive on the line before the receive completes, but not
+    // before now
+    if (vcd != nullptr) {
+      const auto duration = std::min(TransmissionTime(rx_data.size()),
+                                     timestamp - sched.Now());
+      vcd->ChangeFrame(vcd_rx, timestamp - duration, timestamp, rx_data);
     }
 
-    pending_rx_buf.resize(rx_data.size());
-    std::ranges::copy(rx_data, pending_rx_buf.begin());
-
-    rx_evt.RegisterPendingAction(timestamp, [this] {
-      if (rx_buf.has_value()) {
-        const auto size = std::min(rx_buf->size(), pending_rx_buf.size());
-        std::ranges::copy(std::span{pending_rx_buf}.subspan(0, size),
-                          rx_buf->begin());
-        rx_buf = rx_buf->subspan(0, size);
-      }
-
-      auto& [eg, bitmask] = rx_event_group;
-      if (eg != nullptr) {
-        eg->SetBitsFromInterrupt(bitmask);
-      }
-    });
+    const auto it = std::ranges::upper_bound(rx_queue, timestamp, {},
+                                             &RxChunk::timestamp);
+    const auto is_next = it == rx_queue.begin();
+    rx_queue.insert(it, RxChunk{
+                            .timestamp = timestamp,
+                            .data      = {rx_data.begin(), rx_data.end()},
+                        });
+
+    // The external event always handles the first chunk of the queue
+    if (is_next) {
+      rx_evt.ClearPendingAction();
+      ScheduleNextRx();
+    }
   }
 
   /**
@@ -183,9 +308,77 @@ class RtosUart final : public Uart {
    */
   void ClearTxCallback() final { tx_callback = {}; }
 
+  /**
+   * Sets the UART transmit start callback
+   * @param callback Callback to be invoked upon the start of a transmission
+   */
+  void SetTxStartCallback(
+      std::function<void(TimePointUs, TimePointUs, std::span<const std::byte>)>
+          callback) final {
+    tx_start_callback = callback;
+  }
+
+  /**
+   * Clears the UART transmit start callback
+   */
+  void ClearTxStartCallback() final { tx_start_callback = {}; }
+
+  void AttachVcd(VcdWriter& writer) final {
+    writer.BeginScope(name);
+    vcd_tx = writer.AddVar("tx", 8);
+    vcd_rx = writer.AddVar("rx", 8);
+    writer.EndScope();
+    vcd = &writer;
+  }
+
+  void DetachVcd() noexcept final { vcd = nullptr; }
+
   const std::string& GetName() const& final { return name; }
 
  private:
+  /** Simulated receive that is yet to happen */
+  struct RxChunk {
+    TimePointUs            timestamp;
+    std::vector<std::byte> data;
+  };
+
+  /**
+   * Registers the receive of the first chunk in the queue. The chunk is held
+   * in the queue while no receive buffer is armed, and is received once the
+   * next receive arms one, but not before its timestamp
+   */
+  void ScheduleNextRx() {
+    if (rx_queue.empty() || !rx_buf.has_value()) {
+      return;
+    }
+
+    const auto timestamp = std::max(rx_queue.front().timestamp, sched.Now());
+    rx_evt.RegisterPendingAction(timestamp, [this] {
+      // The receive timed out in the meantime
+      if (!rx_buf.has_value()) {
+        return;
+      }
+
+      const auto chunk = std::move(rx_queue.front());
+      rx_queue.pop_front();
+
+      // Every receive consumes its buffer, so that the next chunk does not
+      // overwrite this one
+      const auto size = std::min(rx_buf->size(), chunk.data.size());
+      std::ranges::copy(std::span{chunk.data}.subspan(0, size),
+                        rx_buf->begin());
+      rx_received = rx_buf->subspan(0, size);
+      rx_buf.reset();
+
+      auto& [eg, bitmask] = rx_event_group;
+      if (eg != nullptr) {
+        eg->SetBitsFromInterrupt(bitmask);
+      }
+
+      ScheduleNextRx();
+    });
+  }
+
   /**
    * Calculates the approximate transmission time for a given amount of bytes
    * @param n_bytes Amount of bytes to get the transmission time for
@@ -231,11 +424,19 @@ class RtosUart final : public Uart {
   std::tuple<typename OS::EventGroup*, uint32_t> tx_event_group{};
   std::tuple<typename OS::EventGroup*, uint32_t> rx_event_group{};
 
-  std::vector<std::byte>              pending_rx_buf{};
+  std::deque<RxChunk>                 rx_queue{};
   std::vector<std::byte>              pending_tx_buf{};
-  std::optional<std::span<std::byte>> rx_buf{};
+  std::optional<std::span<std::byte>> rx_buf{};        //!< Armed buffer
+  std::span<std::byte>                rx_received{};   //!< Last receive
 
   std::optional<std::function<void(std::span<const std::byte>)>> tx_callback;
+  std::optional<std::function<void(TimePointUs, TimePointUs,
+                                   std::span<const std::byte>)>>
+      tx_start_callback;
+
+  VcdWriter*       vcd{nullptr};   //!< Recording VCD writer, if any
+  VcdWriter::VarId vcd_tx{0};      //!< Transmitted bytes in the VCD
+  VcdWriter::VarId vcd_rx{0};      //!< Received bytes in the VCD
 };
 
 }   // namespace sil
@@ -0,0 +1,97 @@
+module;
+
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <limits>
+#include <span>
+#include <vector>
+
+module hal.sil;
+
+namespace sil {
+
+void TxCapture::Enable(std::size_t capacity) {
+  buf.assign(capacity, std::byte{0});
+  read_pos  = 0;
+  write_pos = 0;
+  n_dropped = 0;
+}
+
+void TxCapture::Write(TimePointUs timestamp, std::span<const std::byte> data) {
+  if (!IsEnabled()) {
+    return;
+  }
+
+  const auto record_size = HeaderSize + data.size();
+  if (record_size > buf.size()
+      || data.size() > std::numeric_limits<uint32_t>::max()) {
+    n_dropped++;
+    return;
+  }
+
+  // Make room by dropping the oldest records
+  while (buf.size() - (write_pos - read_pos) < record_size) {
+    read_pos += OldestRecordSize();
+    n_dropped++;
+  }
+
+  std::array<std::byte, HeaderSize> header{};
+  const uint64_t                    timestamp_us = timestamp.count();
+  const auto                        size = static_cast<uint32_t>(data.size());
+  std::memcpy(header.data(), &timestamp_us, sizeof(timestamp_us));
+  std::memcpy(header.data() + sizeof(timestamp_us), &size, sizeof(size));
+
+  CopyIn(header);
+  CopyIn(data);
+}
+
+std::size_t TxCapture::Read(std::span<std::byte> into) {
+  std::size_t n_read = 0;
+
+  while (read_pos != write_pos) {
+    const auto record_size = OldestRecordSize();
+    if (record_size > into.size() - n_read) {
+      break;
+    }
+
+    CopyOut(read_pos, into.subspan(n_read, record_size));
+    read_pos += record_size;
+    n_read += record_size;
+  }
+
+  return n_read;
+}
+
+void TxCapture::CopyIn(std::span<const std::byte> data) {
+  const auto offset = write_pos % buf.size();
+  const auto first  = std::min(data.size(), buf.size() - offset);
+
+  std::ranges::copy(data.subspan(0, first),
+                    buf.begin() + static_cast<std::ptrdiff_t>(offset));
+  std::ranges::copy(data.subspan(first), buf.begin());
+  write_pos += data.size();
+}
+
+void TxCapture::CopyOut(std::size_t pos, std::span<std::byte> into) const {
+  const auto offset = pos % buf.size();
+  const auto first  = std::min(into.size(), buf.size() - offset);
+
+  std::copy_n(buf.begin() + static_cast<std::ptrdiff_t>(offset), first,
+              into.begin());
+  std::copy_n(buf.begin(), into.size() - first,
+              into.begin() + static_cast<std::ptrdiff_t>(first));
+}
+
+std::size_t TxCapture::OldestRecordSize() const {
+  std::array<std::byte, HeaderSize> header{};
+  CopyOut(read_pos, header);
+
+  uint32_t size = 0;
+  std::memcpy(&size, header.data() + sizeof(uint64_t), sizeof(size));
+  return HeaderSize + size;
+}
+
+}   // namespace sil
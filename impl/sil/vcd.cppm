@@ -0,0 +1,179 @@
+module;
+
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <functional>
+#include <optional>
+#include <queue>
+#include <span>
+#include <string>
+#include <string_view>
+#include <type_traits>
+#include <vector>
+
+export module hal.sil:vcd;
+
+import :scheduler;
+
+namespace sil {
+
+/**
+ * Streams the value changes of simulated signals to a value change dump (VCD)
+ * file, keyed on the simulated time. Changes are formatted into a buffer of
+ * fixed size, which is written to the file whenever it is full, so the memory
+ * use does not grow with the length of the simulation.
+ *
+ * Changes can be recorded ahead of the simulated time, e.g. the bytes of a
+ * frame that starts transmitting. They are held back until the scheduler
+ * reaches them, so that the file stays ordered by time
+ */
+export class VcdWriter {
+ public:
+  /** Identifier of a variable */
+  using VarId = uint32_t;
+
+  /** Default size of the write buffer in bytes */
+  static constexpr std::size_t DefaultBufferSize = 64 * 1024;
+
+  /**
+   * Constructor. Opens the file, after which the variables can be declared
+   * @param sched Scheduler that provides the simulated time
+   * @param path Path of the file to write
+   * @param buffer_size Size of the write buffer in bytes
+   */
+  VcdWriter(const Scheduler& sched, const std::string& path,
+            std::size_t buffer_size = DefaultBufferSize);
+
+  VcdWriter(const VcdWriter&)            = delete;
+  VcdWriter& operator=(const VcdWriter&) = delete;
+
+  /**
+   * Destructor. Writes all held back changes and closes the file, if it was
+   * not closed yet
+   */
+  ~VcdWriter();
+
+  /**
+   * Opens a scope, in which the following variables are declared
+   * @param name Scope name
+   */
+  void BeginScope(std::string_view name);
+
+  /**
+   * Closes the innermost scope
+   */
+  void EndScope();
+
+  /**
+   * Declares a variable. Must be called before the definitions end
+   * @param name Variable name
+   * @param width Width of the variable in bits, at most 64
+   * @param initial Initial value, or nullopt if the variable is idle
+   * @return Variable identifier
+   */
+  VarId AddVar(std::string_view name, unsigned width,
+               std::optional<uint64_t> initial = std::nullopt);
+
+  /**
+   * Ends the declarations, and dumps the initial values of all variables at
+   * the current simulated time
+   */
+  void EndDefinitions();
+
+  /**
+   * Records a change of a variable at the current simulated time
+   * @param var Variable identifier
+   * @param value New value
+   */
+  void Change(VarId var, uint64_t value) { Change(var, sched.Now(), value); }
+
+  /**
+   * Records a change of a variable at or after the current simulated time
+   * @param var Variable identifier
+   * @param time Time of the change
+   * @param value New value, or nullopt if the variable becomes idle. Idle
+   * variables are dumped as high impedance
+   */
+  void Change(VarId var, TimePointUs time, std::optional<uint64_t> value);
+
+  /**
+   * Records a frame of values that are spread evenly over a time span, after
+   * which the variable becomes idle
+   * @param var Variable identifier
+   * @param start Time of the first value, at or after the current time
+   * @param end Time at which the variable becomes idle
+   * @param values Frame values
+   */
+  template <typename T>
+    requires std::is_integral_v<T> || std::is_same_v<T, std::byte>
+  void ChangeFrame(VarId var, TimePointUs start, TimePointUs end,
+                   std::span<const T> values) {
+    const auto n = values.size();
+    for (std::size_t i = 0; i < n; ++i) {
+      Change(var, start + (end - start) * i / n,
+             static_cast<uint64_t>(values[i]));
+    }
+    Change(var, end, std::nullopt);
+  }
+
+  /**
+   * Writes all held back changes and closes the file
+   */
+  void Close();
+
+ private:
+  /** Change that is held back until the scheduler reaches it */
+  struct PendingChange {
+    TimePointUs             time;
+    uint64_t                seq;   //!< Order among equal times
+    VarId                   var;
+    std::optional<uint64_t> value;
+
+    bool operator>(const PendingChange& other) const noexcept {
+      return time > other.time || (time == other.time && seq > other.seq);
+    }
+  };
+
+  struct Var {
+    std::string             code;    //!< Identifier code in the file
+    unsigned                width;   //!< Width in bits
+    std::optional<uint64_t> value;   //!< Last dumped value
+  };
+
+  /**
+   * Writes all held back changes up to a time point
+   * @param time Time up to which to write
+   */
+  void WritePending(TimePointUs time);
+
+  void WriteChange(TimePointUs time, VarId var, std::optional<uint64_t> value);
+  void WriteValue(const Var& var);
+  void WriteTime(TimePointUs time);
+  void Append(std::string_view str);
+  void Flush();
+
+  /**
+   * Writes all held back changes, marks the end of the dump and closes the
+   * file. Errors while writing set the write failure flag
+   * @param end Time of the end of the dump
+   */
+  void Finish(TimePointUs end) noexcept;
+
+  const Scheduler& sched;
+  std::FILE*       file;
+  bool             definitions_ended{false};
+  bool             write_failed{false};
+
+  std::vector<char>          buf{};
+  std::size_t                buffer_size;
+  std::vector<Var>           vars{};
+  std::optional<TimePointUs> last_time{};   //!< Time that was dumped last
+
+  std::priority_queue<PendingChange, std::vector<PendingChange>,
+                      std::greater<>>
+           pending{};
+  uint64_t next_seq{0};   //!< Sequence number of the next held back change
+};
+
+}   // namespace sil
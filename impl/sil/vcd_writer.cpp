@@ -0,0 +1,277 @@
+module;
+
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <charconv>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <format>
+#include <limits>
+#include <optional>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+
+module hal.sil;
+
+namespace sil {
+
+namespace {
+
+/** Number of printable characters that make up identifier codes */
+constexpr std::size_t IdCodeBase = '~' - '!' + 1;
+
+/**
+ * Returns the shortest identifier code of a variable
+ * @param index Index of the variable
+ * @return Identifier code
+ */
+std::string IdCode(std::size_t index) {
+  std::string code{};
+  do {
+    code.push_back(static_cast<char>('!' + index % IdCodeBase));
+    index /= IdCodeBase;
+  } while (index > 0);
+  return code;
+}
+
+/**
+ * Returns a name that is a single token in the file
+ * @param name Name
+ * @return Name without whitespace
+ */
+std::string Sanitize(std::string_view name) {
+  std::string result{name};
+  std::ranges::replace_if(
+      result, [](char c) { return c == ' ' || c == '\t' || c == '\n'; }, '_');
+  return result.empty() ? std::string{"_"} : result;
+}
+
+}   // namespace
+
+VcdWriter::VcdWriter(const Scheduler& sched, const std::string& path,
+                     std::size_t buffer_size)
+    : sched{sched}
+    , file{std::fopen(path.c_str(), "wb")}
+    , buffer_size{buffer_size} {
+  if (file == nullptr) {
+    throw std::runtime_error{
+        std::format("Unable to open VCD file '{}' for writing", path)};
+  }
+
+  // All output is buffered here already
+  std::setvbuf(file, nullptr, _IONBF, 0);
+  buf.reserve(buffer_size);
+
+  Append("$version hal.sil $end\n$timescale 1us $end\n");
+}
+
+VcdWriter::~VcdWriter() {
+  if (file != nullptr) {
+    Finish(last_time.value_or(TimePointUs{0}));
+  }
+}
+
+void VcdWriter::BeginScope(std::string_view name) {
+  Append(std::format("$scope module {} $end\n", Sanitize(name)));
+}
+
+void VcdWriter::EndScope() {
+  Append("$upscope $end\n");
+}
+
+VcdWriter::VarId VcdWriter::AddVar(std::string_view name, unsigned width,
+                                   std::optional<uint64_t> initial) {
+  if (definitions_ended) {
+    throw std::runtime_error{
+        "VCD variables must be declared before the definitions end"};
+  }
+  if (width == 0 || width > std::numeric_limits<uint64_t>::digits) {
+    throw std::runtime_error{
+        std::format("Invalid width {} of VCD variable {}", width, name)};
+  }
+
+  const auto  id  = static_cast<VarId>(vars.size());
+  const auto& var = vars.emplace_back(Var{
+      .code  = IdCode(id),
+      .width = width,
+      .value = initial,
+  });
+
+  Append(std::format("$var wire {} {} {} $end\n", width, var.code,
+                     Sanitize(name)));
+  return id;
+}
+
+void VcdWriter::EndDefinitions() {
+  Append("$enddefinitions $end\n");
+
+  WriteTime(sched.Now());
+  Append("$dumpvars\n");
+  for (const auto& var : vars) {
+    WriteValue(var);
+  }
+  Append("$end\n");
+
+  definitions_ended = true;
+}
+
+void VcdWriter::Change(VarId var, TimePointUs time,
+                       std::optional<uint64_t> value) {
+  if (file == nullptr || !definitions_ended) {
+    return;
+  }
+
+  const auto now = sched.Now();
+  if (time < now) {
+    throw std::runtime_error{"Cannot record a VCD change in the past"};
+  }
+
+  // Nothing is recorded before the current time anymore, so all held back
+  // changes up to now are final
+  WritePending(now);
+
+  if (time == now) {
+    WriteChange(time, var, value);
+  } else {
+    pending.push({
+        .time  = time,
+        .seq   = next_seq++,
+        .var   = var,
+        .value = value,
+    });
+  }
+}
+
+void VcdWriter::Close() {
+  if (file == nullptr) {
+    return;
+  }
+
+  Finish(sched.Now());
+
+  if (write_failed) {
+    throw std::runtime_error{"Unable to write the VCD file"};
+  }
+}
+
+void VcdWriter::WritePending(TimePointUs time) {
+  while (!pending.empty() && pending.top().time <= time) {
+    const auto change = pending.top();
+    pending.pop();
+    WriteChange(change.time, change.var, change.value);
+  }
+}
+
+void VcdWriter::WriteChange(TimePointUs time, VarId var,
+                            std::optional<uint64_t> value) {
+  auto& v = vars.at(var);
+  if (v.value == value) {
+    return;
+  }
+
+  v.value = value;
+  WriteTime(time);
+  WriteValue(v);
+}
+
+void VcdWriter::WriteValue(const Var& var) {
+  // Binary digits, prefix, separator and newline
+  std::array<char, std::numeric_limits<uint64_t>::digits + 3> str{};
+  std::size_t                                                 len = 0;
+
+  if (var.width == 1) {
+    str[len++] = var.value.has_value() ? ((*var.value & 1U) ? '1' : '0') : 'z';
+  } else {
+    str[len++] = 'b';
+
+    if (!var.value.has_value()) {
+      str[len++] = 'z';
+    } else {
+      // Leading zeros are implied
+      const auto value =
+          *var.value
+          & (std::numeric_limits<uint64_t>::max()
+             >> (std::numeric_limits<uint64_t>::digits - var.width));
+      const auto n_digits =
+          std::max(1, static_cast<int>(std::bit_width(value)));
+      for (auto i = n_digits; i > 0; --i) {
+        str[len++] = ((value >> (i - 1)) & 1U) ? '1' : '0';
+      }
+    }
+
+    str[len++] = ' ';
+  }
+
+  Append({str.data(), len});
+  Append(var.code);
+  Append("\n");
+}
+
+void VcdWriter::WriteTime(TimePointUs time) {
+  if (last_time == time) {
+    return;
+  }
+
+  std::array<char, std::numeric_limits<uint64_t>::digits10 + 3> str{'#'};
+  const auto [end, ec] =
+      std::to_chars(str.data() + 1, str.data() + str.size() - 1, time.count());
+  *end = '\n';
+
+  Append({str.data(), static_cast<std::size_t>(end - str.data() + 1)});
+  last_time = time;
+}
+
+void VcdWriter::Append(std::string_view str) {
+  if (buf.size() + str.size() > buffer_size) {
+    Flush();
+  }
+
+  // Data that does not fit into the buffer at all is written directly
+  if (str.size() > buffer_size) {
+    if (std::fwrite(str.data(), 1, str.size(), file) != str.size()) {
+      write_failed = true;
+    }
+    return;
+  }
+
+  buf.insert(buf.end(), str.begin(), str.end());
+}
+
+void VcdWriter::Flush() {
+  if (buf.empty()) {
+    return;
+  }
+
+  if (std::fwrite(buf.data(), 1, buf.size(), file) != buf.size()) {
+    write_failed = true;
+  }
+  buf.clear();
+}
+
+void VcdWriter::Finish(TimePointUs end) noexcept {
+  // The file is closed in any case, a failure to write the remaining changes
+  // is reported as a write failure
+  try {
+    if (definitions_ended) {
+      WritePending(TimePointUs::max());
+
+      // Mark the end, so that viewers show how long the last values lasted
+      if (!last_time.has_value() || end > *last_time) {
+        WriteTime(end);
+      }
+    }
+  } catch (...) {
+    write_failed = true;
+  }
+
+  Flush();
+  if (std::fclose(file) != 0) {
+    write_failed = true;
+  }
+  file = nullptr;
+}
+
+}   // namespace sil
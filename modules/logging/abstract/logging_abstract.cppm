@@ -1,5 +1,6 @@
 module;
 
+#include <concepts>
 #include <cstdint>
 #include <memory>
 #include <span>
@@ -24,6 +25,12 @@ export enum class Level : uint8_t {
   Fatal = 60,
 };
 
+/** @brief Edge of a trace span. */
+export enum class SpanEdge : uint8_t {
+  Begin,
+  End,
+};
+
 template <typename T>
 struct MsgArgTypeHelper;
 
@@ -89,6 +96,43 @@ concept Encoding = requires {
         std::declval<std::span<std::byte>>()   // Destination buffer
     )
   };
+  {
+    std::integral_constant<std::size_t,
+                           std::decay_t<E>::template EncodedSize<ExampleModule, ArgsMessage>()>{}
+  };
+};
+
+/**
+ * @brief Concept for an encoding that can report suppressed repetitions of a message in a single
+ * record, as required by rate limiting.
+ */
+export template <typename E>
+concept RepeatEncoding = Encoding<E> && requires {
+  std::integral_constant<std::size_t, std::decay_t<E>::RepeatedSize>{};
+  {
+    std::decay_t<E>::template EncodeRepeated<ExampleModule, ArgsMessage>(
+        std::declval<uint32_t>(),              // Timestamp
+        std::declval<Level>(),                 // Log level
+        std::declval<uint32_t>(),              // Number of repetitions
+        std::declval<std::span<std::byte>>()   // Destination buffer
+    )
+  };
+};
+
+/**
+ * @brief Concept for an encoding that can encode the begin and end records of trace spans.
+ */
+export template <typename E>
+concept SpanEncoding = Encoding<E> && requires {
+  std::integral_constant<std::size_t, std::decay_t<E>::SpanSize>{};
+  {
+    std::decay_t<E>::template EncodeSpan<ExampleModule, ArgsMessage>(
+        std::declval<uint32_t>(),              // Timestamp
+        std::declval<SpanEdge>(),              // Span edge
+        std::declval<uint32_t>(),              // Cycle counter
+        std::declval<std::span<std::byte>>()   // Destination buffer
+    )
+  };
 };
 
 export template <typename S>
@@ -96,6 +140,18 @@ concept Sink = requires(S& sink) {
   { sink.Write(std::span<const std::byte>()) };
 };
 
+/**
+ * @brief Concept for a sink that allows encoding directly into sink-owned memory. \c Reserve
+ * returns a buffer of at least the requested size, or an empty span if no space is available.
+ * \c Commit marks the first \c n bytes of the last reserved buffer as written. Every non-empty
+ * reservation must be committed, as the sink may hold a lock on its buffer in between.
+ */
+export template <typename S>
+concept ReservingSink = Sink<S> && requires(S& sink, std::size_t n) {
+  { sink.Reserve(n) } -> std::convertible_to<std::span<std::byte>>;
+  { sink.Commit(n) };
+};
+
 template <typename T>
 inline constexpr bool IsMessage = false;
 
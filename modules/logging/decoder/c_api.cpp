@@ -0,0 +1,171 @@
+#include <cstdint>
+#include <deque>
+#include <exception>
+#include <format>
+#include <span>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+import logging.abstract;
+import logging.decoder;
+
+namespace {
+
+/** @brief Decoded and formatted record, owning its strings. */
+struct OwnedRecord {
+  uint32_t    timestamp;
+  uint8_t     level;
+  uint16_t    module_id;
+  uint8_t     message_id;
+  std::string module_name;
+  std::string message;
+};
+
+/** @brief Last error that occurred in the C API, for reporting to the caller. */
+thread_local std::string last_error{};
+
+std::string_view FormatErrorMessage(logging::decoder::FormatError err) {
+  using enum logging::decoder::FormatError;
+
+  switch (err) {
+  case UnknownModule: return "unknown module";
+  case UnknownMessage: return "unknown message";
+  case PayloadSizeMismatch: return "payload size does not match the specification";
+  }
+
+  return "unknown error";
+}
+
+}   // namespace
+
+/** @brief Opaque decoder handle. */
+struct LogDecoder {
+  explicit LogDecoder(logging::decoder::Spec spec_in)
+      : spec{std::move(spec_in)}
+      , formatter{spec} {}
+
+  logging::decoder::Spec          spec;
+  logging::decoder::Formatter     formatter;
+  logging::decoder::StreamDecoder decoder{};
+  logging::decoder::Filter        filter{};
+
+  std::deque<OwnedRecord> records{};
+  OwnedRecord             current{};
+};
+
+/** @brief Record as returned through the C API. Strings remain valid until the next call. */
+struct LogDecoderRecord {
+  uint32_t    timestamp;
+  uint8_t     level;
+  uint16_t    module_id;
+  uint8_t     message_id;
+  const char* module_name;
+  const char* message;
+};
+
+/** @brief Decoder statistics as returned through the C API. */
+struct LogDecoderStatistics {
+  uint64_t frames_decoded;
+  uint64_t frames_filtered;
+  uint64_t crc_errors;
+  uint64_t bytes_skipped;
+};
+
+extern "C" {
+
+[[maybe_unused]] const char* LogDecoder_GetLastError() {
+  return last_error.c_str();
+}
+
+[[maybe_unused]] LogDecoder* LogDecoder_Create(const char* spec_json) {
+  try {
+    return new LogDecoder{logging::decoder::Spec::FromString(spec_json)};
+  } catch (const std::exception& e) {
+    last_error = e.what();
+    return nullptr;
+  }
+}
+
+[[maybe_unused]] void LogDecoder_Destroy(LogDecoder* decoder) {
+  delete decoder;
+}
+
+[[maybe_unused]] void LogDecoder_SetValueWrap(LogDecoder* decoder, const char* prefix,
+                                              const char* suffix) {
+  decoder->formatter.SetOptions({.value_prefix = prefix, .value_suffix = suffix});
+}
+
+[[maybe_unused]] void LogDecoder_SetMinLevel(LogDecoder* decoder, uint8_t level) {
+  decoder->filter.SetMinLevel(static_cast<logging::Level>(level));
+  decoder->decoder.SetFilter(decoder->filter);
+}
+
+[[maybe_unused]] void LogDecoder_SetModuleFilter(LogDecoder* decoder, const uint16_t* module_ids,
+                                                 std::size_t n_module_ids) {
+  decoder->filter.SetModules(std::span{module_ids, n_module_ids});
+  decoder->decoder.SetFilter(decoder->filter);
+}
+
+[[maybe_unused]] std::size_t LogDecoder_Feed(LogDecoder* decoder, const uint8_t* data,
+                                             std::size_t data_len) {
+  const auto bytes = std::as_bytes(std::span{data, data_len});
+
+  decoder->decoder.Feed(bytes, [decoder](const logging::decoder::Frame& frame) {
+    OwnedRecord record{
+        .timestamp   = frame.timestamp,
+        .level       = std::to_underlying(frame.level),
+        .module_id   = frame.module_id,
+        .message_id  = frame.message_id,
+        .module_name = {},
+        .message     = {},
+    };
+
+    if (const auto name = decoder->formatter.ModuleName(frame); name.has_value()) {
+      record.module_name = *name;
+    } else {
+      record.module_name = std::format("{:#06x}", frame.module_id);
+    }
+
+    if (const auto res = decoder->formatter.FormatInto(frame, record.message); !res.has_value()) {
+      record.message = std::format("<failed to decode message {}: {}>", frame.message_id,
+                                   FormatErrorMessage(res.error()));
+    }
+
+    decoder->records.push_back(std::move(record));
+  });
+
+  return decoder->records.size();
+}
+
+[[maybe_unused]] bool LogDecoder_NextRecord(LogDecoder* decoder, LogDecoderRecord* out) {
+  if (decoder->records.empty()) {
+    return false;
+  }
+
+  decoder->current = std::move(decoder->records.front());
+  decoder->records.pop_front();
+
+  *out = LogDecoderRecord{
+      .timestamp   = decoder->current.timestamp,
+      .level       = decoder->current.level,
+      .module_id   = decoder->current.module_id,
+      .message_id  = decoder->current.message_id,
+      .module_name = decoder->current.module_name.c_str(),
+      .message     = decoder->current.message.c_str(),
+  };
+  return true;
+}
+
+[[maybe_unused]] void LogDecoder_GetStatistics(const LogDecoder*     decoder,
+                                               LogDecoderStatistics* out) {
+  const auto& stats = decoder->decoder.Statistics();
+  *out              = LogDecoderStatistics{
+                   .frames_decoded  = stats.frames_decoded,
+                   .frames_filtered = stats.frames_filtered,
+                   .crc_errors      = stats.crc_errors,
+                   .bytes_skipped   = stats.bytes_skipped,
+  };
+}
+}
@@ -0,0 +1,284 @@
+#include <algorithm>
+#include <atomic>
+#include <cctype>
+#include <charconv>
+#include <csignal>
+#include <cstdint>
+#include <cstdio>
+#include <exception>
+#include <format>
+#include <fstream>
+#include <iostream>
+#include <iterator>
+#include <optional>
+#include <span>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include <fcntl.h>
+#include <termios.h>
+#include <unistd.h>
+
+#include <argparse/argparse.hpp>
+
+import logging.abstract;
+import logging.decoder;
+
+namespace {
+
+std::atomic<bool> stop_requested{false};
+
+void HandleSignal(int) {
+  stop_requested.store(true);
+}
+
+/**
+ * @brief Maps a numeric baud rate to its termios speed constant.
+ * @param baud Baud rate.
+ * @return termios speed.
+ */
+speed_t BaudToSpeed(unsigned baud) {
+  switch (baud) {
+  case 9'600: return B9600;
+  case 19'200: return B19200;
+  case 38'400: return B38400;
+  case 57'600: return B57600;
+  case 115'200: return B115200;
+  case 230'400: return B230400;
+#ifdef B460800
+  case 460'800: return B460800;
+#endif
+#ifdef B921600
+  case 921'600: return B921600;
+#endif
+  default: throw std::runtime_error{std::format("Unsupported baud rate {}", baud)};
+  }
+}
+
+/** @brief Raw byte source, either a serial port or a previously captured file. */
+class Source {
+ public:
+  Source(const Source&)            = delete;
+  Source& operator=(const Source&) = delete;
+
+  ~Source() {
+    if (fd >= 0) {
+      close(fd);
+    }
+  }
+
+  /**
+   * @brief Opens a serial port in raw mode.
+   * @param port Serial port path.
+   * @param baud Baud rate.
+   * @return Opened source.
+   */
+  static Source OpenSerial(const std::string& port, unsigned baud) {
+    const int fd = open(port.c_str(), O_RDONLY | O_NOCTTY);
+    if (fd < 0) {
+      throw std::runtime_error{std::format("Could not open serial port {}", port)};
+    }
+
+    termios tio{};
+    tcgetattr(fd, &tio);
+    cfmakeraw(&tio);
+    cfsetispeed(&tio, BaudToSpeed(baud));
+    cfsetospeed(&tio, BaudToSpeed(baud));
+    tio.c_cc[VMIN]  = 1;
+    tio.c_cc[VTIME] = 1;
+    if (tcsetattr(fd, TCSANOW, &tio) != 0) {
+      close(fd);
+      throw std::runtime_error{std::format("Could not configure serial port {}", port)};
+    }
+
+    return Source{fd};
+  }
+
+  /**
+   * @brief Opens a previously captured raw file.
+   * @param path File path.
+   * @return Opened source.
+   */
+  static Source OpenFile(const std::string& path) {
+    const int fd = open(path.c_str(), O_RDONLY);
+    if (fd < 0) {
+      throw std::runtime_error{std::format("Could not open input file {}", path)};
+    }
+
+    return Source{fd};
+  }
+
+  Source(Source&& rhs) noexcept
+      : fd{rhs.fd} {
+    rhs.fd = -1;
+  }
+
+  /**
+   * @brief Reads the next chunk of data.
+   * @param into Buffer to read into.
+   * @return Data that was read, empty at the end of the input.
+   */
+  std::span<const std::byte> Read(std::span<std::byte> into) {
+    const auto n = read(fd, into.data(), into.size());
+    if (n <= 0) {
+      return {};
+    }
+
+    return into.first(static_cast<std::size_t>(n));
+  }
+
+ private:
+  explicit Source(int fd)
+      : fd{fd} {}
+
+  int fd;
+};
+
+std::optional<logging::Level> ParseLevel(std::string_view name) {
+  using enum logging::Level;
+
+  for (const auto level : {Trace, Debug, Info, Warn, Error, Fatal}) {
+    const auto level_name = logging::decoder::LevelName(level);
+    if (std::ranges::equal(name, level_name,
+                           [](char a, char b) { return std::toupper(a) == b; })) {
+      return level;
+    }
+  }
+
+  return std::nullopt;
+}
+
+uint16_t ParseModule(const logging::decoder::Spec& spec, std::string_view module) {
+  uint16_t   id{};
+  const auto hex = module.starts_with("0x");
+  const auto str = hex ? module.substr(2) : module;
+  if (const auto [ptr, ec] = std::from_chars(str.data(), str.data() + str.size(), id, hex ? 16 : 10);
+      ec == std::errc{} && ptr == str.data() + str.size()) {
+    return id;
+  }
+
+  if (const auto* desc = spec.FindModule(module); desc != nullptr) {
+    return desc->id;
+  }
+
+  throw std::runtime_error{std::format("Unknown module '{}'", module)};
+}
+
+}   // namespace
+
+int main(int argc, const char** argv) {
+  argparse::ArgumentParser parser{"hal2_log_capture"};
+
+  parser.add_argument("-p", "--port").help("Serial port to capture from");
+  parser.add_argument("-b", "--baud")
+      .help("Serial port baud rate")
+      .default_value(115'200U)
+      .scan<'u', unsigned>();
+  parser.add_argument("-i", "--input").help("Previously captured raw file to decode");
+  parser.add_argument("-o", "--output").help("File to which to write the raw captured stream");
+  parser.add_argument("-s", "--log-spec").help("JSON logging specification, enables decoding");
+  parser.add_argument("-m", "--module")
+      .help("Only show messages of this module (name or ID), can be repeated")
+      .default_value(std::vector<std::string>{})
+      .append();
+  parser.add_argument("-l", "--min-level")
+      .help("Only show messages of at least this level")
+      .default_value(std::string{"trace"});
+
+  try {
+    parser.parse_args(argc, argv);
+
+    if (parser.present("port").has_value() == parser.present("input").has_value()) {
+      throw std::runtime_error{"Exactly one of --port or --input must be given"};
+    }
+
+    auto source = parser.present("port").has_value()
+                      ? Source::OpenSerial(parser.get<std::string>("port"),
+                                           parser.get<unsigned>("baud"))
+                      : Source::OpenFile(parser.get<std::string>("input"));
+
+    std::optional<std::ofstream> output{};
+    if (const auto path = parser.present("output"); path.has_value()) {
+      output.emplace(*path, std::ios::binary);
+    }
+
+    // Set up decoding when a specification is given.
+    std::optional<logging::decoder::Spec> spec{};
+    if (const auto path = parser.present("log-spec"); path.has_value()) {
+      spec = logging::decoder::Spec::FromFile(*path);
+    }
+
+    logging::decoder::StreamDecoder decoder{};
+    if (spec.has_value()) {
+      logging::decoder::Filter filter{};
+
+      const auto min_level = ParseLevel(parser.get<std::string>("min-level"));
+      if (!min_level.has_value()) {
+        throw std::runtime_error{"Invalid --min-level"};
+      }
+      filter.SetMinLevel(*min_level);
+
+      std::vector<uint16_t> modules{};
+      for (const auto& module : parser.get<std::vector<std::string>>("module")) {
+        modules.push_back(ParseModule(*spec, module));
+      }
+      filter.SetModules(modules);
+
+      decoder.SetFilter(std::move(filter));
+    }
+
+    std::signal(SIGINT, HandleSignal);
+    std::signal(SIGTERM, HandleSignal);
+
+    std::vector<std::byte> buffer(64 * 1024);
+    std::string            lines{};
+    uint64_t               bytes_captured{0};
+
+    while (!stop_requested.load()) {
+      const auto chunk = source.Read(buffer);
+      if (chunk.empty()) {
+        break;
+      }
+
+      bytes_captured += chunk.size();
+      if (output.has_value()) {
+        output->write(reinterpret_cast<const char*>(chunk.data()),
+                      static_cast<std::streamsize>(chunk.size()));
+      }
+
+      if (!spec.has_value()) {
+        continue;
+      }
+
+      // Format all frames in the chunk into one output block.
+      lines.clear();
+      const logging::decoder::Formatter formatter{*spec};
+      decoder.Feed(chunk, [&lines, &formatter](const logging::decoder::Frame& frame) {
+        std::format_to(std::back_inserter(lines), "{:>10} [{:<5}] {}: ", frame.timestamp,
+                       logging::decoder::LevelName(frame.level),
+                       formatter.ModuleName(frame).value_or("<unknown module>"));
+
+        if (!formatter.FormatInto(frame, lines).has_value()) {
+          std::format_to(std::back_inserter(lines), "<undecodable message {}>", frame.message_id);
+        }
+        lines += '\n';
+      });
+
+      std::fwrite(lines.data(), 1, lines.size(), stdout);
+      std::fflush(stdout);
+    }
+
+    const auto& stats = decoder.Statistics();
+    std::cerr << std::format("Captured {} bytes, decoded {} frames ({} filtered), {} CRC errors, "
+                             "{} bytes skipped",
+                             bytes_captured, stats.frames_decoded, stats.frames_filtered,
+                             stats.crc_errors, stats.bytes_skipped)
+              << std::endl;
+    return 0;
+  } catch (const std::exception& e) {
+    std::cerr << e.what() << std::endl;
+    return 1;
+  }
+}
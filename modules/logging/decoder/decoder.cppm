@@ -0,0 +1,5 @@
+export module logging.decoder;
+
+export import :formatter;
+export import :spec;
+export import :stream;
@@ -0,0 +1,289 @@
+module;
+
+#include <array>
+#include <bit>
+#include <charconv>
+#include <concepts>
+#include <cstdint>
+#include <expected>
+#include <format>
+#include <iterator>
+#include <span>
+#include <string>
+#include <string_view>
+#include <type_traits>
+#include <utility>
+
+export module logging.decoder:formatter;
+
+import hstd;
+
+import logging.abstract;
+
+import :spec;
+import :stream;
+
+namespace logging::decoder {
+
+/** @brief Errors that can occur while formatting a frame. */
+export enum class FormatError {
+  UnknownModule,
+  UnknownMessage,
+  PayloadSizeMismatch,
+};
+
+/** @brief Options for formatting frames. */
+export struct FormatOptions {
+  std::string value_prefix{};   //!< Text inserted before every formatted argument.
+  std::string value_suffix{};   //!< Text inserted after every formatted argument.
+};
+
+/**
+ * @brief Returns the display name of a log level.
+ * @param level Log level.
+ * @return Level name.
+ */
+export [[nodiscard]] constexpr std::string_view LevelName(Level level) noexcept {
+  switch (level) {
+  case Level::Trace: return "TRACE";
+  case Level::Debug: return "DEBUG";
+  case Level::Info: return "INFO";
+  case Level::Warn: return "WARN";
+  case Level::Error: return "ERROR";
+  case Level::Fatal: return "FATAL";
+  }
+
+  return "???";
+}
+
+/**
+ * @brief Formats decoded frames into human-readable messages using the decode tables of a
+ * logging specification.
+ */
+export class Formatter {
+ public:
+  /**
+   * @brief Constructor.
+   * @param spec Logging specification. Must outlive the formatter.
+   * @param options Format options.
+   */
+  explicit Formatter(const Spec& spec, FormatOptions options = {})
+      : spec{spec}
+      , options{std::move(options)} {}
+
+  /**
+   * @brief Replaces the format options.
+   * @param new_options New format options.
+   */
+  void SetOptions(FormatOptions new_options) { options = std::move(new_options); }
+
+  /**
+   * @brief Returns the name of the module that produced a frame.
+   * @param frame Frame.
+   * @return Module name, or \c FormatError::UnknownModule if the module is unknown.
+   */
+  [[nodiscard]] std::expected<std::string_view, FormatError>
+  ModuleName(const Frame& frame) const noexcept {
+    const auto* module = spec.FindModule(frame.module_id);
+    if (module == nullptr) {
+      return std::unexpected(FormatError::UnknownModule);
+    }
+
+    return module->name;
+  }
+
+  /**
+   * @brief Formats the message of a frame, appending it to the output string.
+   * @param frame Frame to format.
+   * @param out String to append the formatted message to.
+   * @return Nothing on success, or the error that occurred.
+   */
+  std::expected<void, FormatError> FormatInto(const Frame& frame, std::string& out) const {
+    const auto* module = spec.FindModule(frame.module_id);
+    if (module == nullptr) {
+      return std::unexpected(FormatError::UnknownModule);
+    }
+
+    if (frame.message_id == RepeatedMessageId) {
+      return FormatRepeated(*module, frame, out);
+    }
+    if (frame.message_id == SpanBeginMessageId || frame.message_id == SpanEndMessageId) {
+      return FormatSpan(*module, frame, out);
+    }
+
+    const auto* message = module->FindMessage(frame.message_id);
+    if (message == nullptr) {
+      return std::unexpected(FormatError::UnknownMessage);
+    }
+
+    if (message->payload_size != frame.payload.size()) {
+      return std::unexpected(FormatError::PayloadSizeMismatch);
+    }
+
+    for (const auto& segment : message->segments) {
+      out += segment.literal;
+
+      if (segment.arg_idx.has_value()) {
+        const auto& arg = message->args[*segment.arg_idx];
+        out += options.value_prefix;
+        FormatArg(*module, arg, frame.payload.subspan(arg.offset, arg.size), out);
+        out += options.value_suffix;
+      }
+    }
+
+    return {};
+  }
+
+  /**
+   * @brief Formats the message of a frame.
+   * @param frame Frame to format.
+   * @return Formatted message, or the error that occurred.
+   */
+  [[nodiscard]] std::expected<std::string, FormatError> Format(const Frame& frame) const {
+    std::string result{};
+    return FormatInto(frame, result).transform([&result] { return std::move(result); });
+  }
+
+ private:
+  /**
+   * @brief Formats a record reporting the suppressed repetitions of a rate limited message.
+   * @param module Module descriptor.
+   * @param frame Frame to format.
+   * @param out String to append the formatted message to.
+   * @return Nothing on success, or the error that occurred.
+   */
+  std::expected<void, FormatError> FormatRepeated(const ModuleDescriptor& module,
+                                                  const Frame& frame, std::string& out) const {
+    if (frame.payload.size() != RepeatedPayloadSize) {
+      return std::unexpected(FormatError::PayloadSizeMismatch);
+    }
+
+    const auto* message = module.FindMessage(static_cast<uint8_t>(frame.payload[0]));
+    if (message == nullptr) {
+      return std::unexpected(FormatError::UnknownMessage);
+    }
+
+    const auto count = Read<uint32_t>(frame.payload.subspan(1));
+    std::format_to(std::back_inserter(out), "Suppressed {}{}{} repetitions of \"{}\"",
+                   options.value_prefix, count, options.value_suffix, message->message_template);
+    return {};
+  }
+
+  /**
+   * @brief Formats a trace span begin or end record.
+   * @param module Module descriptor.
+   * @param frame Frame to format.
+   * @param out String to append the formatted message to.
+   * @return Nothing on success, or the error that occurred.
+   */
+  std::expected<void, FormatError> FormatSpan(const ModuleDescriptor& module, const Frame& frame,
+                                              std::string& out) const {
+    if (frame.payload.size() != SpanPayloadSize) {
+      return std::unexpected(FormatError::PayloadSizeMismatch);
+    }
+
+    const auto* message = module.FindMessage(static_cast<uint8_t>(frame.payload[0]));
+    if (message == nullptr) {
+      return std::unexpected(FormatError::UnknownMessage);
+    }
+
+    const auto cycles = Read<uint32_t>(frame.payload.subspan(1));
+    std::format_to(std::back_inserter(out), "Span {} \"{}\" @ {}{}{} cycles",
+                   frame.message_id == SpanBeginMessageId ? "begin" : "end",
+                   message->message_template, options.value_prefix, cycles, options.value_suffix);
+    return {};
+  }
+
+  template <typename T>
+  static T Read(std::span<const std::byte> data) noexcept {
+    if constexpr (std::is_floating_point_v<T>) {
+      return hstd::BytesToFloat<T, std::endian::little>(data);
+    } else {
+      return hstd::BytesToInt<T, std::endian::little>(data);
+    }
+  }
+
+  static int64_t ReadSigned(ArgType type, std::span<const std::byte> data) noexcept {
+    switch (type) {
+    case ArgType::Int8: return Read<int8_t>(data);
+    case ArgType::Int16: return Read<int16_t>(data);
+    case ArgType::Int32: return Read<int32_t>(data);
+    case ArgType::Int64: return Read<int64_t>(data);
+    case ArgType::UInt8: return Read<uint8_t>(data);
+    case ArgType::UInt16: return Read<uint16_t>(data);
+    case ArgType::UInt32: return Read<uint32_t>(data);
+    case ArgType::UInt64: return static_cast<int64_t>(Read<uint64_t>(data));
+    default: return 0;
+    }
+  }
+
+  template <std::integral T>
+  static void FormatInt(T value, const IntFormat& fmt, std::string& out) {
+    std::array<char, 72> buf{};
+    int                  base = 10;
+    switch (fmt.base) {
+    case IntBase::Decimal: base = 10; break;
+    case IntBase::Binary: base = 2; break;
+    case IntBase::LowerHex: [[fallthrough]];
+    case IntBase::UpperHex: base = 16; break;
+    }
+
+    const auto [end, ec] = std::to_chars(buf.data(), buf.data() + buf.size(), value, base);
+    std::string_view digits{buf.data(), end};
+
+    if (fmt.base == IntBase::UpperHex) {
+      for (auto* c = buf.data(); c != end; ++c) {
+        if (*c >= 'a' && *c <= 'f') {
+          *c = static_cast<char>(*c - 'a' + 'A');
+        }
+      }
+    }
+
+    const auto pad = digits.size() < fmt.pad_len ? fmt.pad_len - digits.size() : 0;
+    switch (fmt.pad_type) {
+    case PadType::Left:
+      out += digits;
+      out.append(pad, ' ');
+      break;
+    case PadType::Right:
+      out.append(pad, ' ');
+      out += digits;
+      break;
+    case PadType::Zero:
+      out.append(pad, '0');
+      out += digits;
+      break;
+    }
+  }
+
+  static void FormatArg(const ModuleDescriptor& module, const ArgDescriptor& arg,
+                        std::span<const std::byte> data, std::string& out) {
+    if (arg.enum_idx.has_value()) {
+      const auto& options = module.enums[*arg.enum_idx].options;
+      if (const auto it = options.find(ReadSigned(arg.type, data)); it != options.end()) {
+        out += it->second;
+      } else {
+        out += "<unknown>";
+      }
+      return;
+    }
+
+    switch (arg.type) {
+    case ArgType::UInt8: FormatInt(Read<uint8_t>(data), arg.format, out); break;
+    case ArgType::UInt16: FormatInt(Read<uint16_t>(data), arg.format, out); break;
+    case ArgType::UInt32: FormatInt(Read<uint32_t>(data), arg.format, out); break;
+    case ArgType::UInt64: FormatInt(Read<uint64_t>(data), arg.format, out); break;
+    case ArgType::Int8: FormatInt(Read<int8_t>(data), arg.format, out); break;
+    case ArgType::Int16: FormatInt(Read<int16_t>(data), arg.format, out); break;
+    case ArgType::Int32: FormatInt(Read<int32_t>(data), arg.format, out); break;
+    case ArgType::Int64: FormatInt(Read<int64_t>(data), arg.format, out); break;
+    case ArgType::Float32: std::format_to(std::back_inserter(out), "{:.3f}", Read<float>(data)); break;
+    case ArgType::Float64: std::format_to(std::back_inserter(out), "{:.3f}", Read<double>(data)); break;
+    }
+  }
+
+  const Spec&   spec;
+  FormatOptions options;
+};
+
+}   // namespace logging::decoder
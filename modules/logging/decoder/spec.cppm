@@ -0,0 +1,457 @@
+module;
+
+#include <array>
+#include <cstdint>
+#include <filesystem>
+#include <format>
+#include <fstream>
+#include <limits>
+#include <optional>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+#include <nlohmann/json.hpp>
+
+export module logging.decoder:spec;
+
+namespace logging::decoder {
+
+using namespace nlohmann;
+
+/** @brief Primitive type of a log message argument, as it is present on the wire. */
+export enum class ArgType : uint8_t {
+  UInt8,
+  UInt16,
+  UInt32,
+  UInt64,
+  Int8,
+  Int16,
+  Int32,
+  Int64,
+  Float32,
+  Float64,
+};
+
+/** @brief Base in which integer arguments are formatted. */
+export enum class IntBase : uint8_t {
+  Decimal,
+  Binary,
+  LowerHex,
+  UpperHex,
+};
+
+/** @brief Padding applied to integer arguments. */
+export enum class PadType : uint8_t {
+  Left,    //!< Left-aligned, padded with spaces on the right ('<').
+  Right,   //!< Right-aligned, padded with spaces on the left ('>').
+  Zero,    //!< Right-aligned, padded with zeroes on the left ('0').
+};
+
+/** @brief Pre-parsed format specifier of an integer argument. */
+export struct IntFormat {
+  IntBase  base{IntBase::Decimal};   //!< Integer base.
+  PadType  pad_type{PadType::Left};  //!< Padding type.
+  unsigned pad_len{0};               //!< Minimal formatted length.
+};
+
+/** @brief Decode descriptor of an enum. */
+export struct EnumDescriptor {
+  std::string                                  name;      //!< Enum name.
+  ArgType                                      type;      //!< Underlying type.
+  std::unordered_map<int64_t, std::string>     options;   //!< Option names by value.
+};
+
+/** @brief Decode descriptor of a single log message argument. */
+export struct ArgDescriptor {
+  std::string                name;        //!< Argument name.
+  ArgType                    type;        //!< Wire type.
+  std::size_t                offset;      //!< Offset of the argument in the payload.
+  std::size_t                size;        //!< Size of the argument in bytes.
+  IntFormat                  format;      //!< Integer format specifier.
+  std::optional<std::size_t> enum_idx;    //!< Index of the enum descriptor, if any.
+};
+
+/** @brief Segment of a pre-parsed message template. */
+export struct TemplateSegment {
+  std::string                literal;   //!< Literal text preceding the argument.
+  std::optional<std::size_t> arg_idx;   //!< Argument to substitute after the literal, if any.
+};
+
+/** @brief Decode descriptor of a log message. */
+export struct MessageDescriptor {
+  uint8_t                      id;                 //!< Message ID.
+  std::string                  message_template;   //!< Raw message template.
+  std::size_t                  payload_size;       //!< Expected payload size.
+  std::vector<ArgDescriptor>   args;               //!< Message arguments.
+  std::vector<TemplateSegment> segments;           //!< Pre-parsed message template.
+};
+
+/** @brief Decode descriptor of a log module. */
+export struct ModuleDescriptor {
+  /** @brief Marker for a message ID that is not part of the module. */
+  static constexpr uint16_t NoMessage = std::numeric_limits<uint16_t>::max();
+
+  uint16_t                       id;         //!< Module ID.
+  std::string                    name;       //!< Module name.
+  std::vector<EnumDescriptor>    enums;      //!< Enums used in the module.
+  std::vector<MessageDescriptor> messages;   //!< Messages of the module.
+
+  /** @brief Index into \c messages by message ID. */
+  std::array<uint16_t, 256> message_index{};
+
+  /**
+   * @brief Looks up a message by its ID.
+   * @param message_id Message ID.
+   * @return Message descriptor, or \c nullptr if the module has no such message.
+   */
+  [[nodiscard]] const MessageDescriptor* FindMessage(uint8_t message_id) const noexcept {
+    const auto idx = message_index[message_id];
+    return idx == NoMessage ? nullptr : &messages[idx];
+  }
+};
+
+/**
+ * @brief Returns the wire type and size for a type name as emitted by \c logging.spec_gen.
+ * @param type_name Type name.
+ * @return Wire type, or \c std::nullopt if the type is not a primitive.
+ */
+std::optional<ArgType> ParsePrimitiveType(std::string_view type_name) noexcept {
+  static constexpr std::array<std::pair<std::string_view, ArgType>, 10> Primitives{{
+      {"uint8", ArgType::UInt8},
+      {"uint16", ArgType::UInt16},
+      {"uint32", ArgType::UInt32},
+      {"uint64", ArgType::UInt64},
+      {"int8", ArgType::Int8},
+      {"int16", ArgType::Int16},
+      {"int32", ArgType::Int32},
+      {"int64", ArgType::Int64},
+      {"float32", ArgType::Float32},
+      {"float64", ArgType::Float64},
+  }};
+
+  for (const auto& [name, type] : Primitives) {
+    if (name == type_name) {
+      return type;
+    }
+  }
+
+  return std::nullopt;
+}
+
+/**
+ * @brief Returns the size of a wire type in bytes.
+ * @param type Wire type.
+ * @return Size in bytes.
+ */
+export [[nodiscard]] constexpr std::size_t ArgTypeSize(ArgType type) noexcept {
+  switch (type) {
+  case ArgType::UInt8: [[fallthrough]];
+  case ArgType::Int8: return 1;
+  case ArgType::UInt16: [[fallthrough]];
+  case ArgType::Int16: return 2;
+  case ArgType::UInt32: [[fallthrough]];
+  case ArgType::Int32: [[fallthrough]];
+  case ArgType::Float32: return 4;
+  case ArgType::UInt64: [[fallthrough]];
+  case ArgType::Int64: [[fallthrough]];
+  case ArgType::Float64: return 8;
+  }
+
+  return 0;
+}
+
+/**
+ * @brief Parses an integer format specifier, e.g. \c "08x" or \c ">4".
+ * @param fmt Format specifier.
+ * @return Parsed format.
+ */
+IntFormat ParseIntFormat(std::string_view fmt) {
+  IntFormat result{};
+  auto      rest = fmt;
+
+  if (!rest.empty() && (rest.front() == '<' || rest.front() == '>' || rest.front() == '0')) {
+    switch (rest.front()) {
+    case '<': result.pad_type = PadType::Left; break;
+    case '>': result.pad_type = PadType::Right; break;
+    case '0': result.pad_type = PadType::Zero; break;
+    default: break;
+    }
+    rest.remove_prefix(1);
+  }
+
+  while (!rest.empty() && rest.front() >= '0' && rest.front() <= '9') {
+    result.pad_len = result.pad_len * 10 + static_cast<unsigned>(rest.front() - '0');
+    rest.remove_prefix(1);
+  }
+
+  if (!rest.empty()) {
+    switch (rest.front()) {
+    case 'b': result.base = IntBase::Binary; break;
+    case 'x': result.base = IntBase::LowerHex; break;
+    case 'X': result.base = IntBase::UpperHex; break;
+    default:
+      throw std::runtime_error{std::format("Invalid integer format string '{}'.", fmt)};
+    }
+    rest.remove_prefix(1);
+  }
+
+  if (!rest.empty()) {
+    throw std::runtime_error{std::format("Invalid integer format string '{}'.", fmt)};
+  }
+
+  return result;
+}
+
+/**
+ * @brief Splits a message template in literal segments and argument references.
+ * @param msg_template Message template.
+ * @param args Message arguments.
+ * @return Template segments.
+ */
+std::vector<TemplateSegment> ParseTemplate(std::string_view                  msg_template,
+                                           const std::vector<ArgDescriptor>& args) {
+  std::vector<TemplateSegment> result{};
+  std::string                  literal{};
+
+  for (std::size_t i = 0; i < msg_template.size(); ++i) {
+    const char c = msg_template[i];
+
+    // Escaped braces.
+    if ((c == '{' || c == '}') && i + 1 < msg_template.size() && msg_template[i + 1] == c) {
+      literal += c;
+      ++i;
+      continue;
+    }
+
+    if (c != '{') {
+      literal += c;
+      continue;
+    }
+
+    const auto close = msg_template.find('}', i);
+    if (close == std::string_view::npos) {
+      throw std::runtime_error{std::format("Unterminated argument in template '{}'.", msg_template)};
+    }
+
+    auto       ref  = msg_template.substr(i + 1, close - i - 1);
+    const auto name = ref.substr(0, ref.find(':'));
+
+    std::optional<std::size_t> arg_idx{};
+    for (std::size_t a = 0; a < args.size(); ++a) {
+      if (args[a].name == name) {
+        arg_idx = a;
+        break;
+      }
+    }
+
+    if (!arg_idx.has_value()) {
+      throw std::runtime_error{
+          std::format("Unknown argument '{}' in template '{}'.", name, msg_template)};
+    }
+
+    result.push_back({.literal = std::move(literal), .arg_idx = arg_idx});
+    literal.clear();
+    i = close;
+  }
+
+  result.push_back({.literal = std::move(literal), .arg_idx = std::nullopt});
+  return result;
+}
+
+/**
+ * @brief Decode tables for a logging specification. Built from the JSON that is emitted by
+ * \c logging.spec_gen.
+ */
+export class Spec {
+ public:
+  /** @brief Marker for a module ID that is not part of the specification. */
+  static constexpr uint16_t NoModule = std::numeric_limits<uint16_t>::max();
+
+  /**
+   * @brief Builds the decode tables from a parsed JSON logging specification.
+   * @param spec_json Logging specification JSON.
+   * @return Decode tables.
+   */
+  [[nodiscard]] static Spec FromJson(const json& spec_json) {
+    Spec result{};
+
+    for (const auto& module_json : spec_json.at("modules")) {
+      auto module = ParseModule(module_json);
+
+      if (result.module_index[module.id] != NoModule) {
+        throw std::runtime_error{std::format("Duplicate module ID {:#06x}.", module.id)};
+      }
+
+      result.module_index[module.id] = static_cast<uint16_t>(result.modules.size());
+      result.modules.push_back(std::move(module));
+    }
+
+    return result;
+  }
+
+  /**
+   * @brief Builds the decode tables from a JSON logging specification string.
+   * @param spec_str Logging specification JSON string.
+   * @return Decode tables.
+   */
+  [[nodiscard]] static Spec FromString(std::string_view spec_str) {
+    return FromJson(json::parse(spec_str));
+  }
+
+  /**
+   * @brief Builds the decode tables from a JSON logging specification file.
+   * @param path Path to the logging specification.
+   * @return Decode tables.
+   */
+  [[nodiscard]] static Spec FromFile(const std::filesystem::path& path) {
+    std::ifstream input{path};
+    if (!input) {
+      throw std::runtime_error{std::format("Could not open logging specification {}.", path.string())};
+    }
+
+    return FromJson(json::parse(input));
+  }
+
+  /**
+   * @brief Looks up a module by its ID.
+   * @param module_id Module ID.
+   * @return Module descriptor, or \c nullptr if the module is not part of the specification.
+   */
+  [[nodiscard]] const ModuleDescriptor* FindModule(uint16_t module_id) const noexcept {
+    const auto idx = module_index[module_id];
+    return idx == NoModule ? nullptr : &modules[idx];
+  }
+
+  /**
+   * @brief Looks up a module by its name.
+   * @param name Module name.
+   * @return Module descriptor, or \c nullptr if the module is not part of the specification.
+   */
+  [[nodiscard]] const ModuleDescriptor* FindModule(std::string_view name) const noexcept {
+    for (const auto& module : modules) {
+      if (module.name == name) {
+        return &module;
+      }
+    }
+
+    return nullptr;
+  }
+
+  /**
+   * @brief Returns all modules in the specification.
+   * @return Modules.
+   */
+  [[nodiscard]] const std::vector<ModuleDescriptor>& Modules() const& noexcept { return modules; }
+
+ private:
+  Spec()
+      : module_index(std::numeric_limits<uint16_t>::max() + 1U, NoModule) {}
+
+  static ModuleDescriptor ParseModule(const json& module_json) {
+    ModuleDescriptor module{
+        .id       = module_json.at("id").get<uint16_t>(),
+        .name     = module_json.at("name").get<std::string>(),
+        .enums    = {},
+        .messages = {},
+    };
+    module.message_index.fill(ModuleDescriptor::NoMessage);
+
+    for (const auto& [name, enum_json] : module_json.at("enums").items()) {
+      const auto underlying = enum_json.at("underlying_type").get<std::string>();
+      const auto type       = ParsePrimitiveType(underlying);
+      if (!type.has_value()) {
+        throw std::runtime_error{
+            std::format("Unsupported underlying type '{}' of enum '{}'.", underlying, name)};
+      }
+
+      EnumDescriptor desc{.name = name, .type = *type, .options = {}};
+      for (const auto& option : enum_json.at("options")) {
+        desc.options.emplace(option.at("value").get<int64_t>(),
+                             option.at("name").get<std::string>());
+      }
+
+      module.enums.push_back(std::move(desc));
+    }
+
+    for (const auto& message_json : module_json.at("messages")) {
+      auto message = ParseMessage(module, message_json);
+
+      if (module.message_index[message.id] != ModuleDescriptor::NoMessage) {
+        throw std::runtime_error{std::format("Duplicate message ID {} in module '{}'.", message.id,
+                                             module.name)};
+      }
+
+      module.message_index[message.id] = static_cast<uint16_t>(module.messages.size());
+      module.messages.push_back(std::move(message));
+    }
+
+    return module;
+  }
+
+  static MessageDescriptor ParseMessage(const ModuleDescriptor& module, const json& message_json) {
+    MessageDescriptor message{
+        .id               = message_json.at("id").get<uint8_t>(),
+        .message_template = message_json.at("message_template").get<std::string>(),
+        .payload_size     = 0,
+        .args             = {},
+        .segments         = {},
+    };
+
+    for (const auto& arg_json : message_json.at("arguments")) {
+      const auto type_name = arg_json.at("type").get<std::string>();
+
+      ArgDescriptor arg{
+          .name     = arg_json.at("name").get<std::string>(),
+          .type     = ArgType::UInt8,
+          .offset   = message.payload_size,
+          .size     = 0,
+          .format   = {},
+          .enum_idx = std::nullopt,
+      };
+
+      if (const auto type = ParsePrimitiveType(type_name); type.has_value()) {
+        arg.type = *type;
+      } else if (type_name.starts_with("enum:")) {
+        const auto enum_name = std::string_view{type_name}.substr(5);
+        for (std::size_t i = 0; i < module.enums.size(); ++i) {
+          if (module.enums[i].name == enum_name) {
+            arg.enum_idx = i;
+            arg.type     = module.enums[i].type;
+            break;
+          }
+        }
+
+        if (!arg.enum_idx.has_value()) {
+          throw std::runtime_error{std::format("Unknown enum type '{}'.", enum_name)};
+        }
+      } else {
+        throw std::runtime_error{
+            std::format("Unknown / unsupported argument type '{}'.", type_name)};
+      }
+
+      // Format specifiers only affect plain integers, floats are always formatted with a fixed
+      // precision.
+      const auto& fmt = arg_json.at("format");
+      if (!fmt.is_null() && !arg.enum_idx.has_value() && arg.type != ArgType::Float32
+          && arg.type != ArgType::Float64) {
+        arg.format = ParseIntFormat(fmt.get<std::string>());
+      }
+
+      arg.size = ArgTypeSize(arg.type);
+      message.payload_size += arg.size;
+      message.args.push_back(std::move(arg));
+    }
+
+    message.segments = ParseTemplate(message.message_template, message.args);
+
+    return message;
+  }
+
+  std::vector<ModuleDescriptor> modules{};        //!< Modules in the specification.
+  std::vector<uint16_t>         module_index{};   //!< Index into \c modules by module ID.
+};
+
+}   // namespace logging::decoder
@@ -0,0 +1,287 @@
+module;
+
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <concepts>
+#include <cstdint>
+#include <cstring>
+#include <limits>
+#include <span>
+#include <utility>
+#include <vector>
+
+export module logging.decoder:stream;
+
+import hstd;
+
+import logging.abstract;
+
+namespace logging::decoder {
+
+/** @brief Start byte of a frame in the \c logging::encoding::Binary format. */
+export inline constexpr std::byte StartByte{'L'};
+
+/** @brief Size of the frame header (start byte, timestamp, level, module ID, message ID, length). */
+export inline constexpr std::size_t HeaderSize = 10;
+
+/** @brief Size of the frame footer (CRC). */
+export inline constexpr std::size_t FooterSize = 2;
+
+/** @brief Largest possible frame, given that the payload length is a single byte. */
+export inline constexpr std::size_t MaxFrameSize =
+    HeaderSize + std::numeric_limits<uint8_t>::max() + FooterSize;
+
+/**
+ * @brief Reserved message ID of a record that reports how often a rate limited message was
+ * suppressed. Its payload holds the suppressed message ID and the repetition count.
+ */
+export inline constexpr uint8_t RepeatedMessageId = 0;
+
+/** @brief Payload size of a "repeated" record. */
+export inline constexpr std::size_t RepeatedPayloadSize = sizeof(uint8_t) + sizeof(uint32_t);
+
+/** @brief Reserved message ID of a trace span begin record. */
+export inline constexpr uint8_t SpanBeginMessageId = 0xFE;
+
+/** @brief Reserved message ID of a trace span end record. */
+export inline constexpr uint8_t SpanEndMessageId = 0xFF;
+
+/** @brief Payload size of a trace span record, holding the span message ID and cycle counter. */
+export inline constexpr std::size_t SpanPayloadSize = sizeof(uint8_t) + sizeof(uint32_t);
+
+/** @brief Decoded binary log frame. The payload refers to the buffer that was fed to the decoder. */
+export struct Frame {
+  uint32_t                   timestamp;    //!< Frame timestamp.
+  Level                      level;        //!< Log level.
+  uint16_t                   module_id;    //!< Module ID.
+  uint8_t                    message_id;   //!< Message ID.
+  std::span<const std::byte> payload;      //!< Raw argument payload.
+};
+
+/** @brief Counters kept by the stream decoder. */
+export struct DecoderStatistics {
+  uint64_t frames_decoded{0};    //!< Frames with a valid CRC.
+  uint64_t frames_filtered{0};   //!< Valid frames that were rejected by the filter.
+  uint64_t crc_errors{0};        //!< Candidate frames that were rejected due to a CRC mismatch.
+  uint64_t bytes_skipped{0};     //!< Bytes discarded while searching for a frame start.
+};
+
+/**
+ * @brief Frame filter, evaluated on the frame header before any formatting work is done.
+ */
+export class Filter {
+ public:
+  Filter()
+      : module_mask(std::numeric_limits<uint16_t>::max() + 1U, true) {}
+
+  /**
+   * @brief Sets the minimal level of frames that pass the filter.
+   * @param level Minimal level.
+   */
+  void SetMinLevel(Level level) noexcept { min_level = level; }
+
+  /**
+   * @brief Restricts the filter to the given modules. Calling this with an empty list lets all
+   * modules pass again.
+   * @param module_ids IDs of the modules that pass the filter.
+   */
+  void SetModules(std::span<const uint16_t> module_ids) {
+    std::ranges::fill(module_mask, module_ids.empty());
+    for (const auto id : module_ids) {
+      module_mask[id] = true;
+    }
+  }
+
+  /**
+   * @brief Returns whether a frame passes the filter.
+   * @param frame Frame to check.
+   * @return Whether the frame passes the filter.
+   */
+  [[nodiscard]] bool Accepts(const Frame& frame) const noexcept {
+    return frame.level >= min_level && module_mask[frame.module_id];
+  }
+
+ private:
+  Level             min_level{Level::Trace};
+  std::vector<bool> module_mask;
+};
+
+/** @brief Table for a byte-wise CRC16 calculation, equivalent to \c hstd::Crc16. */
+inline constexpr auto Crc16Table = [] {
+  std::array<uint16_t, 256> table{};
+  for (unsigned i = 0; i < table.size(); ++i) {
+    uint16_t crc = static_cast<uint16_t>(i);
+    for (auto bit = 0; bit < 8; ++bit) {
+      crc = (crc & 0b1U) != 0 ? static_cast<uint16_t>((crc >> 1U) ^ 0xA001U)
+                              : static_cast<uint16_t>(crc >> 1U);
+    }
+    table[i] = crc;
+  }
+  return table;
+}();
+
+/**
+ * @brief Calculates the CRC16 of the given data using a lookup table.
+ * @param data Data to calculate the CRC over.
+ * @return CRC.
+ */
+export [[nodiscard]] constexpr uint16_t FastCrc16(std::span<const std::byte> data) noexcept {
+  uint16_t crc{0};
+  for (const auto byte : data) {
+    crc = static_cast<uint16_t>((crc >> 8U) ^ Crc16Table[(crc ^ static_cast<uint8_t>(byte)) & 0xFFU]);
+  }
+  return crc;
+}
+
+static_assert(FastCrc16(std::array{std::byte{'L'}, std::byte{0x12}, std::byte{0x34}})
+              == hstd::Crc16(std::array{std::byte{'L'}, std::byte{0x12}, std::byte{0x34}}));
+
+/**
+ * @brief Returns whether a raw level byte is one of the levels in \c logging::Level.
+ * @param level Raw level byte.
+ * @return Whether the level is valid.
+ */
+[[nodiscard]] constexpr bool IsValidLevel(std::byte level) noexcept {
+  const auto l = static_cast<uint8_t>(level);
+  return l >= std::to_underlying(Level::Trace) && l <= std::to_underlying(Level::Fatal)
+         && l % 10 == 0;
+}
+
+/**
+ * @brief Incremental decoder for a stream of \c logging::encoding::Binary frames. Data may be fed
+ * in chunks of arbitrary size. After corruption, the decoder re-synchronizes on the next start byte
+ * that is followed by a frame with a valid CRC.
+ */
+export class StreamDecoder {
+ public:
+  /**
+   * @brief Sets the filter applied to decoded frames.
+   * @param new_filter Filter to apply.
+   */
+  void SetFilter(Filter new_filter) { filter = std::move(new_filter); }
+
+  /**
+   * @brief Feeds data to the decoder, and invokes the handler for every complete frame that passes
+   * the filter. The frame payload is only valid during the call to the handler.
+   * @param data Data to feed.
+   * @param handler Frame handler.
+   */
+  template <std::invocable<const Frame&> F>
+  void Feed(std::span<const std::byte> data, F&& handler) {
+    // Fast path: no partial frame from a previous chunk, decode directly from the input.
+    if (pending.empty()) {
+      const auto consumed = DecodeBuffer(data, handler);
+      pending.assign(data.begin() + consumed, data.end());
+      return;
+    }
+
+    // A partial frame is pending. Any frame starting in the pending bytes ends within
+    // MaxFrameSize bytes of new data, so only that much has to be copied.
+    const auto old_size = pending.size();
+    const auto n_append = std::min(data.size(), MaxFrameSize);
+    pending.insert(pending.end(), data.begin(), data.begin() + n_append);
+
+    const auto consumed = DecodeBuffer(pending, handler);
+    if (consumed < old_size) {
+      // Not enough data yet, which implies all new data was appended.
+      pending.erase(pending.begin(), pending.begin() + consumed);
+      return;
+    }
+
+    pending.clear();
+    Feed(data.subspan(consumed - old_size), std::forward<F>(handler));
+  }
+
+  /**
+   * @brief Returns the decoder statistics.
+   * @return Decoder statistics.
+   */
+  [[nodiscard]] const DecoderStatistics& Statistics() const& noexcept { return stats; }
+
+  /** @brief Discards any partially received frame and resets the statistics. */
+  void Reset() noexcept {
+    pending.clear();
+    stats = {};
+  }
+
+ private:
+  /**
+   * @brief Decodes all complete frames in a buffer.
+   * @param buf Buffer to decode.
+   * @param handler Frame handler.
+   * @return Amount of bytes consumed. Remaining bytes form the start of an incomplete frame.
+   */
+  template <typename F>
+  std::size_t DecodeBuffer(std::span<const std::byte> buf, F& handler) {
+    std::size_t pos = 0;
+
+    while (pos < buf.size()) {
+      // Find the next start byte.
+      const auto* start = static_cast<const std::byte*>(
+          std::memchr(buf.data() + pos, static_cast<int>(StartByte), buf.size() - pos));
+      if (start == nullptr) {
+        stats.bytes_skipped += buf.size() - pos;
+        return buf.size();
+      }
+
+      const auto start_pos = static_cast<std::size_t>(start - buf.data());
+      stats.bytes_skipped += start_pos - pos;
+      pos = start_pos;
+
+      // Wait for a complete header.
+      if (buf.size() - pos < HeaderSize) {
+        return pos;
+      }
+
+      // Cheap plausibility check before doing any CRC work.
+      if (!IsValidLevel(buf[pos + 5])) {
+        stats.bytes_skipped++;
+        pos++;
+        continue;
+      }
+
+      // Wait for the complete frame.
+      const auto payload_len = static_cast<std::size_t>(buf[pos + 9]);
+      const auto frame_size  = HeaderSize + payload_len + FooterSize;
+      if (buf.size() - pos < frame_size) {
+        return pos;
+      }
+
+      // Validate the CRC, on a mismatch re-synchronize on the next start byte.
+      const auto frame = buf.subspan(pos, frame_size);
+      const auto crc = hstd::BytesToInt<uint16_t, std::endian::little>(frame.last(FooterSize));
+      if (crc != FastCrc16(frame.first(HeaderSize + payload_len))) {
+        stats.crc_errors++;
+        stats.bytes_skipped++;
+        pos++;
+        continue;
+      }
+
+      const Frame decoded{
+          .timestamp  = hstd::BytesToInt<uint32_t, std::endian::little>(frame.subspan(1, 4)),
+          .level      = static_cast<Level>(frame[5]),
+          .module_id  = hstd::BytesToInt<uint16_t, std::endian::little>(frame.subspan(6, 2)),
+          .message_id = static_cast<uint8_t>(frame[8]),
+          .payload    = frame.subspan(HeaderSize, payload_len),
+      };
+
+      stats.frames_decoded++;
+      if (filter.Accepts(decoded)) {
+        handler(decoded);
+      } else {
+        stats.frames_filtered++;
+      }
+
+      pos += frame_size;
+    }
+
+    return pos;
+  }
+
+  Filter                 filter{};
+  DecoderStatistics      stats{};
+  std::vector<std::byte> pending{};
+};
+
+}   // namespace logging::decoder
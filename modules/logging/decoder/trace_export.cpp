@@ -0,0 +1,145 @@
+#include <bit>
+#include <cstdint>
+#include <exception>
+#include <format>
+#include <fstream>
+#include <iostream>
+#include <iterator>
+#include <set>
+#include <span>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include <argparse/argparse.hpp>
+#include <nlohmann/json.hpp>
+
+import hstd;
+
+import logging.decoder;
+
+namespace {
+
+using namespace nlohmann;
+
+/**
+ * @brief Extends the 32-bit cycle counter values of span records to a monotonic 64-bit time base.
+ */
+class CycleCounter {
+ public:
+  /**
+   * @brief Extends a cycle counter value.
+   * @param cycles Raw 32-bit cycle counter value.
+   * @return Cycles since the first span record.
+   */
+  int64_t Extend(uint32_t cycles) noexcept {
+    if (!started) {
+      started = true;
+      last    = cycles;
+      return 0;
+    }
+
+    // Records may be slightly out of order due to preemption between reading the counter and
+    // logging the record, so the delta is interpreted as signed.
+    total += static_cast<int32_t>(cycles - last);
+    last = cycles;
+    return total;
+  }
+
+ private:
+  bool     started{false};
+  uint32_t last{0};
+  int64_t  total{0};
+};
+
+}   // namespace
+
+int main(int argc, const char** argv) {
+  argparse::ArgumentParser parser{"hal2_log_trace"};
+
+  parser.add_argument("-i", "--input").help("Captured raw log stream").required();
+  parser.add_argument("-s", "--log-spec").help("JSON logging specification").required();
+  parser.add_argument("-o", "--output").help("Output Chrome / Perfetto trace JSON file").required();
+  parser.add_argument("-f", "--cpu-freq")
+      .help("Frequency of the cycle counter in Hz")
+      .required()
+      .scan<'g', double>();
+
+  try {
+    parser.parse_args(argc, argv);
+
+    const auto spec     = logging::decoder::Spec::FromFile(parser.get<std::string>("log-spec"));
+    const auto cpu_freq = parser.get<double>("cpu-freq");
+    if (cpu_freq <= 0.0) {
+      throw std::runtime_error{"Cycle counter frequency must be positive"};
+    }
+
+    std::ifstream input{parser.get<std::string>("input"), std::ios::binary};
+    if (!input) {
+      throw std::runtime_error{"Could not open input file"};
+    }
+    const std::vector<char> raw{std::istreambuf_iterator<char>{input},
+                                std::istreambuf_iterator<char>{}};
+
+    json                            events = json::array();
+    std::set<uint16_t>              modules{};
+    CycleCounter                    counter{};
+    uint64_t                        n_skipped{0};
+    logging::decoder::StreamDecoder decoder{};
+
+    decoder.Feed(std::as_bytes(std::span{raw}), [&](const logging::decoder::Frame& frame) {
+      const bool is_begin = frame.message_id == logging::decoder::SpanBeginMessageId;
+      const bool is_end   = frame.message_id == logging::decoder::SpanEndMessageId;
+      if ((!is_begin && !is_end) || frame.payload.size() != logging::decoder::SpanPayloadSize) {
+        n_skipped++;
+        return;
+      }
+
+      const auto* module = spec.FindModule(frame.module_id);
+      const auto* message =
+          module != nullptr ? module->FindMessage(static_cast<uint8_t>(frame.payload[0])) : nullptr;
+      if (message == nullptr) {
+        n_skipped++;
+        return;
+      }
+
+      const auto cycles = counter.Extend(
+          hstd::BytesToInt<uint32_t, std::endian::little>(frame.payload.subspan(1)));
+
+      // Every module is shown as a separate track.
+      if (modules.insert(frame.module_id).second) {
+        events.push_back({
+            {"name", "thread_name"},
+            {"ph", "M"},
+            {"pid", 1},
+            {"tid", frame.module_id},
+            {"args", {{"name", module->name}}},
+        });
+      }
+
+      events.push_back({
+          {"name", message->message_template},
+          {"cat", module->name},
+          {"ph", is_begin ? "B" : "E"},
+          {"ts", static_cast<double>(cycles) * 1e6 / cpu_freq},
+          {"pid", 1},
+          {"tid", frame.module_id},
+      });
+    });
+
+    std::ofstream output{parser.get<std::string>("output")};
+    if (!output) {
+      throw std::runtime_error{"Could not open output file"};
+    }
+    output << json{{"traceEvents", std::move(events)}, {"displayTimeUnit", "ns"}}.dump();
+
+    const auto& stats = decoder.Statistics();
+    std::cerr << std::format("Decoded {} frames ({} not trace spans), {} CRC errors",
+                             stats.frames_decoded, n_skipped, stats.crc_errors)
+              << std::endl;
+    return 0;
+  } catch (const std::exception& e) {
+    std::cerr << e.what() << std::endl;
+    return 1;
+  }
+}
@@ -3,6 +3,7 @@ module;
 #include <bit>
 #include <cstdint>
 #include <cstring>
+#include <limits>
 #include <span>
 
 export module logging:encoding.binary;
@@ -33,27 +34,60 @@ struct MessageHelper<Message<Msg, Args...>> {
 
 export class Binary {
  public:
+  /** @brief Size of the frame header. */
+  static constexpr std::size_t HeaderSize = sizeof(std::byte)      // Start byte
+                                            + sizeof(uint32_t)     // Timestamp
+                                            + sizeof(uint8_t)      // Level
+                                            + sizeof(uint16_t)     // Module ID
+                                            + sizeof(std::byte)    // Message ID
+                                            + sizeof(std::byte);   // Payload length
+
+  /** @brief Size of the frame footer. */
+  static constexpr std::size_t FooterSize = sizeof(uint16_t);   // CRC
+
+  /** @brief Reserved message ID of a span begin record. */
+  static constexpr uint8_t SpanBeginMessageId = 0xFE;
+
+  /** @brief Reserved message ID of a span end record. */
+  static constexpr uint8_t SpanEndMessageId = 0xFF;
+
+  /**
+   * @brief Returns the exact size of an encoded message.
+   * @tparam Mod Module the message belongs to.
+   * @tparam Msg Message type.
+   * @return Encoded size in bytes.
+   */
+  template <concepts::Module Mod, concepts::Message Msg>
+  static consteval std::size_t EncodedSize() noexcept {
+    static_assert(MessageHelper<Msg>::DataSize <= std::numeric_limits<uint8_t>::max(),
+                  "Message arguments do not fit in a single binary log frame");
+    static_assert(Mod::template MessageIndex<Msg>() + 1 < SpanBeginMessageId,
+                  "Message ID collides with the reserved span message IDs");
+    return HeaderSize + MessageHelper<Msg>::DataSize + FooterSize;
+  }
+
+  /**
+   * @brief Encodes a message.
+   * @tparam Mod Module the message belongs to.
+   * @tparam Msg Message type.
+   * @param timestamp Message timestamp.
+   * @param level Log level.
+   * @param message Message to encode.
+   * @param into Buffer to encode into, must be at least \c EncodedSize<Mod, Msg>() bytes.
+   * @return Encoded message.
+   */
   template <concepts::Module Mod, concepts::Message Msg>
   static std::span<const std::byte> Encode(uint32_t timestamp, Level level,
                                            const Msg&           message,
                                            std::span<std::byte> into) {
     using H = MessageHelper<Msg>;
 
-    constexpr std::size_t HeaderSize = sizeof(std::byte)      // Start byte
-                                       + sizeof(uint32_t)     // Timestamp
-                                       + sizeof(uint8_t)      // Level
-                                       + sizeof(uint16_t)     // Module ID
-                                       + sizeof(std::byte)    // Message ID
-                                       + sizeof(std::byte);   // Payload length
-    constexpr std::size_t FooterSize = sizeof(uint16_t);      // CRC
+    constexpr auto Size = EncodedSize<Mod, Msg>();
+    into                = into.first(Size);
 
     // Encode header
-    into[0] = StartByte;
-    hstd::IntoByteArray(into.subspan(1), timestamp);
-    into[5]  = static_cast<std::byte>(level);
-    hstd::IntoByteArray(into.subspan(6), static_cast<uint16_t>(Mod::Id));
-    into[8]  = static_cast<std::byte>(Mod::template MessageIndex<Msg>() + 1);
-    into[9]  = static_cast<std::byte>(H::DataSize);
+    EncodeHeader<Mod>(timestamp, level, static_cast<uint8_t>(Mod::template MessageIndex<Msg>() + 1),
+                      H::DataSize, into);
     auto dst = into.subspan(HeaderSize);
 
     // Encode arguments
@@ -65,12 +99,92 @@ export class Binary {
       }(hstd::ValueMarker<Is>()));
     }(std::make_index_sequence<H::NumArgs>());
 
-    // Calculate CRC
-    const auto crc_data = into.first(H::DataSize + HeaderSize);
-    const auto crc      = hstd::Crc16(crc_data);
-    hstd::IntoByteArray(dst, crc);
+    EncodeFooter(into);
+    return into;
+  }
+
+  /** @brief Message ID of the record that reports suppressed repetitions of a message. */
+  static constexpr uint8_t RepeatedMessageId = 0;
+
+  /** @brief Exact size of an encoded "repeated" record. */
+  static constexpr std::size_t RepeatedSize = HeaderSize
+                                              + sizeof(uint8_t)     // Suppressed message ID
+                                              + sizeof(uint32_t)    // Number of repetitions
+                                              + FooterSize;
+
+  /**
+   * @brief Encodes a record reporting that a message was suppressed a number of times. The record
+   * uses the reserved message ID \c RepeatedMessageId.
+   * @tparam Mod Module the message belongs to.
+   * @tparam Msg Suppressed message type.
+   * @param timestamp Record timestamp.
+   * @param level Log level.
+   * @param count Number of times the message was suppressed.
+   * @param into Buffer to encode into, must be at least \c RepeatedSize bytes.
+   * @return Encoded record.
+   */
+  template <concepts::Module Mod, concepts::Message Msg>
+  static std::span<const std::byte> EncodeRepeated(uint32_t timestamp, Level level,
+                                                   uint32_t count, std::span<std::byte> into) {
+    into = into.first(RepeatedSize);
+
+    EncodeHeader<Mod>(timestamp, level, RepeatedMessageId,
+                      RepeatedSize - HeaderSize - FooterSize, into);
+    into[HeaderSize] = static_cast<std::byte>(Mod::template MessageIndex<Msg>() + 1);
+    hstd::IntoByteArray(into.subspan(HeaderSize + 1), count);
+
+    EncodeFooter(into);
+    return into;
+  }
+
+  /** @brief Exact size of an encoded span record. */
+  static constexpr std::size_t SpanSize = HeaderSize
+                                          + sizeof(uint8_t)    // Span message ID
+                                          + sizeof(uint32_t)   // Cycle counter
+                                          + FooterSize;
+
+  /**
+   * @brief Encodes the begin or end record of a trace span. The span is identified by a message
+   * of the module, and the record uses one of the reserved message IDs \c SpanBeginMessageId and
+   * \c SpanEndMessageId. Span records are always logged at the \c Trace level.
+   * @tparam Mod Module the span message belongs to.
+   * @tparam Msg Message identifying the span.
+   * @param timestamp Record timestamp.
+   * @param edge Span edge.
+   * @param cycles Cycle counter value at the span edge.
+   * @param into Buffer to encode into, must be at least \c SpanSize bytes.
+   * @return Encoded record.
+   */
+  template <concepts::Module Mod, concepts::Message Msg>
+  static std::span<const std::byte> EncodeSpan(uint32_t timestamp, SpanEdge edge, uint32_t cycles,
+                                               std::span<std::byte> into) {
+    into = into.first(SpanSize);
+
+    EncodeHeader<Mod>(timestamp, Level::Trace,
+                      edge == SpanEdge::Begin ? SpanBeginMessageId : SpanEndMessageId,
+                      SpanSize - HeaderSize - FooterSize, into);
+    into[HeaderSize] = static_cast<std::byte>(Mod::template MessageIndex<Msg>() + 1);
+    hstd::IntoByteArray(into.subspan(HeaderSize + 1), cycles);
+
+    EncodeFooter(into);
+    return into;
+  }
+
+ private:
+  template <concepts::Module Mod>
+  static void EncodeHeader(uint32_t timestamp, Level level, uint8_t message_id,
+                           std::size_t data_size, std::span<std::byte> into) {
+    into[0] = StartByte;
+    hstd::IntoByteArray(into.subspan(1), timestamp);
+    into[5] = static_cast<std::byte>(level);
+    hstd::IntoByteArray(into.subspan(6), static_cast<uint16_t>(Mod::Id));
+    into[8] = static_cast<std::byte>(message_id);
+    into[9] = static_cast<std::byte>(data_size);
+  }
 
-    return into.first(H::DataSize + HeaderSize + FooterSize);
+  static void EncodeFooter(std::span<std::byte> frame) {
+    const auto crc = hstd::Crc16(frame.first(frame.size() - FooterSize));
+    hstd::IntoByteArray(frame.last(FooterSize), crc);
   }
 };
 
@@ -1,6 +1,8 @@
 module;
 
 #include <array>
+#include <cstdint>
+#include <span>
 
 export module logging;
 
@@ -9,12 +11,30 @@ import hstd;
 export import logging.abstract;
 
 export import :encoding.binary;
+export import :rate_limit;
+export import :trace;
 
 namespace logging {
 
-template <hstd::Clock C, concepts::Encoding E, concepts::Sink S,
-          concepts::Module M>
+/**
+ * @brief Logger for a single module.
+ * @tparam C Clock type.
+ * @tparam E Encoding to use.
+ * @tparam S Sink to use.
+ * @tparam M Module.
+ * @tparam RL Rate limits for messages of the module. Rate limiting state is shared by all module
+ * loggers of the same type, so that loggers can be obtained from \c Logger::GetModule whenever
+ * needed. The state is not synchronized, so a rate limited module should be logged to from a
+ * single task.
+ */
+template <hstd::Clock C, concepts::Encoding E, concepts::Sink S, concepts::Module M,
+          concepts::RateLimitList RL = RateLimits<>>
 class ModuleLogger {
+  using Limiter = RateLimiter<C, M, RL>;
+
+  static_assert(!Limiter::Enabled || concepts::RepeatEncoding<E>,
+                "Rate limiting requires an encoding that can report repeated messages");
+
  public:
   /** @brief Module */
   using Module = M;
@@ -97,15 +117,94 @@ class ModuleLogger {
   template <concepts::Message Msg>
     requires(M::template Contains<Msg>())
   void Log(Level level, const Msg& message) {
-    std::array<std::byte, 64> buffer{};
-    const auto                ts = C::now().time_since_epoch().count();
-    const auto encoded = E::template Encode<M, Msg>(ts, level, message, buffer);
+    const auto ts = static_cast<uint32_t>(C::now().time_since_epoch().count());
+
+    // Rate limiting is checked before any encoding work is done.
+    if constexpr (Limiter::template IsLimited<Msg>()) {
+      const auto decision = limiter.template Check<Msg>(ts, level);
+      if (!decision.allow) {
+        return;
+      }
+
+      if (decision.repeated > 0) {
+        EmitEncoded<E::RepeatedSize>([ts, level, &decision](std::span<std::byte> into) {
+          return E::template EncodeRepeated<M, Msg>(ts, level, decision.repeated, into);
+        });
+      }
+    }
+
+    EmitEncoded<E::template EncodedSize<M, Msg>()>(
+        [ts, level, &message](std::span<std::byte> into) {
+          return E::template Encode<M, Msg>(ts, level, message, into);
+        });
+  }
 
-    sink.Write(encoded);
+  /**
+   * @brief Logs the summary records of all rate limited messages that were suppressed since they
+   * were last logged. Summaries are otherwise only logged along with the next occurrence of a
+   * message that passes its limit, so this should be called periodically when repetitions may stop
+   * altogether.
+   */
+  void FlushRateLimits() {
+    if constexpr (Limiter::Enabled) {
+      const auto ts = static_cast<uint32_t>(C::now().time_since_epoch().count());
+
+      limiter.TakeSuppressed([this, ts]<typename Msg>(Level level, uint32_t repeated) {
+        EmitEncoded<E::RepeatedSize>([ts, level, repeated](std::span<std::byte> into) {
+          return E::template EncodeRepeated<M, Msg>(ts, level, repeated, into);
+        });
+      });
+    }
+  }
+
+  /**
+   * @brief Resets the rate limiting state of all module loggers of this type.
+   */
+  static void ResetRateLimits() noexcept { limiter = Limiter{}; }
+
+  /**
+   * @brief Logs the begin or end record of a trace span. Usually used through \c ScopedSpan.
+   * @tparam Msg Message identifying the span.
+   * @param edge Span edge.
+   * @param cycles Cycle counter value at the span edge.
+   */
+  template <concepts::Message Msg>
+    requires(M::template Contains<Msg>())
+  void TraceSpan(SpanEdge edge, uint32_t cycles) {
+    static_assert(concepts::SpanEncoding<E>, "Tracing requires an encoding that supports spans");
+
+    const auto ts = static_cast<uint32_t>(C::now().time_since_epoch().count());
+    EmitEncoded<E::SpanSize>([ts, edge, cycles](std::span<std::byte> into) {
+      return E::template EncodeSpan<M, Msg>(ts, edge, cycles, into);
+    });
   }
 
  private:
+  /**
+   * @brief Encodes a record and passes it to the sink.
+   * @tparam Size Exact encoded size of the record.
+   * @param encode Function that encodes the record into the given buffer.
+   */
+  template <std::size_t Size, typename F>
+  void EmitEncoded(F&& encode) {
+    if constexpr (concepts::ReservingSink<S>) {
+      // Encode directly into sink-owned memory. If the sink has no space, the record is dropped.
+      const std::span<std::byte> dst = sink.Reserve(Size);
+      if (dst.size() < Size) {
+        return;
+      }
+
+      sink.Commit(encode(dst).size());
+    } else {
+      // Buffer is sized for this record exactly, to keep the stack usage of logging tasks minimal.
+      std::array<std::byte, Size> buffer;
+      sink.Write(encode(std::span{buffer}));
+    }
+  }
+
   S& sink;
+
+  static inline Limiter limiter{};
 };
 
 /**
@@ -119,17 +218,17 @@ export template <hstd::Clock C, concepts::Encoding E, concepts::Sink S,
                  concepts::Module... Modules>
 class Logger {
  public:
-  template <concepts::Module M>
+  template <concepts::Module M, concepts::RateLimitList RL = RateLimits<>>
     requires(... || std::is_same_v<M, Modules>)
-  using Module = ModuleLogger<C, E, S, M>;
+  using Module = ModuleLogger<C, E, S, M, RL>;
 
   explicit Logger(S& sink)
       : sink{sink} {}
 
-  template <concepts::Module M>
+  template <concepts::Module M, concepts::RateLimitList RL = RateLimits<>>
     requires(... || std::is_same_v<M, Modules>)
   [[nodiscard]] auto GetModule() const noexcept {
-    return ModuleLogger<C, E, S, M>{sink};
+    return ModuleLogger<C, E, S, M, RL>{sink};
   }
 
  private:
@@ -0,0 +1,176 @@
+module;
+
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <cstdint>
+#include <limits>
+#include <type_traits>
+#include <utility>
+
+export module logging:rate_limit;
+
+import hstd;
+
+import logging.abstract;
+
+namespace logging {
+
+/**
+ * @brief Rate limit for a single message type, implemented as a token bucket. Up to \c Burst
+ * messages are let through at once, after which one message is let through per refill period.
+ * @tparam Msg Message type to limit.
+ * @tparam Burst Bucket size.
+ * @tparam RefillPeriodMs Time after which a single token is added to the bucket, in milliseconds.
+ */
+export template <concepts::Message Msg, uint32_t Burst, uint32_t RefillPeriodMs>
+  requires(Burst > 0 && RefillPeriodMs > 0)
+struct RateLimit {
+  using Message = Msg;
+
+  static constexpr uint32_t BurstSize    = Burst;
+  static constexpr uint32_t RefillPeriod = RefillPeriodMs;
+};
+
+template <typename T>
+inline constexpr bool IsRateLimit = false;
+
+template <typename Msg, uint32_t Burst, uint32_t RefillPeriodMs>
+inline constexpr bool IsRateLimit<RateLimit<Msg, Burst, RefillPeriodMs>> = true;
+
+/**
+ * @brief List of rate limits that apply to a module logger.
+ * @tparam Limits Rate limits.
+ */
+export template <typename... Limits>
+  requires(... && IsRateLimit<Limits>)
+struct RateLimits {};
+
+template <typename T>
+inline constexpr bool IsRateLimits = false;
+
+template <typename... Limits>
+inline constexpr bool IsRateLimits<RateLimits<Limits...>> = true;
+
+namespace concepts {
+
+/** @brief Concept for a list of rate limits. */
+export template <typename T>
+concept RateLimitList = IsRateLimits<T>;
+
+}   // namespace concepts
+
+/** @brief Outcome of a rate limit check. */
+struct RateLimitDecision {
+  bool     allow;      //!< Whether the message may be logged.
+  uint32_t repeated;   //!< Number of times the message was suppressed since it was last logged.
+};
+
+/**
+ * @brief Rate limiter state of a module logger. Holds a single token bucket for every limited
+ * message. Messages without a limit compile to an unconditional pass.
+ * @tparam C Clock the timestamps are taken from.
+ * @tparam M Module.
+ * @tparam RL Rate limits.
+ */
+template <hstd::Clock C, concepts::Module M, concepts::RateLimitList RL>
+class RateLimiter;
+
+template <hstd::Clock C, concepts::Module M, typename... Limits>
+class RateLimiter<C, M, RateLimits<Limits...>> {
+  using LimitedMessages = hstd::Types<typename Limits::Message...>;
+
+  static_assert((... && M::template Contains<typename Limits::Message>()),
+                "Rate limited messages must be part of the module");
+  static_assert(hstd::Types<typename Limits::Message...>::Count
+                    == hstd::UniqueTypes<typename Limits::Message...>::Count,
+                "A message can only have a single rate limit");
+
+ public:
+  /** @brief Whether any message of the module is rate limited. */
+  static constexpr bool Enabled = sizeof...(Limits) > 0;
+
+  /**
+   * @brief Returns whether a message type is rate limited.
+   * @tparam Msg Message type.
+   * @return Whether the message is rate limited.
+   */
+  template <concepts::Message Msg>
+  static consteval bool IsLimited() noexcept {
+    return LimitedMessages::template Contains<Msg>();
+  }
+
+  /**
+   * @brief Checks whether a message may be logged, and takes a token from its bucket if so.
+   * @tparam Msg Message type.
+   * @param now Current timestamp, in ticks of the clock.
+   * @param level Level the message is logged at.
+   * @return Rate limit decision.
+   */
+  template <concepts::Message Msg>
+    requires(IsLimited<Msg>())
+  RateLimitDecision Check(uint32_t now, Level level) noexcept {
+    constexpr auto Slot = *LimitedMessages::template IndexOf<Msg>();
+    using L             = typename hstd::Types<Limits...>::template NthType<Slot>;
+
+    constexpr auto Period = static_cast<uint32_t>(
+        std::chrono::duration_cast<typename C::duration>(std::chrono::milliseconds{L::RefillPeriod})
+            .count());
+    static_assert(Period > 0, "Rate limit refill period is shorter than a clock tick");
+
+    auto& bucket = buckets[Slot];
+
+    // Refill the bucket for every elapsed period.
+    if (const uint32_t refills = (now - bucket.last_refill) / Period; refills > 0) {
+      bucket.tokens = refills >= L::BurstSize ? L::BurstSize
+                                              : std::min(L::BurstSize, bucket.tokens + refills);
+      bucket.last_refill += refills * Period;
+    }
+
+    if (bucket.tokens == 0) {
+      if (bucket.suppressed < std::numeric_limits<uint32_t>::max()) {
+        bucket.suppressed++;
+      }
+      bucket.level = level;
+      return {.allow = false, .repeated = 0};
+    }
+
+    bucket.tokens--;
+    return {.allow = true, .repeated = std::exchange(bucket.suppressed, 0)};
+  }
+
+  /**
+   * @brief Takes the suppression counts of all messages that were suppressed since they were last
+   * logged, and resets them.
+   * @param f Function that is called as \c f.template operator()<Msg>(level, repeated) for every
+   * suppressed message, with the level of its last suppressed occurrence.
+   */
+  template <typename F>
+  void TakeSuppressed(F&& f) {
+    [&]<std::size_t... Slots>(std::index_sequence<Slots...>) {
+      (TakeSuppressedSlot<Slots>(f), ...);
+    }(std::index_sequence_for<Limits...>{});
+  }
+
+ private:
+  struct Bucket {
+    uint32_t tokens;        //!< Available tokens.
+    uint32_t last_refill;   //!< Timestamp of the last refill.
+    uint32_t suppressed;    //!< Number of suppressed messages since the last logged one.
+    Level    level;         //!< Level of the last suppressed message.
+  };
+
+  template <std::size_t Slot, typename F>
+  void TakeSuppressedSlot(F& f) {
+    using Msg = typename hstd::Types<Limits...>::template NthType<Slot>::Message;
+
+    if (auto& bucket = buckets[Slot]; bucket.suppressed > 0) {
+      f.template operator()<Msg>(bucket.level, std::exchange(bucket.suppressed, 0));
+    }
+  }
+
+  std::array<Bucket, sizeof...(Limits)> buckets{Bucket{
+      .tokens = Limits::BurstSize, .last_refill = 0, .suppressed = 0, .level = Level::Trace}...};
+};
+
+}   // namespace logging
@@ -35,7 +35,12 @@ class RtosUart : public OS::template Task<RtosUart<OS, Uart>, OS::MediumStackSiz
 
     while (!this->StopRequested()) {
       OS::System::Clock::BlockFor(50ms);
-      TransmitWriteBuffer();
+
+      // Do not swap out a buffer that has space reserved in it
+      if (mtx.Lock(50ms)) {
+        TransmitWriteBuffer();
+        mtx.Unlock();
+      }
     }
   }
 
@@ -44,21 +49,54 @@ class RtosUart : public OS::template Task<RtosUart<OS, Uart>, OS::MediumStackSiz
    * @param data Data to write to the sink.
    */
   void Write(std::span<const std::byte> data) noexcept {
-    // If the message is larger than the buffer size, we can never transmit.
-    if (data.size() > BufSize) {
+    const auto dst = Reserve(data.size());
+    if (dst.size() < data.size()) {
       return;
     }
 
+    std::memcpy(dst.data(), data.data(), data.size());
+    Commit(data.size());
+  }
+
+  /**
+   * @brief Reserves space in the current write buffer, so that a message can be encoded into it
+   * directly. The write buffer is locked until the reservation is committed, so that the sink task
+   * cannot swap it out in between. A successful reservation must therefore always be followed by
+   * \c Commit.
+   * @param n Number of bytes to reserve.
+   * @return Reserved space, or an empty span if no space is available.
+   */
+  [[nodiscard]] std::span<std::byte> Reserve(std::size_t n) noexcept {
+    using namespace std::chrono_literals;
+
+    // If the message is larger than the buffer size, we can never transmit.
+    if (n > BufSize) {
+      return {};
+    }
+
+    if (!mtx.Lock(10ms)) {
+      return {};
+    }
+
     // See if we need to transmit the current buffer.
-    if (data.size() > free_write_buf.size()) {
+    if (n > free_write_buf.size()) {
       if (!TransmitWriteBuffer()) {
-        return;
+        mtx.Unlock();
+        return {};
       }
     }
 
-    // Write the message to the current write buffer.
-    std::memcpy(free_write_buf.data(), data.data(), data.size());
-    free_write_buf = free_write_buf.subspan(data.size());
+    return free_write_buf.first(n);
+  }
+
+  /**
+   * @brief Commits data that was written into space obtained through \c Reserve, and releases the
+   * write buffer.
+   * @param n Number of bytes written.
+   */
+  void Commit(std::size_t n) noexcept {
+    free_write_buf = free_write_buf.subspan(n);
+    mtx.Unlock();
   }
 
  private:
@@ -87,6 +125,7 @@ class RtosUart : public OS::template Task<RtosUart<OS, Uart>, OS::MediumStackSiz
 
   Uart&          uart;
   OS::EventGroup event_group{};
+  OS::Mutex      mtx{};   //!< Held from a reservation until it is committed.
 
   std::array<std::array<std::byte, BufSize>, 2> buffers{};
   std::size_t                                   write_buf_idx{0};
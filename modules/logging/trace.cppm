@@ -0,0 +1,57 @@
+module;
+
+#include <concepts>
+#include <cstdint>
+
+export module logging:trace;
+
+import hal.abstract;
+
+import logging.abstract;
+
+namespace logging {
+
+/**
+ * @brief Concept for a module logger that can log trace span records.
+ */
+export template <typename ML, typename Msg>
+concept SpanLogger = requires(ML& ml, SpanEdge edge, uint32_t cycles) {
+  ml.template TraceSpan<Msg>(edge, cycles);
+};
+
+/**
+ * @brief RAII trace span. Logs a begin record with the current cycle counter value on
+ * construction, and an end record on destruction. Spans are identified by a message of the
+ * module, so they are named by the logging specification in the same way as regular messages.
+ * @tparam ML Module logger type.
+ * @tparam Msg Message identifying the span.
+ * @tparam PT Performance timer providing the cycle counter.
+ */
+export template <typename ML, concepts::Message Msg, hal::PerformanceTimer PT>
+  requires SpanLogger<ML, Msg>
+class ScopedSpan {
+ public:
+  /**
+   * @brief Constructor, begins the span.
+   * @param logger Module logger to log the span records to.
+   */
+  explicit ScopedSpan(ML& logger)
+      : logger{logger} {
+    logger.template TraceSpan<Msg>(SpanEdge::Begin, static_cast<uint32_t>(PT::Get()));
+  }
+
+  ScopedSpan(const ScopedSpan&)            = delete;
+  ScopedSpan(ScopedSpan&&)                 = delete;
+  ScopedSpan& operator=(const ScopedSpan&) = delete;
+  ScopedSpan& operator=(ScopedSpan&&)      = delete;
+
+  /** @brief Destructor, ends the span. */
+  ~ScopedSpan() {
+    logger.template TraceSpan<Msg>(SpanEdge::End, static_cast<uint32_t>(PT::Get()));
+  }
+
+ private:
+  ML& logger;
+};
+
+}   // namespace logging
@@ -45,6 +45,12 @@ export struct System {
   using Atomic = std::atomic<T>;
 
   using AtomicFlag = std::atomic_flag;
+
+  /**
+   * Annotates a section of code with the CPU time that it takes, for
+   * simulations. On the target, the code takes its CPU time by itself
+   */
+  static void ChargeCpuTime(hstd::Duration auto) noexcept {}
 };
 
 }   // namespace rtos
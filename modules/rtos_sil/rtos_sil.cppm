@@ -87,42 +87,63 @@ class EventGroup {
 
  private:
   static ::sil::Scheduler& sched() {
-    return ::sil::System::instance().GetScheduler();
+    return ::sil::System::Current().GetScheduler();
   }
 
   std::shared_ptr<EventGroupState> state;
 };
 
+/**
+ * Simulated task, belonging to the system that is current when the task is
+ * created. Runs on its own thread or as a fiber, depending on the execution
+ * backend of the scheduler at that time
+ */
 template <typename Impl, std::size_t StackSize = 0>
 class Task {
  public:
   explicit Task(std::string_view name, unsigned priority = 0)
       : name{name}
-      , thread{[this, priority]() {
-        pthread_setname_np(this->name.c_str());
-
-        auto& sched = ::sil::System::instance().GetScheduler();
-        sched.InitializeThread(priority);
-        static_cast<Impl*>(this)->operator()();
-        sched.DeInitializeThread();
-      }} {
-    ::sil::System::instance().GetScheduler().AnnounceThread();
+      , sys{::sil::System::Current()} {
+    auto& sched = sys.GetScheduler();
+
+    if (sched.GetExecutionBackend() == ::sil::ExecutionBackend::Fibers) {
+      sched.SpawnFiber(name, priority,
+                       [this]() { static_cast<Impl*>(this)->operator()(); });
+      return;
+    }
+
+    thread = std::thread{[this, priority]() {
+      pthread_setname_np(this->name.c_str());
+
+      // Code in the task finds its system through the thread binding
+      const ::sil::System::Scope scope{sys};
+
+      auto& sched = sys.GetScheduler();
+      sched.InitializeThread(this->name, priority);
+      static_cast<Impl*>(this)->operator()();
+      sched.DeInitializeThread();
+    }};
+    sched.AnnounceThread();
   }
 
-  ~Task() { thread.join(); }
+  ~Task() {
+    if (thread.joinable()) {
+      thread.join();
+    }
+  }
 
   /**
    * Returns whether a stop of the task was requested
    * @return Whether a stop of the task was requested
    */
   [[nodiscard]] bool StopRequested() const {
-    return ::sil::System::instance().GetScheduler().GetState()
-           == ::sil::SchedulerState::Stopping;
+    return sys.GetScheduler().GetState() == ::sil::SchedulerState::Stopping;
   }
 
  private:
-  std::string name;
-  std::thread thread;
+  std::string    name;
+  ::sil::System& sys;   //!< System the task belongs to
+  std::thread    thread;
 };
 
 class OsClock {
@@ -149,7 +170,7 @@ class OsClock {
 
  private:
   static ::sil::Scheduler& sched() {
-    return ::sil::System::instance().GetScheduler();
+    return ::sil::System::Current().GetScheduler();
   }
 };
 
@@ -167,6 +188,15 @@ export struct System {
   using Atomic = std::atomic<T>;
 
   using AtomicFlag = std::atomic_flag;
+
+  /**
+   * Annotates a section of code with the CPU time that it takes on the
+   * target, by charging it to the current task in simulated time
+   * @param cost CPU time of the section on the target
+   */
+  static void ChargeCpuTime(hstd::Duration auto cost) {
+    ::sil::System::Current().GetScheduler().ChargeCurrentTask(cost);
+  }
 };
 
 export struct Rtos {
@@ -0,0 +1,266 @@
+module;
+
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <optional>
+#include <type_traits>
+
+export module seq:coalescing;
+
+import hstd;
+
+import seq.abstract;
+
+namespace seq {
+
+/** @brief Policy that determines how pushes of an event interact with the event queue. */
+export enum class QueuePolicy : uint8_t {
+  /** @brief Every push is queued, pushes to a full queue are dropped. */
+  Fifo,
+  /**
+   * @brief At most one instance of the event is pending. Pushes while the event is pending update
+   * its data in place, so the event is dispatched with the latest data.
+   */
+  LatestWins,
+  /**
+   * @brief At most one instance of the event is pending. Pushes are merged into a count, which is
+   * dispatched as the event data.
+   */
+  Count,
+  /** @brief Pushes to a full queue evict the oldest queued event to make room. */
+  DropOldest,
+};
+
+/**
+ * @brief Associates a queue policy with an event.
+ * @tparam Ev Event type.
+ * @tparam P Queue policy.
+ */
+export template <typename Ev, QueuePolicy P>
+  requires(P != QueuePolicy::Count || std::is_same_v<typename Ev::Data, uint32_t>)
+struct EventPolicy {
+  using Event                         = Ev;   //!< Event type.
+  static constexpr QueuePolicy Policy = P;    //!< Queue policy of the event.
+};
+
+/**
+ * @brief List of event queue policies. Declared as the \c EventPolicies member type of the OS
+ * settings. Events without a policy use \c QueuePolicy::Fifo.
+ * @tparam Ps Event policies.
+ */
+export template <typename... Ps>
+struct EventPolicies {
+  /** @brief IDs of the events with a policy. */
+  static constexpr std::array<uint32_t, sizeof...(Ps)> Ids{Ps::Event::Id...};
+  /** @brief Policy per event. */
+  static constexpr std::array<QueuePolicy, sizeof...(Ps)> Policies{Ps::Policy...};
+};
+
+/** @brief Event queue overflow statistics. */
+export struct OverflowStatistics {
+  uint32_t dropped{0};     //!< Events dropped because the queue was full.
+  uint32_t coalesced{0};   //!< Pushes merged into a pending event.
+  uint32_t evicted{0};     //!< Queued events evicted by a drop-oldest push.
+};
+
+/**
+ * @brief Diagnostics event, dispatched by the OS after events were dropped. The event data is the
+ * number of events dropped since the previous report.
+ */
+export using QueueOverflowEvent = Event<uint8_t{0xFF}, uint8_t{0xFF}, uint16_t{0x0000}, uint32_t>;
+
+namespace concepts {
+
+/**
+ * @brief Concept describing a queue that can push into a full queue by evicting its oldest
+ * element.
+ * @tparam T Queue element type.
+ */
+export template <typename Q, typename T>
+concept OverwritingQueue = Queue<Q, T> && requires(Q& queue) {
+  { queue.PushOverwrite(std::declval<const T&>()) } -> std::convertible_to<std::optional<T>>;
+};
+
+}   // namespace concepts
+
+template <typename T>
+inline constexpr bool IsEventPolicies = false;
+
+template <typename... Ps>
+inline constexpr bool IsEventPolicies<EventPolicies<Ps...>> = true;
+
+/**
+ * @brief Applies the queue policies of events when they are pushed and dispatched, and keeps track
+ * of overflow statistics.
+ *
+ * Coalesced events have a mailbox that holds their latest data or count. Only the first push into
+ * an empty mailbox puts a record in the queue, and the data is taken from the mailbox when that
+ * record is dispatched. This keeps the queue small during interrupt storms and works with every
+ * queue implementation.
+ *
+ * @tparam Ps Event policies.
+ */
+export template <typename Ps>
+class Coalescer;
+
+export template <typename... Ps>
+class Coalescer<EventPolicies<Ps...>> {
+  using Policies = EventPolicies<Ps...>;
+
+  static constexpr std::size_t NPolicies = sizeof...(Ps);
+
+ public:
+  /** @brief Whether any event evicts queued events. */
+  static constexpr bool HasDropOldest = (... || (Ps::Policy == QueuePolicy::DropOldest));
+
+  /**
+   * @brief Pushes an event into a queue, applying the policy of the event.
+   * @tparam Q Queue type.
+   * @param queue Queue to push into.
+   * @param record Event record to push.
+   */
+  template <concepts::Queue<EventRecord> Q>
+  void Push(Q& queue, const EventRecord& record) noexcept {
+    const auto idx = IndexOf(record.id);
+    if (!idx.has_value()) {
+      PushFifo(queue, record);
+      return;
+    }
+
+    auto& mailbox = mailboxes[*idx];
+    switch (Policies::Policies[*idx]) {
+    case QueuePolicy::LatestWins:
+      mailbox.value.store(record.data);
+      if (mailbox.pending.test_and_set()) {
+        coalesced.fetch_add(1, std::memory_order_relaxed);
+      } else if (!queue.Push(record)) {
+        mailbox.pending.clear();
+        dropped.fetch_add(1, std::memory_order_relaxed);
+      }
+      break;
+    case QueuePolicy::Count:
+      if (mailbox.value.fetch_add(1) > 0) {
+        coalesced.fetch_add(1, std::memory_order_relaxed);
+      } else if (!queue.Push(record)) {
+        dropped.fetch_add(mailbox.value.exchange(0), std::memory_order_relaxed);
+      }
+      break;
+    case QueuePolicy::DropOldest:
+      if constexpr (concepts::OverwritingQueue<Q, EventRecord>) {
+        if (!queue.Push(record)) {
+          if (const auto evicted_record = queue.PushOverwrite(record); evicted_record.has_value()) {
+            evicted.fetch_add(1, std::memory_order_relaxed);
+            Discard(*evicted_record);
+          }
+        }
+      } else {
+        PushFifo(queue, record);
+      }
+      break;
+    case QueuePolicy::Fifo: PushFifo(queue, record); break;
+    }
+  }
+
+  /**
+   * @brief Prepares a popped event record for dispatching, by taking the data of coalesced events
+   * from their mailbox.
+   * @param record Popped event record.
+   * @return Event record to dispatch.
+   */
+  EventRecord Take(const EventRecord& record) noexcept {
+    if constexpr (NPolicies == 0) {
+      return record;
+    } else {
+      const auto idx = IndexOf(record.id);
+      if (!idx.has_value()) {
+        return record;
+      }
+
+      auto  result  = record;
+      auto& mailbox = mailboxes[*idx];
+      switch (Policies::Policies[*idx]) {
+      case QueuePolicy::LatestWins:
+        mailbox.pending.clear();
+        result.data = mailbox.value.load();
+        break;
+      case QueuePolicy::Count: result.data = mailbox.value.exchange(0); break;
+      default: break;
+      }
+      return result;
+    }
+  }
+
+  /**
+   * @brief Returns the number of events dropped since the previous call.
+   * @return Number of newly dropped events.
+   */
+  uint32_t TakeUnreportedDrops() noexcept {
+    const auto total = dropped.load(std::memory_order_relaxed);
+    const auto n_new = total - reported_drops;
+    reported_drops   = total;
+    return n_new;
+  }
+
+  /**
+   * @brief Returns a snapshot of the overflow statistics.
+   * @return Overflow statistics.
+   */
+  [[nodiscard]] OverflowStatistics Statistics() const noexcept {
+    return {
+        .dropped   = dropped.load(std::memory_order_relaxed),
+        .coalesced = coalesced.load(std::memory_order_relaxed),
+        .evicted   = evicted.load(std::memory_order_relaxed),
+    };
+  }
+
+ private:
+  /** @brief Mailbox of a coalesced event. */
+  struct Mailbox {
+    std::atomic<uint32_t> value{0};    //!< Latest data or count.
+    std::atomic_flag      pending{};   //!< Whether a record of the event is queued.
+  };
+
+  template <typename Q>
+  void PushFifo(Q& queue, const EventRecord& record) noexcept {
+    if (!queue.Push(record)) {
+      dropped.fetch_add(1, std::memory_order_relaxed);
+    }
+  }
+
+  /**
+   * @brief Resets the mailbox of an evicted event record, so that the next push queues it again.
+   * @param record Evicted event record.
+   */
+  void Discard(const EventRecord& record) noexcept {
+    const auto idx = IndexOf(record.id);
+    if (!idx.has_value()) {
+      return;
+    }
+
+    auto& mailbox = mailboxes[*idx];
+    switch (Policies::Policies[*idx]) {
+    case QueuePolicy::LatestWins: mailbox.pending.clear(); break;
+    case QueuePolicy::Count: mailbox.value.exchange(0); break;
+    default: break;
+    }
+  }
+
+  static constexpr std::optional<std::size_t> IndexOf(uint32_t id) noexcept {
+    for (std::size_t i = 0; i < NPolicies; ++i) {
+      if (Policies::Ids[i] == id) {
+        return i;
+      }
+    }
+    return std::nullopt;
+  }
+
+  std::array<Mailbox, NPolicies> mailboxes{};   //!< Mailbox per event with a policy.
+
+  std::atomic<uint32_t> dropped{0};          //!< Number of dropped events.
+  std::atomic<uint32_t> coalesced{0};        //!< Number of coalesced pushes.
+  std::atomic<uint32_t> evicted{0};          //!< Number of evicted events.
+  uint32_t              reported_drops{0};   //!< Number of dropped events already reported.
+};
+
+}   // namespace seq
@@ -0,0 +1,244 @@
+module;
+
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <span>
+
+export module seq:profiling;
+
+import hstd;
+import hal.abstract;
+
+import seq.abstract;
+
+namespace seq {
+
+/**
+ * @brief OS settings mixin that enables profiling of the OS loop. Inherit from it next to the
+ * regular OS settings.
+ * @tparam PT Performance timer used to measure cycles.
+ * @tparam NModules Maximum number of modules passed to \c Os::Run.
+ * @tparam NEvents Maximum number of distinct event IDs to keep statistics for.
+ */
+export template <hal::PerformanceTimer PT, std::size_t NModules = 8, std::size_t NEvents = 16>
+struct Profiling {
+  using PerformanceTimer = PT;   //!< Performance timer.
+
+  static constexpr std::size_t MaxProfiledModules = NModules;   //!< Maximum number of modules.
+  static constexpr std::size_t MaxProfiledEvents  = NEvents;    //!< Maximum number of event IDs.
+};
+
+/** @brief Handler statistics of a single module for a single event ID. */
+export struct HandlerProfile {
+  uint32_t n_calls{0};        //!< Number of handler invocations.
+  uint32_t max_cycles{0};     //!< Longest handler invocation.
+  uint64_t total_cycles{0};   //!< Total cycles spent in the handler.
+};
+
+/**
+ * @brief Snapshot of the OS loop profile.
+ * @tparam NModules Maximum number of modules.
+ * @tparam NEvents Maximum number of distinct event IDs.
+ * @tparam NPriorities Number of event priorities.
+ */
+export template <std::size_t NModules, std::size_t NEvents, std::size_t NPriorities>
+struct Profile {
+  /** @brief Magic byte that starts a binary profile dump. */
+  static constexpr auto DumpMagic = std::byte{'P'};
+
+  /**
+   * @brief Size of a binary profile dump. Layout, all little endian:
+   * - Header: magic (u8), number of modules (u8), number of event IDs (u8), number of priorities
+   *   (u8), busy cycles (u64), idle cycles (u64), untracked dispatches (u32).
+   * - Most events drained in a single pass per priority (u32).
+   * - Per event ID: ID (u32), followed by per module: calls (u32), max cycles (u32), total cycles
+   *   (u64).
+   */
+  static constexpr std::size_t DumpSize =
+      4 + 8 + 8 + 4 + 4 * NPriorities + NEvents * (4 + NModules * (4 + 4 + 8));
+
+  std::array<uint32_t, NEvents> event_ids{};   //!< Profiled event IDs.
+  std::size_t                   n_events{0};   //!< Number of used event ID slots.
+
+  //! Handler statistics, indexed by event ID slot and module index.
+  std::array<std::array<HandlerProfile, NModules>, NEvents> handlers{};
+
+  /**
+   * @brief Largest number of events drained from a queue in a single pass of the OS loop, per
+   * priority. This is not the depth of the queue: events that are pushed while a pass drains the
+   * queue count towards that pass, and a pass stops early once the event budget is used up.
+   */
+  std::array<uint32_t, NPriorities> max_drained_per_pass{};
+
+  uint64_t busy_cycles{0};   //!< Cycles spent outside WaitForNextEvent.
+  uint64_t idle_cycles{0};   //!< Cycles spent in WaitForNextEvent.
+  uint32_t n_untracked{0};   //!< Dispatches of event IDs that did not fit in the table.
+
+  /**
+   * @brief Returns the fraction of the time the OS spent waiting for events.
+   * @return Idle ratio between 0 and 1.
+   */
+  [[nodiscard]] constexpr float IdleRatio() const noexcept {
+    const auto total = busy_cycles + idle_cycles;
+    return total > 0 ? static_cast<float>(idle_cycles) / static_cast<float>(total) : 0.F;
+  }
+
+  /**
+   * @brief Writes a compact binary dump of the profile, to be decoded on the host.
+   * @param into Buffer to write into, must hold at least \c DumpSize bytes.
+   * @return Written part of the buffer, or an empty span if the buffer is too small.
+   */
+  std::span<std::byte> Dump(std::span<std::byte> into) const noexcept {
+    if (into.size() < DumpSize) {
+      return {};
+    }
+
+    std::size_t pos   = 0;
+    const auto  write = [&into, &pos]<typename T>(T value) {
+      hstd::IntoByteArray<std::endian::little>(into.subspan(pos, sizeof(T)), value);
+      pos += sizeof(T);
+    };
+
+    into[pos++] = DumpMagic;
+    write(static_cast<uint8_t>(NModules));
+    write(static_cast<uint8_t>(n_events));
+    write(static_cast<uint8_t>(NPriorities));
+    write(busy_cycles);
+    write(idle_cycles);
+    write(n_untracked);
+
+    for (const auto max_drained : max_drained_per_pass) {
+      write(max_drained);
+    }
+
+    for (std::size_t ev = 0; ev < n_events; ++ev) {
+      write(event_ids[ev]);
+      for (const auto& handler : handlers[ev]) {
+        write(handler.n_calls);
+        write(handler.max_cycles);
+        write(handler.total_cycles);
+      }
+    }
+
+    return into.first(pos);
+  }
+};
+
+/**
+ * @brief Profiler of the OS loop. Acts as the dispatch observer of the event router, so every
+ * module handler invocation is timed individually.
+ * @tparam PT Performance timer used to measure cycles.
+ * @tparam NModules Maximum number of modules.
+ * @tparam NEvents Maximum number of distinct event IDs.
+ * @tparam NPriorities Number of event priorities.
+ */
+export template <hal::PerformanceTimer PT, std::size_t NModules, std::size_t NEvents,
+                 std::size_t NPriorities>
+  requires(NModules <= 0xFF && NEvents <= 0xFF && NPriorities <= 0xFF)
+class Profiler {
+  static constexpr std::size_t NoSlot = NEvents;
+
+ public:
+  using Snapshot = Profile<NModules, NEvents, NPriorities>;   //!< Profile snapshot type.
+
+  /** @brief Enables the performance timer and starts measuring busy time. */
+  void Start() noexcept {
+    PT::Enable();
+    last_mark = PT::Get();
+  }
+
+  /**
+   * @brief Selects the event ID that subsequent handler invocations are accounted to.
+   * @param id Event ID.
+   */
+  void BeginEvent(uint32_t id) noexcept {
+    current_slot = SlotOf(id);
+    if (current_slot == NoSlot) {
+      profile.n_untracked++;
+    }
+  }
+
+  /**
+   * @brief Calls and times a module handler.
+   * @tparam I Index of the module.
+   * @param handler Module handler invocation.
+   */
+  template <std::size_t I, typename F>
+    requires(I < NModules)
+  void Call(F&& handler) {
+    const auto start = static_cast<uint32_t>(PT::Get());
+    handler();
+    const auto cycles = static_cast<uint32_t>(PT::Get()) - start;
+
+    if (current_slot != NoSlot) {
+      auto& stats = profile.handlers[current_slot][I];
+      stats.n_calls++;
+      stats.max_cycles = std::max(stats.max_cycles, cycles);
+      stats.total_cycles += cycles;
+    }
+  }
+
+  /**
+   * @brief Records the number of events drained from a queue in a single pass.
+   * @param priority Queue priority.
+   * @param n_events Number of drained events.
+   */
+  void QueueDrained(std::size_t priority, uint32_t n_events) noexcept {
+    auto& max_drained = profile.max_drained_per_pass[priority];
+    max_drained       = std::max(max_drained, n_events);
+  }
+
+  /** @brief Marks the start of a wait for the next event. */
+  void BeginWait() noexcept {
+    const auto now = static_cast<uint32_t>(PT::Get());
+    profile.busy_cycles += now - last_mark;
+    last_mark = now;
+  }
+
+  /**
+   * @brief Marks the end of a wait for the next event. Waits longer than the wrap-around period of
+   * the performance timer are under-counted.
+   */
+  void EndWait() noexcept {
+    const auto now = static_cast<uint32_t>(PT::Get());
+    profile.idle_cycles += now - last_mark;
+    last_mark = now;
+  }
+
+  /**
+   * @brief Returns the current profile.
+   * @return Profile snapshot.
+   */
+  [[nodiscard]] const Snapshot& Get() const noexcept { return profile; }
+
+  /** @brief Resets all statistics. */
+  void Reset() noexcept {
+    profile   = {};
+    last_mark = static_cast<uint32_t>(PT::Get());
+  }
+
+ private:
+  std::size_t SlotOf(uint32_t id) noexcept {
+    for (std::size_t i = 0; i < profile.n_events; ++i) {
+      if (profile.event_ids[i] == id) {
+        return i;
+      }
+    }
+
+    if (profile.n_events < NEvents) {
+      profile.event_ids[profile.n_events] = id;
+      return profile.n_events++;
+    }
+
+    return NoSlot;
+  }
+
+  Snapshot    profile{};              //!< Current profile.
+  std::size_t current_slot{NoSlot};   //!< Event ID slot of the event being dispatched.
+  uint32_t    last_mark{0};           //!< Timer value at the last busy/idle transition.
+};
+
+}   // namespace seq
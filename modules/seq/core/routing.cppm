@@ -0,0 +1,146 @@
+module;
+
+#include <algorithm>
+#include <array>
+#include <cstdint>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+export module seq:routing;
+
+import hstd;
+
+import seq.abstract;
+
+namespace seq {
+
+/**
+ * @brief Returns whether a module receives an event.
+ * @tparam Mod Module type.
+ * @param id Event ID.
+ * @return Whether the module receives the event.
+ */
+template <concepts::Module Mod>
+consteval bool ReceivesEvent(uint32_t id) {
+  if constexpr (concepts::SubscribingModule<Mod>) {
+    constexpr auto& Ids = std::decay_t<Mod>::Subscriptions::Ids;
+    return std::ranges::find(Ids, id) != Ids.end();
+  } else {
+    return true;
+  }
+}
+
+/**
+ * @brief Dispatch observer that calls module handlers without observing them.
+ */
+export struct NullDispatchObserver {
+  /**
+   * @brief Calls a module handler.
+   * @tparam I Index of the module.
+   * @param handler Module handler invocation.
+   */
+  template <std::size_t I, typename F>
+  static void Call(F&& handler) {
+    handler();
+  }
+};
+
+/**
+ * @brief Compile-time routing table from event IDs to the modules that subscribed to them.
+ * Modules that do not declare their subscriptions receive every event. The modules that receive an
+ * event are called in the order in which they are declared, whether they subscribed or not.
+ * @tparam Obs Dispatch observer, through which every module handler invocation is made.
+ * @tparam Modules Modules to route events to.
+ */
+export template <typename Obs, concepts::Module... Modules>
+class EventRouter {
+  using ModuleRefs = std::tuple<Modules&...>;
+  using Handler    = void (*)(ModuleRefs&, Obs&, uint32_t, uint32_t);
+
+  /** @brief Collects the sorted, unique IDs of all events that any module subscribed to. */
+  static constexpr std::vector<uint32_t> CollectIds() {
+    std::vector<uint32_t> ids{};
+    (
+        [&ids]<typename Mod>(hstd::Marker<Mod>) {
+          if constexpr (concepts::SubscribingModule<Mod>) {
+            constexpr auto& ModIds = std::decay_t<Mod>::Subscriptions::Ids;
+            ids.insert(ids.end(), ModIds.begin(), ModIds.end());
+          }
+        }(hstd::Marker<Modules>()),
+        ...);
+
+    std::ranges::sort(ids);
+    const auto dup = std::ranges::unique(ids);
+    ids.erase(dup.begin(), dup.end());
+    return ids;
+  }
+
+  static constexpr std::size_t NumIds = CollectIds().size();
+
+  /** @brief Sorted IDs of all subscribed events. */
+  static constexpr std::array<uint32_t, NumIds> Ids = [] {
+    std::array<uint32_t, NumIds> result{};
+    std::ranges::copy(CollectIds(), result.begin());
+    return result;
+  }();
+
+  /**
+   * @brief Calls all modules for which the given predicate holds at compile time.
+   * @tparam Pred Compile-time predicate on the module type.
+   */
+  template <typename Pred>
+  static void CallIf(ModuleRefs& modules, Obs& obs, uint32_t id, uint32_t data) {
+    [&modules, &obs, id, data]<std::size_t... Is>(std::index_sequence<Is...>) {
+      (..., [&modules, &obs, id, data]<std::size_t I>(hstd::ValueMarker<I>) {
+        using Mod = std::tuple_element_t<I, std::tuple<Modules...>>;
+        if constexpr (Pred::template Value<Mod>) {
+          obs.template Call<I>([&modules, id, data] { std::get<I>(modules)(id, data); });
+        }
+      }(hstd::ValueMarker<Is>()));
+    }(std::index_sequence_for<Modules...>());
+  }
+
+  template <uint32_t Id>
+  struct Receives {
+    template <typename Mod>
+    static constexpr bool Value = ReceivesEvent<Mod>(Id);
+  };
+
+  struct Unsubscribed {
+    template <typename Mod>
+    static constexpr bool Value = !concepts::SubscribingModule<Mod>;
+  };
+
+  /**
+   * @brief Dispatch function per subscribed event, calling exactly its subscribers and the
+   * modules without subscriptions.
+   */
+  static constexpr std::array<Handler, NumIds> Handlers =
+      []<std::size_t... Es>(std::index_sequence<Es...>) {
+        return std::array<Handler, NumIds>{&CallIf<Receives<Ids[Es]>>...};
+      }(std::make_index_sequence<NumIds>());
+
+ public:
+  /**
+   * @brief Dispatches an event to the modules that receive it.
+   * @param modules References to the modules.
+   * @param obs Dispatch observer.
+   * @param event Event to dispatch.
+   */
+  static void Dispatch(ModuleRefs& modules, Obs& obs, const EventRecord& event) {
+    if constexpr (NumIds > 0) {
+      const auto it = std::ranges::lower_bound(Ids, event.id);
+      if (it != Ids.end() && *it == event.id) {
+        Handlers[static_cast<std::size_t>(it - Ids.begin())](modules, obs, event.id, event.data);
+        return;
+      }
+    }
+
+    // No module subscribed to the event
+    CallIf<Unsubscribed>(modules, obs, event.id, event.data);
+  }
+};
+
+}   // namespace seq
@@ -1,11 +1,26 @@
 module;
 
+#include <algorithm>
+#include <array>
+#include <bit>
 #include <chrono>
+#include <cstdint>
+#include <optional>
+#include <tuple>
+#include <type_traits>
+#include <variant>
 
 export module seq;
 
+import hal.abstract;
+
 export import seq.abstract;
 
+export import :coalescing;
+export import :profiling;
+import :routing;
+export import :timer;
+
 namespace seq {
 
 /**
@@ -20,6 +35,193 @@ struct DefaultOsSettings {
   using System     = Sys;
 };
 
+/**
+ * @brief OS settings with a clock, used to timestamp events and to run timers.
+ * @tparam Sys \c seq::concepts::System implementation to use. Timers only run tickless if the
+ * system satisfies \c seq::concepts::TicklessSystem, otherwise the system must wake up
+ * periodically.
+ * @tparam Queue \c seq::concepts::Queue implementation to use.
+ * @tparam Clk \c seq::concepts::Clock implementation to use.
+ * @tparam NTimers Maximum number of simultaneously active timers.
+ */
+export template <concepts::System Sys, concepts::Queue<EventRecord> Queue, typename Clk,
+                 std::size_t NTimers = 8>
+  requires(concepts::Clock<Clk, typename DefaultOsSettings<Sys, Queue>::Duration>)
+struct TimedOsSettings : DefaultOsSettings<Sys, Queue> {
+  using Clock = Clk;   //!< Clock implementation.
+
+  static constexpr std::size_t MaxTimers = NTimers;   //!< Maximum number of active timers.
+};
+
+/**
+ * @brief OS settings with multiple event priority levels. Derived settings override
+ * \c PriorityOf to assign priorities, e.g. based on the package or module ID of an event, and may
+ * list \c PrioritizedEvent types in \c EventPriorities to assign priorities per event.
+ * @tparam Sys \c seq::concepts::System implementation to use.
+ * @tparam Queue \c seq::concepts::Queue implementation to use, one is instantiated per priority.
+ * @tparam NPriorities Number of priority levels.
+ * @tparam Budget Maximum number of events handled per priority per loop iteration, 0 for
+ * unlimited. A budget bounds the time a lower priority waits while higher priorities are busy.
+ *
+ * Settings that also provide a clock may set \c TrackLatency to record the worst-case queueing
+ * latency per priority.
+ */
+export template <concepts::System Sys, concepts::Queue<EventRecord> Queue, std::size_t NPriorities,
+                 std::size_t Budget = 0>
+  requires(NPriorities > 0)
+struct PriorityOsSettings : DefaultOsSettings<Sys, Queue> {
+  static constexpr std::size_t NumPriorities = NPriorities;   //!< Number of priority levels.
+  static constexpr std::size_t EventBudget   = Budget;        //!< Per-priority event budget.
+
+  /**
+   * @brief Returns the priority of an event, higher is more important.
+   * @param id Event ID.
+   * @return Event priority.
+   */
+  static constexpr std::size_t PriorityOf([[maybe_unused]] EventIdRecord id) noexcept {
+    return 0;
+  }
+};
+
+template <typename T>
+inline constexpr bool IsPrioritizedEvent = false;
+
+template <typename Ev, std::size_t P>
+inline constexpr bool IsPrioritizedEvent<PrioritizedEvent<Ev, P>> = true;
+
+/**
+ * @brief List of prioritized events. Declared as the \c EventPriorities member type of the OS
+ * settings, after which every push of a listed event gets its declared priority, also when it is
+ * pushed without a priority. The declared priorities take precedence over \c PriorityOf of the OS
+ * settings.
+ * @tparam Events Prioritized events.
+ */
+export template <typename... Events>
+  requires(... && IsPrioritizedEvent<Events>)
+struct EventPriorities {
+  /** @brief IDs of the prioritized events. */
+  static constexpr std::array<uint32_t, sizeof...(Events)> Ids{Events::Id...};
+  /** @brief Priority per event. */
+  static constexpr std::array<std::size_t, sizeof...(Events)> Priorities{Events::Priority...};
+
+  /**
+   * @brief Returns whether all declared priorities are below a number of priority levels.
+   * @param n_priorities Number of priority levels.
+   * @return Whether all priorities are valid.
+   */
+  static constexpr bool FitIn(std::size_t n_priorities) noexcept {
+    return (... && (Events::Priority < n_priorities));
+  }
+};
+
+template <typename T>
+inline constexpr bool IsEventPriorities = false;
+
+template <typename... Events>
+inline constexpr bool IsEventPriorities<EventPriorities<Events...>> = true;
+
+/**
+ * @brief Worst-case queueing latency statistics of a single priority level, in ticks of the OS
+ * duration.
+ */
+export struct LatencyStatistics {
+  uint32_t max_latency{0};   //!< Largest time between pushing and dispatching an event.
+  uint32_t n_events{0};      //!< Number of dispatched events.
+};
+
+template <typename S>
+inline constexpr bool HasClock = requires {
+  typename S::Clock;
+  requires concepts::Clock<typename S::Clock, typename S::Duration>;
+};
+
+template <typename S>
+inline constexpr std::size_t MaxTimersOf = 0;
+
+template <typename S>
+  requires requires { S::MaxTimers; }
+inline constexpr std::size_t MaxTimersOf<S> = S::MaxTimers;
+
+template <typename S>
+inline constexpr std::size_t NumPrioritiesOf = 1;
+
+template <typename S>
+  requires requires { S::NumPriorities; }
+inline constexpr std::size_t NumPrioritiesOf<S> = S::NumPriorities;
+
+template <typename S>
+inline constexpr std::size_t EventBudgetOf = 0;
+
+template <typename S>
+  requires requires { S::EventBudget; }
+inline constexpr std::size_t EventBudgetOf<S> = S::EventBudget;
+
+template <typename S>
+inline constexpr bool TrackLatencyOf = false;
+
+template <typename S>
+  requires requires { S::TrackLatency; }
+inline constexpr bool TrackLatencyOf<S> = S::TrackLatency;
+
+template <typename S>
+struct PoliciesOf {
+  using Type = EventPolicies<>;
+};
+
+template <typename S>
+  requires IsEventPolicies<typename S::EventPolicies>
+struct PoliciesOf<S> {
+  using Type = typename S::EventPolicies;
+};
+
+template <typename S>
+struct PrioritiesOf {
+  using Type = EventPriorities<>;
+};
+
+template <typename S>
+  requires IsEventPriorities<typename S::EventPriorities>
+struct PrioritiesOf<S> {
+  using Type = typename S::EventPriorities;
+};
+
+template <typename S>
+inline constexpr bool HasProfiling = requires {
+  typename S::PerformanceTimer;
+  requires hal::PerformanceTimer<typename S::PerformanceTimer>;
+  S::MaxProfiledModules;
+  S::MaxProfiledEvents;
+};
+
+template <typename S, std::size_t NPriorities>
+struct ProfilerFor {
+  using Type = NullDispatchObserver;
+};
+
+template <typename S, std::size_t NPriorities>
+  requires HasProfiling<S>
+struct ProfilerFor<S, NPriorities> {
+  using Type = Profiler<typename S::PerformanceTimer, S::MaxProfiledModules, S::MaxProfiledEvents,
+                        NPriorities>;
+};
+
+/** @brief Placeholder for the latency statistics of an OS without latency tracking. */
+struct NoLatencyStatistics {};
+
+/** @brief Placeholder for the timer service of an OS without timers. */
+struct NoTimers {};
+
+template <typename S, std::size_t N>
+struct TimersFor {
+  using Type = NoTimers;
+};
+
+template <typename S, std::size_t N>
+  requires(N > 0)
+struct TimersFor<S, N> {
+  using Type = TimerService<typename S::Clock, typename S::Duration, N>;
+};
+
 /**
  * @brief Seq OS.
  * @tparam S OS settings.
@@ -28,24 +230,69 @@ export template <concepts::OsSettings S>
 class Os {
   using Settings = S;
 
+  static constexpr std::size_t MaxTimers = MaxTimersOf<S>;
+  static_assert(MaxTimers == 0 || HasClock<S>, "Timers require a clock in the OS settings");
+
+  using Timers = typename TimersFor<S, MaxTimers>::Type;
+
+  static constexpr std::size_t NumPriorities = NumPrioritiesOf<S>;
+  static constexpr std::size_t EventBudget   = EventBudgetOf<S>;
+  static constexpr bool        TrackLatency  = TrackLatencyOf<S>;
+  static_assert(!TrackLatency || HasClock<S>, "Latency tracking requires a clock in the OS settings");
+
+  using Priorities = typename PrioritiesOf<S>::Type;
+  static_assert(Priorities::FitIn(NumPriorities),
+                "Declared event priorities exceed the number of priority levels of the OS");
+
+  static constexpr bool Profiled = HasProfiling<S>;
+  using Observer                 = typename ProfilerFor<S, NumPriorities>::Type;
+
+  using Coalescing = Coalescer<typename PoliciesOf<S>::Type>;
+  static_assert(!Coalescing::HasDropOldest
+                    || concepts::OverwritingQueue<typename Settings::EventQueue, EventRecord>,
+                "Drop-oldest event policies require a queue that supports PushOverwrite");
+
+  /** @brief Type of the data argument when emitting an event, \c std::monostate if it has none. */
+  template <typename Ev>
+  using EventDataArg =
+      std::conditional_t<std::is_void_v<typename Ev::Data>, std::monostate, typename Ev::Data>;
+
  public:
+  /** @brief Duration type of the OS. */
+  using Duration = typename S::Duration;
+
   /** @brief Event sink for this OS type. */
   class EventSink {
     friend class Os;
 
    public:
     /**
-     * @brief Pushes an event to the event queue.
+     * @brief Pushes an event to the event queue, with the priority determined by the OS settings.
      * @param event_id ID of the event to push.
      * @param event_data Data corresponding to the event to push.
      */
     static void Push(uint32_t event_id, uint32_t event_data) {
-      (*GetOsPtr())
-          ->queue.Push(EventRecord{
-              .timestamp = 0,
-              .id        = event_id,
-              .data      = event_data,
-          });
+      Push(event_id, event_data, PriorityOf(event_id));
+    }
+
+    /**
+     * @brief Pushes an event to the event queue with an explicit priority.
+     * @param event_id ID of the event to push.
+     * @param event_data Data corresponding to the event to push.
+     * @param priority Event priority, clamped to the highest priority of the OS.
+     */
+    static void Push(uint32_t event_id, uint32_t event_data, std::size_t priority) {
+      auto& os = **GetOsPtr();
+      os.coalescer.Push(os.queues[std::min(priority, NumPriorities - 1)],
+                        EventRecord{
+                            .timestamp = Timestamp(),
+                            .id        = event_id,
+                            .data      = event_data,
+                        });
+
+      if constexpr (concepts::NotifiableSystem<typename Settings::System>) {
+        Settings::System::Notify();
+      }
     }
 
    protected:
@@ -77,21 +324,282 @@ class Os {
   ~Os() { EventSink::DeregisterOs(); }
 
   /**
-   * @brief Enters the main OS loop.
+   * @brief Emits an event once after a delay. Must be called from the OS loop, i.e. from a module.
+   * @tparam Ev Event to emit.
+   * @param delay Delay after which to emit the event.
+   * @param data Event data.
+   * @return Timer handle, or \c std::nullopt if no timer slot was available.
+   */
+  template <typename Ev>
+    requires(MaxTimers > 0)
+  static std::optional<TimerId> EmitAfter(Duration delay, EventDataArg<Ev> data = {}) noexcept {
+    return Instance().timers.Start(Ev::Id, RawData<Ev>(data), delay, Duration::zero());
+  }
+
+  /**
+   * @brief Emits an event periodically. Must be called from the OS loop, i.e. from a module.
+   * @tparam Ev Event to emit.
+   * @param period Emit period, the first event is emitted one period from now. Must not be zero.
+   * @param data Event data.
+   * @return Timer handle, or \c std::nullopt if the period is zero or no timer slot was available.
+   */
+  template <typename Ev>
+    requires(MaxTimers > 0)
+  static std::optional<TimerId> EmitEvery(Duration period, EventDataArg<Ev> data = {}) noexcept {
+    if (period <= Duration::zero()) {
+      return std::nullopt;
+    }
+
+    return Instance().timers.Start(Ev::Id, RawData<Ev>(data), period, period);
+  }
+
+  /**
+   * @brief Cancels a timer. Must be called from the OS loop, i.e. from a module.
+   * @param id Handle of the timer to cancel.
+   * @return Whether the timer was active.
+   */
+  static bool CancelTimer(TimerId id) noexcept
+    requires(MaxTimers > 0)
+  {
+    return Instance().timers.Cancel(id);
+  }
+
+  /**
+   * @brief Returns the profile of the OS loop. Must be called from the OS loop, i.e. from a module,
+   * to get a consistent snapshot.
+   * @return OS loop profile.
+   */
+  [[nodiscard]] static const auto& GetProfile() noexcept
+    requires(Profiled)
+  {
+    return Instance().observer.Get();
+  }
+
+  /**
+   * @brief Resets the profile of the OS loop. Must be called from the OS loop, i.e. from a module.
+   */
+  static void ResetProfile() noexcept
+    requires(Profiled)
+  {
+    Instance().observer.Reset();
+  }
+
+  /**
+   * @brief Returns a snapshot of the event queue overflow statistics.
+   * @return Overflow statistics.
+   */
+  [[nodiscard]] OverflowStatistics GetOverflowStatistics() const noexcept {
+    return coalescer.Statistics();
+  }
+
+  /**
+   * @brief Returns the queueing latency statistics per priority level.
+   * @return Latency statistics, indexed by priority.
+   */
+  [[nodiscard]] const std::array<LatencyStatistics, NumPriorities>& GetLatencyStatistics() const
+    requires(TrackLatency)
+  {
+    return latency;
+  }
+
+  /** @brief Resets the queueing latency statistics. */
+  void ResetLatencyStatistics()
+    requires(TrackLatency)
+  {
+    latency = {};
+  }
+
+  /**
+   * @brief Enters the main OS loop. Events are only dispatched to the modules that subscribed to
+   * them through their \c Subscriptions, modules without subscriptions receive all events. The
+   * modules that receive an event are called in the order in which they are passed. After
+   * events were dropped due to a full queue, a \c QueueOverflowEvent is dispatched. If the OS
+   * settings enable \c Profiling, every module handler invocation is timed.
    * @tparam Modules Modules to run in the OS.
    * @param modules Modules to run in the OS.
    */
   template <concepts::Module... Modules>
   [[noreturn]] void Run(Modules&... modules) {
+    using Router = EventRouter<Observer, Modules...>;
+    std::tuple<Modules&...> module_refs{modules...};
+
+    const auto dispatch = [this, &module_refs](const EventRecord& event) {
+      if constexpr (Profiled) {
+        observer.BeginEvent(event.id);
+      }
+      Router::Dispatch(module_refs, observer, event);
+    };
+
+    if constexpr (Profiled) {
+      static_assert(sizeof...(Modules) <= S::MaxProfiledModules,
+                    "Number of modules exceeds the maximum number of profiled modules");
+      observer.Start();
+    }
+
     while (true) {
-      queue.ReadAll(
-          [&modules...](const EventRecord& event) { (..., modules(event.id, event.data)); });
-      Settings::System::WaitForNextEvent();
+      const bool more_pending = DispatchQueued(dispatch);
+
+      // Report dropped events directly, as the queue may still be full.
+      if (const auto n_dropped = coalescer.TakeUnreportedDrops(); n_dropped > 0) {
+        dispatch(EventRecord{
+            .timestamp = Timestamp(),
+            .id        = QueueOverflowEvent::Id,
+            .data      = n_dropped,
+        });
+      }
+
+      if constexpr (MaxTimers > 0) {
+        timers.Expire(dispatch);
+
+        // Sleep until the next timer deadline if the system supports it.
+        if constexpr (concepts::TicklessSystem<typename Settings::System, Duration>) {
+          if (more_pending) {
+            continue;
+          }
+
+          if (const auto timeout = timers.TimeUntilNextDeadline(); timeout.has_value()) {
+            if (*timeout > Duration::zero()) {
+              Wait(*timeout);
+            }
+            continue;
+          }
+        }
+      }
+
+      // Events left over due to the event budget are handled without waiting.
+      if (more_pending) {
+        continue;
+      }
+
+      Wait();
     }
   }
 
  private:
-  Settings::EventQueue queue{};
+  /**
+   * @brief Waits for the next event, accounting the time as idle time when profiling.
+   * @param timeout Optional timeout, forwarded to the system.
+   */
+  template <typename... Args>
+  void Wait(Args... timeout) {
+    if constexpr (Profiled) {
+      observer.BeginWait();
+    }
+
+    Settings::System::WaitForNextEvent(timeout...);
+
+    if constexpr (Profiled) {
+      observer.EndWait();
+    }
+  }
+
+  /**
+   * @brief Dispatches queued events, highest priority first.
+   * @param dispatch Dispatch function.
+   * @return Whether events may remain because a priority level exhausted its budget.
+   */
+  template <typename F>
+  bool DispatchQueued(F& dispatch) {
+    const auto deliver = [this, &dispatch](const EventRecord& event) {
+      dispatch(coalescer.Take(event));
+    };
+
+    if constexpr (NumPriorities == 1 && EventBudget == 0 && !TrackLatency) {
+      if constexpr (Profiled) {
+        uint32_t n_drained = 0;
+        queues[0].ReadAll([&deliver, &n_drained](const EventRecord& event) {
+          deliver(event);
+          n_drained++;
+        });
+        observer.QueueDrained(0, n_drained);
+      } else {
+        queues[0].ReadAll(deliver);
+      }
+      return false;
+    } else {
+      bool budget_exhausted = false;
+
+      for (std::size_t prio = NumPriorities; prio-- > 0;) {
+        std::size_t n_handled = 0;
+        while (EventBudget == 0 || n_handled < EventBudget) {
+          const auto event = queues[prio].Pop();
+          if (!event.has_value()) {
+            break;
+          }
+
+          if constexpr (TrackLatency) {
+            auto&      stats       = latency[prio];
+            const auto event_delay = Timestamp() - event->timestamp;
+            stats.max_latency      = std::max(stats.max_latency, event_delay);
+            stats.n_events++;
+          }
+
+          deliver(*event);
+          n_handled++;
+        }
+
+        if constexpr (Profiled) {
+          observer.QueueDrained(prio, static_cast<uint32_t>(n_handled));
+        }
+
+        budget_exhausted = budget_exhausted || (EventBudget != 0 && n_handled == EventBudget);
+      }
+
+      return budget_exhausted;
+    }
+  }
+
+  /**
+   * @brief Returns the priority of an event, which is its declared priority if it is listed in the
+   * \c EventPriorities of the settings.
+   * @param event_id Event ID.
+   * @return Event priority.
+   */
+  static constexpr std::size_t PriorityOf(uint32_t event_id) noexcept {
+    for (std::size_t i = 0; i < Priorities::Ids.size(); ++i) {
+      if (Priorities::Ids[i] == event_id) {
+        return Priorities::Priorities[i];
+      }
+    }
+
+    if constexpr (requires(EventIdRecord id) { S::PriorityOf(id); }) {
+      return S::PriorityOf(std::bit_cast<EventIdRecord>(event_id));
+    } else {
+      return 0;
+    }
+  }
+
+  template <typename Ev>
+  static constexpr uint32_t RawData(EventDataArg<Ev> data) noexcept {
+    if constexpr (std::is_void_v<typename Ev::Data>) {
+      return 0;
+    } else {
+      return std::bit_cast<uint32_t>(data);
+    }
+  }
+
+  /**
+   * @brief Returns the timestamp for a new event.
+   * @return Current clock value, or 0 if the OS has no clock.
+   */
+  static uint32_t Timestamp() noexcept {
+    if constexpr (HasClock<S>) {
+      return static_cast<uint32_t>(Duration{S::Clock::Now()}.count());
+    } else {
+      return 0;
+    }
+  }
+
+  static Os& Instance() noexcept { return **EventSink::GetOsPtr(); }
+
+  std::array<typename Settings::EventQueue, NumPriorities> queues{};      //!< Queue per priority.
+  [[no_unique_address]] Timers                            timers{};      //!< Timer service.
+  Coalescing                                               coalescer{};   //!< Queue policies.
+  [[no_unique_address]] Observer                          observer{};    //!< Loop profiler.
+
+  //! Queueing latency statistics per priority.
+  [[no_unique_address]] std::conditional_t<
+      TrackLatency, std::array<LatencyStatistics, NumPriorities>, NoLatencyStatistics> latency{};
 };
 
 }   // namespace seq
\ No newline at end of file
@@ -1,5 +1,6 @@
 module;
 
+#include <array>
 #include <bit>
 #include <concepts>
 #include <cstdint>
@@ -69,6 +70,31 @@ concept Queue = requires(Q& queue) {
 export template <typename Sys>
 concept System = requires() { Sys::WaitForNextEvent(); };
 
+/**
+ * @brief Concept describing a system implementation for Seq that can wait with a timeout, which
+ * allows the OS to sleep until the next timer deadline without a periodic tick.
+ * @tparam D Duration type.
+ */
+export template <typename Sys, typename D>
+concept TicklessSystem = System<Sys> && requires(D timeout) { Sys::WaitForNextEvent(timeout); };
+
+/**
+ * @brief Concept describing a system implementation for Seq that must be notified explicitly when
+ * an event is pushed, e.g. because the OS thread waits on a condition variable rather than on an
+ * interrupt.
+ */
+export template <typename Sys>
+concept NotifiableSystem = System<Sys> && requires() { Sys::Notify(); };
+
+/**
+ * @brief Concept describing a clock used by Seq to timestamp events and run timers.
+ * @tparam D Duration type.
+ */
+export template <typename C, typename D>
+concept Clock = hstd::Duration<D> && requires() {
+  { C::Now() } -> std::convertible_to<D>;
+};
+
 /** @brief Concept describing a valid OS settings struct for Seq. */
 export template <typename Settings>
 concept OsSettings = requires(Settings& s) {
@@ -82,11 +108,53 @@ export template <typename EvSink>
 concept EventSink =
     requires() { EvSink::Push(std::declval<uint32_t>(), std::declval<uint32_t>()); };
 
+/** @brief Concept describing a Seq event sink that accepts an explicit event priority. */
+export template <typename EvSink>
+concept PrioritizedEventSink = EventSink<EvSink> && requires() {
+  EvSink::Push(std::declval<uint32_t>(), std::declval<uint32_t>(), std::declval<std::size_t>());
+};
+
 export template <typename Mod>
 concept Module = requires(Mod& mod) { mod(std::declval<uint32_t>(), std::declval<uint32_t>()); };
 
 }   // namespace concepts
 
+template <typename T>
+inline constexpr bool IsEvent = requires {
+  { T::Id } -> std::convertible_to<uint32_t>;
+  typename T::Data;
+};
+
+/**
+ * @brief List of events a module handles. A module declares it as its \c Subscriptions member
+ * type, after which \c seq::Os only dispatches the listed events to the module.
+ * @tparam Events Handled events.
+ */
+export template <typename... Events>
+  requires(... && IsEvent<Events>)
+struct Subscriptions {
+  /** @brief IDs of the handled events. */
+  static constexpr std::array<uint32_t, sizeof...(Events)> Ids{Events::Id...};
+};
+
+template <typename T>
+inline constexpr bool IsSubscriptions = false;
+
+template <typename... Events>
+inline constexpr bool IsSubscriptions<Subscriptions<Events...>> = true;
+
+namespace concepts {
+
+/**
+ * @brief Concept describing a module that declares the events it handles. Modules that do not
+ * declare their events receive every event.
+ */
+export template <typename Mod>
+concept SubscribingModule =
+    Module<Mod> && IsSubscriptions<typename std::decay_t<Mod>::Subscriptions>;
+
+}   // namespace concepts
+
 export template <concepts::PackageId auto PkgId, concepts::ModuleId auto ModId,
                  concepts::EventId auto EvtId, concepts::EventData EvtData = void>
 struct Event {
@@ -134,4 +202,40 @@ struct Event {
   }
 };
 
+/**
+ * @brief Event with a declared priority. Emitting it requires an event sink that supports
+ * prioritized pushes. Pushes of the underlying event, e.g. through \c Ev::Emit or a push without
+ * a priority, only get the declared priority when the event is listed in the \c EventPriorities of
+ * the OS settings.
+ * @tparam Ev Event type.
+ * @tparam P Event priority, higher is more important.
+ */
+export template <typename Ev, std::size_t P>
+  requires(IsEvent<Ev>)
+struct PrioritizedEvent : Ev {
+  /** @brief Event priority. */
+  static constexpr std::size_t Priority = P;
+
+  /**
+   * @brief Emits an event into the given event sink.
+   * @tparam Sink Sink to emit the event to.
+   * @param data Event data to emit.
+   */
+  template <concepts::PrioritizedEventSink Sink>
+    requires(!std::is_same_v<typename Ev::Data, void>)
+  static void Emit(typename Ev::Data data) noexcept {
+    Sink::Push(Ev::Id, std::bit_cast<uint32_t>(data), P);
+  }
+
+  /**
+   * @brief Emits an event into the given event sink.
+   * @tparam Sink Sink to emit the event to.
+   */
+  template <concepts::PrioritizedEventSink Sink>
+    requires(std::is_same_v<typename Ev::Data, void>)
+  static void Emit() noexcept {
+    Sink::Push(Ev::Id, 0, P);
+  }
+};
+
 }   // namespace seq
\ No newline at end of file
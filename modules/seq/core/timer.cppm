@@ -0,0 +1,258 @@
+module;
+
+#include <algorithm>
+#include <array>
+#include <concepts>
+#include <cstdint>
+#include <limits>
+#include <optional>
+#include <type_traits>
+#include <utility>
+
+export module seq:timer;
+
+import hstd;
+
+import seq.abstract;
+
+namespace seq {
+
+/** @brief Handle to a started timer. */
+export struct TimerId {
+  uint16_t slot;         //!< Timer slot.
+  uint16_t generation;   //!< Generation of the slot, invalidates stale handles.
+
+  constexpr bool operator==(const TimerId&) const noexcept = default;
+};
+
+/**
+ * @brief Timer service, holding a fixed number of one-shot and periodic timers in an indexed
+ * binary min-heap ordered by deadline. Timers emit events when they expire.
+ *
+ * The clock is extended internally to 64 bits, so deadlines are not affected by the wrap-around of
+ * the clock. The extension counts at most one wrap between two clock samples, so the service must
+ * be polled through \c Expire at least once per clock wrap while timers are active.
+ * \c TimeUntilNextDeadline never exceeds half a wrap, so that a tickless OS loop meets this.
+ * Wraps while no timer is active do not matter, as deadlines are only compared to each other and
+ * to the time at which they are polled.
+ *
+ * @tparam C Clock.
+ * @tparam D Duration type.
+ * @tparam N Maximum number of simultaneously active timers.
+ */
+export template <typename C, hstd::Duration D, std::size_t N>
+  requires(concepts::Clock<C, D> && N > 0 && N < std::numeric_limits<uint16_t>::max())
+class TimerService {
+  static constexpr uint16_t NotInHeap = std::numeric_limits<uint16_t>::max();
+
+  using ClockRep = std::make_unsigned_t<typename D::rep>;
+
+  /** @brief Mask of the raw clock ticks, i.e. the number of ticks per clock wrap minus one. */
+  static constexpr uint64_t ClockMask = std::numeric_limits<ClockRep>::max();
+
+ public:
+  /**
+   * @brief Starts a timer.
+   * @param event_id ID of the event to emit.
+   * @param event_data Data of the event to emit.
+   * @param delay Delay after which the timer first expires.
+   * @param period Period with which the timer repeats, zero for a one-shot timer.
+   * @return Timer handle, or \c std::nullopt if all timer slots are in use.
+   */
+  std::optional<TimerId> Start(uint32_t event_id, uint32_t event_data, D delay, D period) noexcept {
+    if (n_active == N) {
+      return std::nullopt;
+    }
+
+    // Take a free slot. Free slots are chained through a free list, to keep this O(1).
+    const auto slot_idx = free_head;
+    auto&      slot     = slots[slot_idx];
+    free_head           = slot.next_free;
+
+    slot.deadline   = Now() + static_cast<uint64_t>(delay.count());
+    slot.period     = static_cast<uint64_t>(period.count());
+    slot.event_id   = event_id;
+    slot.event_data = event_data;
+
+    heap[n_active] = slot_idx;
+    slot.heap_pos  = static_cast<uint16_t>(n_active);
+    n_active++;
+    SiftUp(slot.heap_pos);
+
+    return TimerId{.slot = slot_idx, .generation = slot.generation};
+  }
+
+  /**
+   * @brief Cancels a timer.
+   * @param id Handle of the timer to cancel.
+   * @return Whether the timer was active.
+   */
+  bool Cancel(TimerId id) noexcept {
+    if (id.slot >= N) {
+      return false;
+    }
+
+    const auto& slot = slots[id.slot];
+    if (slot.generation != id.generation || slot.heap_pos == NotInHeap) {
+      return false;
+    }
+
+    RemoveAt(slot.heap_pos);
+    return true;
+  }
+
+  /**
+   * @brief Returns the time until the next timer expires.
+   * @return Time until the next deadline, or \c std::nullopt if no timer is active.
+   */
+  [[nodiscard]] std::optional<D> TimeUntilNextDeadline() noexcept {
+    const auto now = Now();
+    if (n_active == 0) {
+      return std::nullopt;
+    }
+
+    const auto deadline = slots[heap[0]].deadline;
+    if (deadline <= now) {
+      return D::zero();
+    }
+
+    // Wake up at least twice per clock wrap, so that no wrap goes unnoticed.
+    return D{static_cast<typename D::rep>(std::min(deadline - now, ClockMask / 2))};
+  }
+
+  /**
+   * @brief Handles all expired timers. Periodic timers are re-armed before the handler is called,
+   * so the handler may freely start and cancel timers.
+   * @param handler Handler that is called with the event record of every expired timer.
+   */
+  void Expire(std::invocable<const EventRecord&> auto&& handler) {
+    const auto now = Now();
+
+    while (n_active > 0) {
+      const auto slot_idx = heap[0];
+      auto&      slot     = slots[slot_idx];
+      if (slot.deadline > now) {
+        break;
+      }
+
+      const EventRecord event{
+          .timestamp = static_cast<uint32_t>(slot.deadline),
+          .id        = slot.event_id,
+          .data      = slot.event_data,
+      };
+
+      if (slot.period > 0) {
+        // Skip missed periods rather than emitting a burst of events.
+        do {
+          slot.deadline += slot.period;
+        } while (slot.deadline <= now);
+        SiftDown(0);
+      } else {
+        RemoveAt(0);
+      }
+
+      handler(event);
+    }
+  }
+
+ private:
+  struct Slot {
+    uint64_t deadline{0};            //!< Deadline, in extended clock ticks.
+    uint64_t period{0};              //!< Period, zero for one-shot timers.
+    uint32_t event_id{0};            //!< ID of the event to emit.
+    uint32_t event_data{0};          //!< Data of the event to emit.
+    uint16_t heap_pos{NotInHeap};    //!< Position in the heap.
+    uint16_t generation{0};          //!< Slot generation.
+    uint16_t next_free{NotInHeap};   //!< Next free slot.
+  };
+
+  /**
+   * @brief Returns the current time, extended to 64 bits.
+   * @return Current time.
+   */
+  uint64_t Now() noexcept {
+    const auto raw = static_cast<uint64_t>(static_cast<ClockRep>(D{C::Now()}.count()));
+
+    now += (raw - last_raw) & ClockMask;
+    last_raw = raw;
+    return now;
+  }
+
+  void RemoveAt(std::size_t pos) noexcept {
+    const auto slot_idx = heap[pos];
+    auto&      slot     = slots[slot_idx];
+
+    n_active--;
+    if (pos != n_active) {
+      heap[pos]                 = heap[n_active];
+      slots[heap[pos]].heap_pos = static_cast<uint16_t>(pos);
+      SiftUp(pos);
+      SiftDown(slots[heap[pos]].heap_pos);
+    }
+
+    slot.heap_pos = NotInHeap;
+    slot.generation++;
+    slot.next_free = free_head;
+    free_head      = slot_idx;
+  }
+
+  void Swap(std::size_t a, std::size_t b) noexcept {
+    std::swap(heap[a], heap[b]);
+    slots[heap[a]].heap_pos = static_cast<uint16_t>(a);
+    slots[heap[b]].heap_pos = static_cast<uint16_t>(b);
+  }
+
+  [[nodiscard]] bool Before(std::size_t a, std::size_t b) const noexcept {
+    return slots[heap[a]].deadline < slots[heap[b]].deadline;
+  }
+
+  void SiftUp(std::size_t pos) noexcept {
+    while (pos > 0) {
+      const auto parent = (pos - 1) / 2;
+      if (!Before(pos, parent)) {
+        break;
+      }
+      Swap(pos, parent);
+      pos = parent;
+    }
+  }
+
+  void SiftDown(std::size_t pos) noexcept {
+    while (true) {
+      const auto left     = 2 * pos + 1;
+      const auto right    = left + 1;
+      auto       smallest = pos;
+
+      if (left < n_active && Before(left, smallest)) {
+        smallest = left;
+      }
+      if (right < n_active && Before(right, smallest)) {
+        smallest = right;
+      }
+      if (smallest == pos) {
+        break;
+      }
+
+      Swap(pos, smallest);
+      pos = smallest;
+    }
+  }
+
+  static constexpr std::array<Slot, N> InitialSlots() noexcept {
+    std::array<Slot, N> result{};
+    for (std::size_t i = 0; i < N; ++i) {
+      result[i].next_free = i + 1 < N ? static_cast<uint16_t>(i + 1) : NotInHeap;
+    }
+    return result;
+  }
+
+  std::array<Slot, N>     slots{InitialSlots()};   //!< Timer slots.
+  std::array<uint16_t, N> heap{};                  //!< Min-heap of slot indices, by deadline.
+  std::size_t             n_active{0};             //!< Number of active timers.
+  uint16_t                free_head{0};            //!< First free slot.
+
+  uint64_t now{0};        //!< Current time, extended to 64 bits.
+  uint64_t last_raw{0};   //!< Last raw clock value.
+};
+
+}   // namespace seq
@@ -0,0 +1,31 @@
+module;
+
+#include <atomic>
+#include <cstddef>
+#include <new>
+#include <type_traits>
+
+export module seq.port.queue.atomic_queue;
+
+import hstd;
+
+namespace seq::port {
+
+#ifdef __cpp_lib_hardware_interference_size
+constexpr std::size_t CacheLineSize = std::hardware_destructive_interference_size;
+#else
+constexpr std::size_t CacheLineSize = 64;
+#endif
+
+/**
+ * @brief Lock-free bounded MPSC queue based on \c std::atomic, see \c hstd::MpscQueue. Does not
+ * depend on disabling interrupts, so it can be used on the host and from multiple threads. The head
+ * and the tail are on separate cache lines, so that producers do not slow down the consumer.
+ * @tparam T Queue element type, must be trivially copyable.
+ * @tparam N Queue size, must be a power of two.
+ */
+export template <typename T, std::size_t N>
+  requires(hstd::IsPowerOf2(N) && std::is_trivially_copyable_v<T>)
+using AtomicQueue = hstd::MpscQueue<T, N, std::atomic<std::size_t>, CacheLineSize>;
+
+}   // namespace seq::port
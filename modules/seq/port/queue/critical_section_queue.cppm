@@ -44,28 +44,55 @@ class CriticalSectionQueue {
   }
 
   /**
-   * @brief Pops an element from the queue.
+   * @brief Pushes a value to the queue, evicting the oldest element if the queue is full.
+   * @param value Value to push.
+   * @return Evicted element, or \c std::nullopt if the queue was not full.
+   */
+  std::optional<T> PushOverwrite(const T& value) {
+    __disable_irq();
+
+    std::optional<T> evicted{};
+    const auto       next = (head + 1) & (N - 1);
+    if (next == tail) {
+      evicted = buffer[tail];
+      tail    = (tail + 1) & (N - 1);
+    }
+
+    buffer[head] = value;
+    head         = next;
+    __enable_irq();
+
+    return evicted;
+  }
+
+  /**
+   * @brief Pops an element from the queue. Interrupts are disabled while the element is copied,
+   * because \c PushOverwrite may advance the tail from an interrupt.
    * @return Popped element, or \c std::nullopt if the queue was empty.
    */
   std::optional<T> Pop() {
+    __disable_irq();
+
     if (head == tail) {
+      __enable_irq();
       return std::nullopt;
     }
 
     const auto result = buffer[tail];
-    tail              = (tail) & (N - 1);
+    tail              = (tail + 1) & (N - 1);
+    __enable_irq();
+
     return result;
   }
 
   /**
    * @brief Empties the queue and calls the given handler on every element in the queue in insertion
-   * order.
+   * order. The handler is called with interrupts enabled.
    * @param handler Function that is called for every element in the queue.
    */
   void ReadAll(std::invocable<const T&> auto handler) {
-    while (head != tail) {
-      handler(buffer[tail]);
-      tail = (tail + 1) & (N - 1);
+    while (const auto value = Pop()) {
+      handler(*value);
     }
   }
 
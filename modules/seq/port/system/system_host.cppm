@@ -0,0 +1,65 @@
+module;
+
+#include <chrono>
+#include <condition_variable>
+#include <mutex>
+
+export module seq.port.system.host;
+
+import hstd;
+
+namespace seq::port {
+
+/**
+ * @brief System implementation for running Seq on a host, e.g. in SIL or in tests. The OS thread
+ * parks on a condition variable until an event is pushed.
+ *
+ * A notification that arrives while the OS thread is still dispatching events is remembered, so
+ * the next wait returns immediately, just like a pending interrupt wakes a WFI instruction.
+ */
+export struct HostSystem {
+  /** @brief Blocks until an event was pushed since the previous wait. */
+  static void WaitForNextEvent() {
+    std::unique_lock lock{Mutex()};
+    Cv().wait(lock, [] { return Pending(); });
+    Pending() = false;
+  }
+
+  /**
+   * @brief Blocks until an event was pushed since the previous wait, or until the timeout expires.
+   * @param timeout Maximum time to wait.
+   */
+  template <hstd::Duration D>
+  static void WaitForNextEvent(D timeout) {
+    std::unique_lock lock{Mutex()};
+    Cv().wait_for(lock, timeout, [] { return Pending(); });
+    Pending() = false;
+  }
+
+  /** @brief Wakes up the OS thread. Called by the OS after pushing an event. */
+  static void Notify() {
+    {
+      std::lock_guard lock{Mutex()};
+      Pending() = true;
+    }
+    Cv().notify_one();
+  }
+
+ private:
+  static std::mutex& Mutex() {
+    static std::mutex mtx{};
+    return mtx;
+  }
+
+  static std::condition_variable& Cv() {
+    static std::condition_variable cv{};
+    return cv;
+  }
+
+  static bool& Pending() {
+    static bool pending{false};
+    return pending;
+  }
+};
+
+}   // namespace seq::port
@@ -1,4 +1,5 @@
 import dataclasses
+from typing import Optional, BinaryIO
 import argparse
 import pathlib
 import json
@@ -10,6 +11,7 @@ import colorama
 
 from hal2.logging.spec_json import LogSpecJson
 from hal2.logging.spec import LoggingSpec
+from hal2.logging.native_decoder import NativeDecoder, find_library
 
 
 @dataclasses.dataclass
@@ -147,48 +149,168 @@ def print_message(timestamp: int, level: int, module: str, message: str):
     print(f"{format_ts(timestamp)} [{lvl}] {module}: {message}")
 
 
+_LEVEL_NAMES = {
+    "trace": 10,
+    "debug": 20,
+    "info": 30,
+    "warn": 40,
+    "error": 50,
+    "fatal": 60,
+}
+
+
+def resolve_modules(json_spec: LogSpecJson, modules: list[str]) -> list[int]:
+    """
+    Resolves module filter arguments to module IDs.
+
+    Args:
+        json_spec: JSON logging specification.
+        modules: Module names or (hexadecimal) IDs.
+
+    Returns:
+        Module IDs.
+    """
+
+    by_name = {module["name"]: module["id"] for module in json_spec["modules"]}
+
+    result: list[int] = []
+    for module in modules:
+        if module in by_name:
+            result.append(by_name[module])
+        else:
+            result.append(int(module, 0))
+
+    return result
+
+
+def run_native(ser: serial.Serial, decoder: NativeDecoder, capture: Optional[BinaryIO]):
+    """
+    Reads and prints log messages using the native decoder. Data is read in bulk, so that the
+    viewer keeps up with high-rate log streams.
+
+    Args:
+        ser: Serial to read from.
+        decoder: Native decoder.
+        capture: File to which to write the raw stream, if any.
+    """
+
+    while True:
+        data = ser.read(ser.in_waiting or 1)
+        if capture is not None:
+            capture.write(data)
+
+        for record in decoder.feed(data):
+            msg = f"{_LEVEL_COLORS.get(record.level, "")}{record.message}{colorama.Style.RESET_ALL}"
+            print_message(record.timestamp, record.level, record.module, msg)
+
+
+def run_python(
+    ser: serial.Serial,
+    spec: LoggingSpec,
+    min_level: int,
+    modules: set[int],
+    capture: Optional[BinaryIO],
+):
+    """
+    Reads and prints log messages using the Python decoder.
+
+    Args:
+        ser: Serial to read from.
+        spec: Logging specification.
+        min_level: Minimal level of printed messages.
+        modules: IDs of the modules for which to print messages, all modules when empty.
+        capture: File to which to write the raw stream, if any.
+    """
+
+    while True:
+        # Start reading until we receive the start byte (b"L")
+        start_byte = ser.read(1)
+        if capture is not None:
+            capture.write(start_byte)
+        if start_byte != b"L":
+            continue
+
+        try:
+            frame = read_frame(ser)
+            if capture is not None:
+                capture.write(
+                    struct.pack(
+                        "<IBHBB",
+                        frame.header.timestamp,
+                        frame.header.level,
+                        frame.header.module_id,
+                        frame.header.message_id,
+                        frame.header.payload_len,
+                    )
+                    + frame.payload
+                    + struct.pack("<H", frame.footer.crc)
+                )
+
+            if frame.header.level < min_level or (len(modules) > 0 and frame.header.module_id not in modules):
+                continue
+
+            msg_pre = _LEVEL_COLORS[frame.header.level]
+            val_pre = colorama.Style.RESET_ALL + _LEVEL_VALUE_COLORS[frame.header.level]
+            val_post = colorama.Style.RESET_ALL + _LEVEL_COLORS[frame.header.level]
+
+            module, msg = spec.decode(
+                module_id=frame.header.module_id,
+                msg_id=frame.header.message_id,
+                payload=frame.payload,
+                wrap_value=(val_pre, val_post),
+            )
+
+            msg = f"{msg_pre}{msg}{colorama.Style.RESET_ALL}"
+
+            print_message(frame.header.timestamp, frame.header.level, module, msg)
+        except Exception as e:
+            exc_msg = f"{_LEVEL_COLORS[60]}{e}{colorama.Style.RESET_ALL}"
+            print_message(0, 60, "Logger", exc_msg)
+
+
 def main():
     # Define and parse command-line arguments.
     parser = argparse.ArgumentParser(description="Read and log binary log messages")
     parser.add_argument("--log-spec", type=pathlib.Path, help="Path to the JSON log specification file", required=True)
     parser.add_argument("--port", type=str, help="Serial port to read from", required=True)
+    parser.add_argument(
+        "--decoder-lib",
+        type=pathlib.Path,
+        help="Path to the native hal2_log_decoder library (defaults to $HAL2_LOG_DECODER_LIB)",
+    )
+    parser.add_argument("--capture", type=pathlib.Path, help="File to which to write the raw log stream")
+    parser.add_argument(
+        "--module", type=str, action="append", default=[], help="Only show messages of this module (name or ID)"
+    )
+    parser.add_argument(
+        "--min-level", choices=list(_LEVEL_NAMES.keys()), default="trace", help="Only show messages of this level or up"
+    )
     args = parser.parse_args()
 
     # Read logging spec definition.
     with args.log_spec.open("r") as fin:
         json_spec: LogSpecJson = json.load(fin)
 
-    # Create specification
-    spec = LoggingSpec(json_spec)
-
-    # Open serial and start reading messages.
-    with serial.Serial(args.port, timeout=None) as ser:
-        while True:
-            # Start reading until we receive the start byte (b"L")
-            start_byte = ser.read(1)
-            if start_byte != b"L":
-                continue
-
-            try:
-                frame = read_frame(ser)
-
-                msg_pre = _LEVEL_COLORS[frame.header.level]
-                val_pre = colorama.Style.RESET_ALL + _LEVEL_VALUE_COLORS[frame.header.level]
-                val_post = colorama.Style.RESET_ALL + _LEVEL_COLORS[frame.header.level]
+    min_level = _LEVEL_NAMES[args.min_level]
+    modules = resolve_modules(json_spec, args.module)
 
-                module, msg = spec.decode(
-                    module_id=frame.header.module_id,
-                    msg_id=frame.header.message_id,
-                    payload=frame.payload,
-                    wrap_value=(val_pre, val_post),
-                )
-
-                msg = f"{msg_pre}{msg}{colorama.Style.RESET_ALL}"
+    capture = args.capture.open("wb") if args.capture is not None else None
 
-                print_message(frame.header.timestamp, frame.header.level, module, msg)
-            except Exception as e:
-                exc_msg = f"{_LEVEL_COLORS[60]}{e}{colorama.Style.RESET_ALL}"
-                print_message(0, 60, "Logger", exc_msg)
+    # Open serial and start reading messages.
+    try:
+        with serial.Serial(args.port, timeout=None) as ser:
+            lib_path = find_library(args.decoder_lib)
+            if lib_path is not None:
+                decoder = NativeDecoder(lib_path, json_spec)
+                decoder.set_min_level(min_level)
+                decoder.set_modules(modules)
+                decoder.set_value_wrap(colorama.Style.BRIGHT, colorama.Style.NORMAL)
+                run_native(ser, decoder, capture)
+            else:
+                run_python(ser, LoggingSpec(json_spec), min_level, set(modules), capture)
+    finally:
+        if capture is not None:
+            capture.close()
 
 
 if __name__ == "__main__":
@@ -0,0 +1,223 @@
+from typing import Optional, Iterable
+
+import ctypes
+import dataclasses
+import json
+import os
+import pathlib
+
+from hal2.logging.spec_json import LogSpecJson
+
+
+def _func_ptr(ptr, argtypes: list, restype):
+    ptr.argtypes = argtypes
+    ptr.restype = restype
+    return ptr
+
+
+class _Record(ctypes.Structure):
+    _fields_ = [
+        ("timestamp", ctypes.c_uint32),
+        ("level", ctypes.c_uint8),
+        ("module_id", ctypes.c_uint16),
+        ("message_id", ctypes.c_uint8),
+        ("module_name", ctypes.c_char_p),
+        ("message", ctypes.c_char_p),
+    ]
+
+
+class _Statistics(ctypes.Structure):
+    _fields_ = [
+        ("frames_decoded", ctypes.c_uint64),
+        ("frames_filtered", ctypes.c_uint64),
+        ("crc_errors", ctypes.c_uint64),
+        ("bytes_skipped", ctypes.c_uint64),
+    ]
+
+
+@dataclasses.dataclass
+class LogRecord:
+    """Decoded log record."""
+
+    timestamp: int
+    """Log timestamp, in milliseconds."""
+    level: int
+    """Log level."""
+    module_id: int
+    """Log message module ID."""
+    message_id: int
+    """Log message ID."""
+    module: str
+    """Module name."""
+    message: str
+    """Formatted message."""
+
+
+@dataclasses.dataclass
+class DecoderStatistics:
+    """Native decoder statistics."""
+
+    frames_decoded: int
+    """Frames with a valid CRC."""
+    frames_filtered: int
+    """Valid frames that were rejected by the filter."""
+    crc_errors: int
+    """Candidate frames that were rejected due to a CRC mismatch."""
+    bytes_skipped: int
+    """Bytes discarded while searching for a frame start."""
+
+
+class NativeDecoderError(Exception):
+    pass
+
+
+LIBRARY_ENV_VAR = "HAL2_LOG_DECODER_LIB"
+"""Environment variable that can hold the path to the native decoder library."""
+
+
+def find_library(path: Optional[pathlib.Path] = None) -> Optional[pathlib.Path]:
+    """
+    Locates the native decoder library.
+
+    Args:
+        path: Explicitly provided library path.
+
+    Returns:
+        Library path, or `None` when no library was provided.
+    """
+
+    if path is not None:
+        return path
+
+    if LIBRARY_ENV_VAR in os.environ:
+        return pathlib.Path(os.environ[LIBRARY_ENV_VAR])
+
+    return None
+
+
+class NativeDecoder:
+    """
+    Binary log stream decoder backed by the native `hal2_log_decoder` library. Accepts data in
+    chunks of arbitrary size, and re-synchronizes on corrupted data.
+    """
+
+    def __init__(self, lib_path: pathlib.Path, spec: LogSpecJson):
+        """
+        Constructor.
+
+        Args:
+            lib_path: Path to the native decoder library.
+            spec: JSON logging specification.
+        """
+
+        self._c = ctypes.CDLL(str(lib_path))
+
+        self._get_last_error = _func_ptr(self._c.LogDecoder_GetLastError, [], ctypes.c_char_p)
+        self._create = _func_ptr(self._c.LogDecoder_Create, [ctypes.c_char_p], ctypes.c_void_p)
+        self._destroy = _func_ptr(self._c.LogDecoder_Destroy, [ctypes.c_void_p], None)
+        self._set_value_wrap = _func_ptr(
+            self._c.LogDecoder_SetValueWrap, [ctypes.c_void_p, ctypes.c_char_p, ctypes.c_char_p], None
+        )
+        self._set_min_level = _func_ptr(self._c.LogDecoder_SetMinLevel, [ctypes.c_void_p, ctypes.c_uint8], None)
+        self._set_module_filter = _func_ptr(
+            self._c.LogDecoder_SetModuleFilter,
+            [ctypes.c_void_p, ctypes.POINTER(ctypes.c_uint16), ctypes.c_size_t],
+            None,
+        )
+        self._feed = _func_ptr(
+            self._c.LogDecoder_Feed, [ctypes.c_void_p, ctypes.c_char_p, ctypes.c_size_t], ctypes.c_size_t
+        )
+        self._next_record = _func_ptr(
+            self._c.LogDecoder_NextRecord, [ctypes.c_void_p, ctypes.POINTER(_Record)], ctypes.c_bool
+        )
+        self._get_statistics = _func_ptr(
+            self._c.LogDecoder_GetStatistics, [ctypes.c_void_p, ctypes.POINTER(_Statistics)], None
+        )
+
+        self._handle = self._create(json.dumps(spec).encode("utf-8"))
+        if not self._handle:
+            raise NativeDecoderError(self._get_last_error().decode("utf-8"))
+
+    def __del__(self):
+        if getattr(self, "_handle", None):
+            self._destroy(self._handle)
+            self._handle = None
+
+    def set_value_wrap(self, prefix: str, suffix: str):
+        """
+        Sets the text that is inserted around every formatted argument value.
+
+        Args:
+            prefix: Text inserted before every value.
+            suffix: Text inserted after every value.
+        """
+
+        self._set_value_wrap(self._handle, prefix.encode("utf-8"), suffix.encode("utf-8"))
+
+    def set_min_level(self, level: int):
+        """
+        Sets the minimal level of records that are returned.
+
+        Args:
+            level: Minimal level.
+        """
+
+        self._set_min_level(self._handle, level)
+
+    def set_modules(self, module_ids: Iterable[int]):
+        """
+        Restricts the returned records to the given modules. An empty list disables module filtering.
+
+        Args:
+            module_ids: IDs of the modules to return records for.
+        """
+
+        ids = list(module_ids)
+        arr = (ctypes.c_uint16 * len(ids))(*ids)
+        self._set_module_filter(self._handle, arr, len(ids))
+
+    def feed(self, data: bytes) -> list[LogRecord]:
+        """
+        Feeds data to the decoder.
+
+        Args:
+            data: Received data.
+
+        Returns:
+            All records that were completed by the data.
+        """
+
+        self._feed(self._handle, data, len(data))
+
+        result: list[LogRecord] = []
+        record = _Record()
+        while self._next_record(self._handle, ctypes.byref(record)):
+            result.append(
+                LogRecord(
+                    timestamp=record.timestamp,
+                    level=record.level,
+                    module_id=record.module_id,
+                    message_id=record.message_id,
+                    module=record.module_name.decode("utf-8"),
+                    message=record.message.decode("utf-8"),
+                )
+            )
+
+        return result
+
+    def statistics(self) -> DecoderStatistics:
+        """
+        Returns the decoder statistics.
+
+        Returns:
+            Decoder statistics.
+        """
+
+        stats = _Statistics()
+        self._get_statistics(self._handle, ctypes.byref(stats))
+        return DecoderStatistics(
+            frames_decoded=stats.frames_decoded,
+            frames_filtered=stats.frames_filtered,
+            crc_errors=stats.crc_errors,
+            bytes_skipped=stats.bytes_skipped,
+        )
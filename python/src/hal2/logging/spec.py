@@ -7,6 +7,16 @@ import re
 from hal2.logging.spec_json import EnumSpecJson, MessageSpecJson, ArgSpecJson, ModuleSpecJson, LogSpecJson
 
 
+REPEATED_MESSAGE_ID = 0
+"""Reserved message ID of a record that reports the suppressed repetitions of a rate limited message."""
+
+SPAN_BEGIN_MESSAGE_ID = 0xFE
+"""Reserved message ID of a trace span begin record."""
+
+SPAN_END_MESSAGE_ID = 0xFF
+"""Reserved message ID of a trace span end record."""
+
+
 class MessageNotFoundError(Exception):
     def __init__(self, message_id: int):
         super().__init__(f"Unknown message ID {message_id:x}.")
@@ -196,6 +206,7 @@ class MessageSpec:
             enum_types: List of enum specifications for the module the message is in.
         """
         self.id = data["id"]
+        self.message_template = data["message_template"]
 
         self._template = _create_format_string(data["message_template"], data["arguments"])
         self._args: list[tuple[str, ValueFormatter]] = [
@@ -283,11 +294,56 @@ class ModuleSpec:
         Returns:
             Formatted message.
         """
+        if msg_id == REPEATED_MESSAGE_ID:
+            return self._decode_repeated(payload, wrap_value)
+        if msg_id in (SPAN_BEGIN_MESSAGE_ID, SPAN_END_MESSAGE_ID):
+            return self._decode_span(msg_id, payload, wrap_value)
+
         if msg_id not in self._messages:
             raise MessageNotFoundError(msg_id)
 
         return self._messages[msg_id].decode(payload, wrap_value)
 
+    def _decode_repeated(self, payload: bytes, wrap_value: Optional[tuple[str, str]]) -> str:
+        """
+        Decodes a record that reports the suppressed repetitions of a rate limited message.
+
+        Args:
+            payload: Record payload.
+            wrap_value: Strings to wrap dynamic values with, or ``None`` to not wrap.
+
+        Returns:
+            Formatted message.
+        """
+        val_pre, val_post = wrap_value if wrap_value is not None else ("", "")
+
+        msg_id, count = struct.unpack("<BI", payload)
+        if msg_id not in self._messages:
+            raise MessageNotFoundError(msg_id)
+
+        return f'Suppressed {val_pre}{count}{val_post} repetitions of "{self._messages[msg_id].message_template}"'
+
+    def _decode_span(self, span_msg_id: int, payload: bytes, wrap_value: Optional[tuple[str, str]]) -> str:
+        """
+        Decodes a trace span begin or end record.
+
+        Args:
+            span_msg_id: Reserved message ID of the record.
+            payload: Record payload.
+            wrap_value: Strings to wrap dynamic values with, or ``None`` to not wrap.
+
+        Returns:
+            Formatted message.
+        """
+        val_pre, val_post = wrap_value if wrap_value is not None else ("", "")
+
+        msg_id, cycles = struct.unpack("<BI", payload)
+        if msg_id not in self._messages:
+            raise MessageNotFoundError(msg_id)
+
+        edge = "begin" if span_msg_id == SPAN_BEGIN_MESSAGE_ID else "end"
+        return f'Span {edge} "{self._messages[msg_id].message_template}" @ {val_pre}{cycles}{val_post} cycles'
+
 
 class LoggingSpec:
     """Specification of a collection of logging modules."""
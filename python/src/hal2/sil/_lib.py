@@ -1,27 +1,103 @@
+import _ctypes
 import ctypes
+import os
+import shutil
+import tempfile
 
 import hal2.sil._proxy as proxy
 
 
+def _load_private_copy(lib_path: str) -> ctypes.CDLL:
+    """
+    Loads a private copy of a shared library. The dynamic loader returns the same handle when a path is loaded twice,
+    so the load goes through a copy of the library at a unique path, which gets its own globals.
+
+    Args:
+        lib_path: Shared library path.
+
+    Returns:
+        Loaded copy of the library.
+    """
+
+    fd, copy_path = tempfile.mkstemp(prefix=f"{os.path.splitext(os.path.basename(lib_path))[0]}-", suffix=".so")
+    try:
+        with os.fdopen(fd, "wb") as copy, open(lib_path, "rb") as original:
+            shutil.copyfileobj(original, copy)
+
+        # The loaded library stays mapped after the copy is removed
+        return ctypes.CDLL(copy_path, mode=os.RTLD_NOW | os.RTLD_LOCAL)
+    finally:
+        os.unlink(copy_path)
+
+
 class SilLib:
     """
-    Represents a SIL application shared library. Provides access to a SIL proxy.
+    Represents a SIL application shared library. Provides access to a SIL proxy. Every instance simulates its own
+    system. The first live instance of a library loads it from its path, and every further live instance of the same
+    library loads a private copy of it, so several instances can be simulated side by side without sharing the globals
+    of the application.
+
+    Copies are unloaded when their instance is deleted. Symbols with GNU unique binding (GCC's default for inline and
+    template statics) are still shared between copies, and keep a copy mapped until the process exits, so libraries
+    should be built with Clang, or with GCC and -fno-gnu-unique.
     """
 
+    # Real paths of the libraries that are loaded from their path by a live instance
+    _paths_in_use: set[str] = set()
+
     _c: ctypes.CDLL
 
-    def __init__(self, lib_path: str):
+    _path_in_use: str | None
+
+    _is_copy: bool
+
+    _backend: proxy.ExecutionBackend
+
+    _handle: int
+
+    def __init__(self, lib_path: str, backend: proxy.ExecutionBackend = proxy.ExecutionBackend.THREADS):
         """
         Constructor.
 
         Args:
             lib_path: SIL library path.
+            backend: Execution backend of the simulated tasks.
         """
 
-        self._c = ctypes.cdll.LoadLibrary(lib_path)
+        real_path = os.path.realpath(lib_path)
+        if real_path in SilLib._paths_in_use:
+            self._c = _load_private_copy(lib_path)
+            self._is_copy = True
+            self._path_in_use = None
+        else:
+            self._c = ctypes.cdll.LoadLibrary(lib_path)
+            self._is_copy = False
+            self._path_in_use = real_path
+            SilLib._paths_in_use.add(real_path)
+        self._backend = backend
+
+        self._create_system = proxy._func_ptr(self._c.Sil_CreateSystem, [], ctypes.c_void_p)
+        self._destroy_system = proxy._func_ptr(self._c.Sil_DestroySystem, [ctypes.c_void_p], None)
+
+        self._handle = self._create_system()
+        if not self._handle:
+            raise RuntimeError("Unable to create SIL system")
+
+    def __del__(self):
+        if getattr(self, "_handle", None):
+            self._destroy_system(self._handle)
+            self._handle = None
+
+        if getattr(self, "_is_copy", False):
+            _ctypes.dlclose(self._c._handle)
+            self._is_copy = False
+        if getattr(self, "_path_in_use", None):
+            SilLib._paths_in_use.discard(self._path_in_use)
+            self._path_in_use = None
 
     def __enter__(self):
         with self.proxy() as p:
+            p.sched_set_execution_backend(self._backend)
             p.app_init()
             p.sched_start()
 
@@ -30,6 +106,7 @@ class SilLib:
     def __exit__(self, exc_type, exc_val, exc_tb):
         with self.proxy() as p:
             p.sched_shutdown(1000)
+            p.stop_vcd_recording()
             p.app_deinit()
 
     def proxy(self) -> proxy.SilProxy:
@@ -39,4 +116,4 @@ class SilLib:
         Returns:
             SIL proxy.
         """
-        return proxy.SilProxy(self._c)
+        return proxy.SilProxy(self._c, self._handle)
@@ -1,6 +1,53 @@
 from typing import Optional, Callable
 
+import array
 import ctypes
+import enum
+import functools
+import threading
+
+
+class ExecutionBackend(enum.IntEnum):
+    """
+    Execution backend of simulated tasks.
+    """
+
+    THREADS = 0
+    """Every task runs on its own host thread."""
+
+    FIBERS = 1
+    """All tasks run as fibers on the thread running the scheduler."""
+
+
+class GpioWaveformAnalysis(ctypes.Structure):
+    """
+    Result of a waveform analysis of captured GPIO edges.
+    """
+
+    _fields_ = [
+        ("n_periods", ctypes.c_uint64),
+        ("n_glitches", ctypes.c_uint64),
+        ("mean_frequency_hz", ctypes.c_double),
+        ("mean_duty_cycle", ctypes.c_double),
+        ("min_period_us", ctypes.c_uint64),
+        ("max_period_us", ctypes.c_uint64),
+        ("min_duty_cycle", ctypes.c_double),
+        ("max_duty_cycle", ctypes.c_double),
+        ("period_stddev_us", ctypes.c_double),
+    ]
+
+
+class SchedTaskStats(ctypes.Structure):
+    """
+    Execution statistics of a simulated task.
+    """
+
+    _fields_ = [
+        ("cpu_time_us", ctypes.c_uint64),
+        ("blocked_time_us", ctypes.c_uint64),
+        ("n_activations", ctypes.c_uint64),
+        ("n_preemptions", ctypes.c_uint64),
+    ]
 
 
 def _func_ptr(ptr, argtypes: list, restype):
@@ -9,6 +56,10 @@ def _func_ptr(ptr, argtypes: list, restype):
     return ptr
 
 
+def _sys_func_ptr(ptr, handle: int, argtypes: list, restype):
+    return functools.partial(_func_ptr(ptr, [ctypes.c_void_p, *argtypes], restype), handle)
+
+
 class SilProxy:
     """
     Provides a proxy to a SIL library, which ensures exception handling during calls through
@@ -17,96 +68,196 @@ class SilProxy:
 
     _c: ctypes.CDLL
 
+    _handle: int
+
     _exception: Optional[Exception]
 
     _parent: Optional["SilProxy"]
 
-    _active_proxy: Optional["SilProxy"] = None
+    # Proxies can be active on several threads at once, e.g. when simulating several systems in parallel
+    _active = threading.local()
 
-    def __init__(self, dll: ctypes.CDLL, parent: Optional["SilProxy"] = None):
+    def __init__(self, dll: ctypes.CDLL, handle: int, parent: Optional["SilProxy"] = None):
         """
         Constructor.
 
         Args:
             dll: SIL shared library.
+            handle: Handle of the simulated system to operate on.
         """
 
         self._c = dll
+        self._handle = handle
         self._exception = None
         self._parent = parent
 
         # General functions
         self._app_init = _func_ptr(self._c.App_Init, [], None)
         self._app_deinit = _func_ptr(self._c.App_DeInit, [], None)
+        self._set_current_system = _func_ptr(self._c.Sil_SetCurrentSystem, [ctypes.c_void_p], None)
 
         # Scheduler-related functions
-        self._sched_start = _func_ptr(self._c.Sched_Start, [], None)
-        self._sched_shutdown = _func_ptr(self._c.Sched_Shutdown, [ctypes.c_size_t], None)
+        self._sched_set_execution_backend = _sys_func_ptr(
+            self._c.Sched_SetExecutionBackend, self._handle, [ctypes.c_int], ctypes.c_bool
+        )
+        self._sched_start = _sys_func_ptr(self._c.Sched_Start, self._handle, [], None)
+        self._sched_shutdown = _sys_func_ptr(self._c.Sched_Shutdown, self._handle, [ctypes.c_size_t], None)
+
+        self._sched_run_until = _sys_func_ptr(self._c.Sched_RunUntil, self._handle, [ctypes.c_uint64], None)
+        self._sched_run_until_next_time_point = _sys_func_ptr(
+            self._c.Sched_RunUntilNextTimePoint, self._handle, [ctypes.c_uint64], ctypes.c_bool
+        )
+        self._sched_now = _sys_func_ptr(self._c.Sched_Now, self._handle, [], ctypes.c_uint64)
+        self._sched_is_snapshot_safe = _sys_func_ptr(self._c.Sched_IsSnapshotSafe, self._handle, [], ctypes.c_bool)
+        self._sched_set_cpu_scale = _sys_func_ptr(
+            self._c.Sched_SetCpuScale, self._handle, [ctypes.c_double], ctypes.c_bool
+        )
+        self._sched_enable_cpu_report = _sys_func_ptr(
+            self._c.Sched_EnableCpuReport, self._handle, [ctypes.c_bool], None
+        )
+        self._sched_get_task_count = _sys_func_ptr(self._c.Sched_GetTaskCount, self._handle, [], ctypes.c_size_t)
+        self._sched_get_task_name = _sys_func_ptr(
+            self._c.Sched_GetTaskName, self._handle, [ctypes.c_size_t], ctypes.c_char_p
+        )
+        self._sched_get_task_stats = _sys_func_ptr(
+            self._c.Sched_GetTaskStats,
+            self._handle,
+            [ctypes.c_size_t, ctypes.POINTER(SchedTaskStats)],
+            ctypes.c_bool,
+        )
 
-        self._sched_run_until = _func_ptr(self._c.Sched_RunUntil, [ctypes.c_uint64], None)
-        self._sched_run_until_next_time_point = _func_ptr(
-            self._c.Sched_RunUntilNextTimePoint, [ctypes.c_uint64], ctypes.c_bool
+        # Recording-related functions
+        self._start_vcd_recording = _sys_func_ptr(
+            self._c.Sil_StartVcdRecording, self._handle, [ctypes.c_char_p, ctypes.c_size_t], ctypes.c_bool
         )
-        self._sched_now = _func_ptr(self._c.Sched_Now, [], ctypes.c_uint64)
+        self._stop_vcd_recording = _sys_func_ptr(self._c.Sil_StopVcdRecording, self._handle, [], ctypes.c_bool)
 
         # Error handling-related functions
-        self._set_err_callback = _func_ptr(self._c.SetErrorCallback, [ctypes.c_void_p], None)
-        self._clear_err_callback = _func_ptr(self._c.ClearErrorCallback, [], None)
+        self._set_err_callback = _sys_func_ptr(self._c.SetErrorCallback, self._handle, [ctypes.c_void_p], None)
+        self._clear_err_callback = _sys_func_ptr(self._c.ClearErrorCallback, self._handle, [], None)
 
         callback_t = ctypes.CFUNCTYPE(None, ctypes.c_char_p, use_errno=False, use_last_error=False)
         self._err_callback = callback_t(self._err_callback)
 
         # GPIO-related functions
-        self._gpio_get_count = _func_ptr(self._c.Gpio_GetGpioCount, [], ctypes.c_size_t)
-        self._gpio_get_name = _func_ptr(self._c.Gpio_GetGpioName, [ctypes.c_size_t], ctypes.c_char_p)
-        self._gpio_set_input_pin_state = _func_ptr(
-            self._c.Gpio_SetInputPinState, [ctypes.c_size_t, ctypes.c_bool], None
+        self._gpio_get_count = _sys_func_ptr(self._c.Gpio_GetGpioCount, self._handle, [], ctypes.c_size_t)
+        self._gpio_get_name = _sys_func_ptr(self._c.Gpio_GetGpioName, self._handle, [ctypes.c_size_t], ctypes.c_char_p)
+        self._gpio_set_input_pin_state = _sys_func_ptr(
+            self._c.Gpio_SetInputPinState, self._handle, [ctypes.c_size_t, ctypes.c_bool], None
+        )
+        self._gpio_get_output_pin_state = _sys_func_ptr(
+            self._c.Gpio_GetOutputPinState, self._handle, [ctypes.c_size_t], ctypes.c_bool
         )
-        self._gpio_get_output_pin_state = _func_ptr(self._c.Gpio_GetOutputPinState, [ctypes.c_size_t], ctypes.c_bool)
-        self._gpio_set_output_pin_edge_callback = _func_ptr(
-            self._c.Gpio_SetOutputPinEdgeCallback, [ctypes.c_size_t, ctypes.c_void_p], None
+        self._gpio_set_output_pin_edge_callback = _sys_func_ptr(
+            self._c.Gpio_SetOutputPinEdgeCallback, self._handle, [ctypes.c_size_t, ctypes.c_void_p], None
         )
-        self._gpio_clear_output_pin_edge_callback = _func_ptr(
-            self._c.Gpio_ClearOutputPinEdgeCallback, [ctypes.c_size_t], None
+        self._gpio_clear_output_pin_edge_callback = _sys_func_ptr(
+            self._c.Gpio_ClearOutputPinEdgeCallback, self._handle, [ctypes.c_size_t], None
+        )
+
+        self._gpio_enable_edge_capture = _sys_func_ptr(
+            self._c.Gpio_EnableEdgeCapture, self._handle, [ctypes.c_size_t, ctypes.c_size_t], ctypes.c_bool
+        )
+        self._gpio_read_edges = _sys_func_ptr(
+            self._c.Gpio_ReadEdges,
+            self._handle,
+            [ctypes.c_size_t, ctypes.c_void_p, ctypes.c_void_p, ctypes.c_size_t],
+            ctypes.c_size_t,
+        )
+        self._gpio_get_edge_capture_drop_count = _sys_func_ptr(
+            self._c.Gpio_GetEdgeCaptureDropCount, self._handle, [ctypes.c_size_t], ctypes.c_size_t
+        )
+        self._gpio_analyze_waveform = _sys_func_ptr(
+            self._c.Gpio_AnalyzeWaveform,
+            self._handle,
+            [
+                ctypes.c_size_t,
+                ctypes.c_uint64,
+                ctypes.c_uint64,
+                ctypes.POINTER(ctypes.c_uint64),
+                ctypes.c_size_t,
+                ctypes.POINTER(GpioWaveformAnalysis),
+            ],
+            ctypes.c_bool,
         )
 
         # UART-related functions
-        self._uart_get_count = _func_ptr(self._c.Uart_GetUartCount, [], ctypes.c_size_t)
-        self._uart_get_name = _func_ptr(self._c.Uart_GetUartName, [ctypes.c_size_t], ctypes.c_char_p)
-        self._uart_simulate_receive = _func_ptr(
+        self._uart_get_count = _sys_func_ptr(self._c.Uart_GetUartCount, self._handle, [], ctypes.c_size_t)
+        self._uart_get_name = _sys_func_ptr(self._c.Uart_GetUartName, self._handle, [ctypes.c_size_t], ctypes.c_char_p)
+        self._uart_simulate_receive = _sys_func_ptr(
             self._c.Uart_SimulateReceive,
+            self._handle,
             [ctypes.c_size_t, ctypes.c_uint64, ctypes.POINTER(ctypes.c_uint8), ctypes.c_size_t],
             ctypes.c_bool,
         )
-        self._uart_set_tx_callback = _func_ptr(
-            self._c.Uart_SetTransmitCallback, [ctypes.c_size_t, ctypes.c_void_p], ctypes.c_bool
+        self._uart_set_tx_callback = _sys_func_ptr(
+            self._c.Uart_SetTransmitCallback, self._handle, [ctypes.c_size_t, ctypes.c_void_p], ctypes.c_bool
+        )
+        self._uart_simulate_receive_batch = _sys_func_ptr(
+            self._c.Uart_SimulateReceiveBatch,
+            self._handle,
+            [
+                ctypes.c_size_t,
+                ctypes.POINTER(ctypes.c_uint64),
+                ctypes.POINTER(ctypes.c_uint8),
+                ctypes.POINTER(ctypes.c_size_t),
+                ctypes.c_size_t,
+            ],
+            ctypes.c_bool,
+        )
+        self._uart_clear_tx_callback = _sys_func_ptr(
+            self._c.Uart_ClearTransmitCallback, self._handle, [ctypes.c_size_t], ctypes.c_bool
+        )
+        self._uart_enable_tx_capture = _sys_func_ptr(
+            self._c.Uart_EnableTxCapture, self._handle, [ctypes.c_size_t, ctypes.c_size_t], ctypes.c_bool
+        )
+        self._uart_read_tx_capture = _sys_func_ptr(
+            self._c.Uart_ReadTxCapture,
+            self._handle,
+            [ctypes.c_size_t, ctypes.POINTER(ctypes.c_uint8), ctypes.c_size_t],
+            ctypes.c_size_t,
+        )
+        self._uart_get_tx_capture_drop_count = _sys_func_ptr(
+            self._c.Uart_GetTxCaptureDropCount, self._handle, [ctypes.c_size_t], ctypes.c_size_t
+        )
+        self._uart_set_tx_start_callback = _sys_func_ptr(
+            self._c.Uart_SetTransmitStartCallback, self._handle, [ctypes.c_size_t, ctypes.c_void_p], ctypes.c_bool
+        )
+        self._uart_clear_tx_start_callback = _sys_func_ptr(
+            self._c.Uart_ClearTransmitStartCallback, self._handle, [ctypes.c_size_t], ctypes.c_bool
         )
 
         # SPI-related functions
-        self._spi_get_master_count = _func_ptr(self._c.Spi_GetSpiMasterCount, [], ctypes.c_size_t)
-        self._spi_get_master_name = _func_ptr(self._c.Spi_GetSpiMasterName, [ctypes.c_size_t], ctypes.c_char_p)
-        self._spi_simulate_master_miso = _func_ptr(
+        self._spi_get_master_count = _sys_func_ptr(self._c.Spi_GetSpiMasterCount, self._handle, [], ctypes.c_size_t)
+        self._spi_get_master_name = _sys_func_ptr(
+            self._c.Spi_GetSpiMasterName, self._handle, [ctypes.c_size_t], ctypes.c_char_p
+        )
+        self._spi_simulate_master_miso = _sys_func_ptr(
             self._c.Spi_SimulateSpiMasterMiso,
+            self._handle,
             [ctypes.c_size_t, ctypes.c_uint64, ctypes.POINTER(ctypes.c_uint8), ctypes.c_size_t],
             ctypes.c_bool,
         )
-        self._spi_set_master_miso_size_hint_callback = _func_ptr(
-            self._c.Spi_SetSpiMasterMisoSizeHintCallback, [ctypes.c_size_t, ctypes.c_void_p], ctypes.c_bool
+        self._spi_set_master_miso_size_hint_callback = _sys_func_ptr(
+            self._c.Spi_SetSpiMasterMisoSizeHintCallback,
+            self._handle,
+            [ctypes.c_size_t, ctypes.c_void_p],
+            ctypes.c_bool,
         )
-        self._spi_clear_master_miso_size_hint_callback = _func_ptr(
-            self._c.Spi_ClearSpiMasterMisoSizeHintCallback, [ctypes.c_size_t], ctypes.c_bool
+        self._spi_clear_master_miso_size_hint_callback = _sys_func_ptr(
+            self._c.Spi_ClearSpiMasterMisoSizeHintCallback, self._handle, [ctypes.c_size_t], ctypes.c_bool
         )
-        self._spi_set_master_mosi_callback = _func_ptr(
-            self._c.Spi_SetSpiMasterMosiCallback, [ctypes.c_size_t, ctypes.c_void_p], ctypes.c_bool
+        self._spi_set_master_mosi_callback = _sys_func_ptr(
+            self._c.Spi_SetSpiMasterMosiCallback, self._handle, [ctypes.c_size_t, ctypes.c_void_p], ctypes.c_bool
         )
-        self._spi_clear_master_mosi_callback = _func_ptr(
-            self._c.Spi_ClearSpiMasterMosiCallback, [ctypes.c_size_t], ctypes.c_bool
+        self._spi_clear_master_mosi_callback = _sys_func_ptr(
+            self._c.Spi_ClearSpiMasterMosiCallback, self._handle, [ctypes.c_size_t], ctypes.c_bool
         )
 
     def _activate(self):
         self._set_err_callback(self._err_callback)
-        self._parent = SilProxy._active_proxy
-        SilProxy._active_proxy = self
+        self._parent = getattr(SilProxy._active, "proxy", None)
+        SilProxy._active.proxy = self
 
     def _check_errors(self):
         self._clear_err_callback()
@@ -124,17 +275,34 @@ class SilProxy:
         if self._parent is not None:
             self._parent._activate()  # noqa
 
-        SilProxy._active_proxy = self._parent
+        SilProxy._active.proxy = self._parent
 
         return None
 
     def app_init(self):
-        """Initializes the SIL application."""
-        self._app_init()
+        """Initializes the SIL application, with the simulated system of this proxy as the current system."""
+        self._set_current_system(self._handle)
+        try:
+            self._app_init()
+        finally:
+            self._set_current_system(None)
 
     def app_deinit(self):
-        """Deinitializes the SIL application."""
-        self._app_deinit()
+        """Deinitializes the SIL application, with the simulated system of this proxy as the current system."""
+        self._set_current_system(self._handle)
+        try:
+            self._app_deinit()
+        finally:
+            self._set_current_system(None)
+
+    def sched_set_execution_backend(self, backend: ExecutionBackend):
+        """
+        Selects the execution backend of simulated tasks. Must be called before the application is initialized.
+
+        Args:
+            backend: Execution backend.
+        """
+        self._sched_set_execution_backend(int(backend))
 
     def sched_start(self):
         """Starts the scheduler."""
@@ -173,6 +341,98 @@ class SilProxy:
 
         return self._sched_now()
 
+    @property
+    def is_snapshot_safe(self) -> bool:
+        """
+        Whether the complete simulation state lives in the process memory, so a forked process can continue it. Not
+        the case while tasks run on threads of their own, or while a VCD recording runs.
+        """
+
+        return self._sched_is_snapshot_safe()
+
+    def set_cpu_scale(self, scale: float) -> bool:
+        """
+        Sets the scale of the calibrated cost model, which charges the host CPU time that tasks run for to them.
+
+        Args:
+            scale: Simulated time per host CPU time, 0 disables the model.
+
+        Returns:
+            Whether the scale was set.
+        """
+
+        return self._sched_set_cpu_scale(scale)
+
+    def enable_cpu_report(self, enable: bool):
+        """
+        Enables or disables the report of the execution statistics of all tasks at shutdown.
+
+        Args:
+            enable: Whether to print the report.
+        """
+
+        self._sched_enable_cpu_report(enable)
+
+    @property
+    def task_count(self) -> int:
+        """Number of tasks in the simulated system."""
+
+        return self._sched_get_task_count()
+
+    def get_task_name(self, index: int) -> str:
+        """
+        Returns the name of a task
+
+        Args:
+            index: Index of the task, in the order of creation
+
+        Returns:
+            Task name
+        """
+
+        return self._sched_get_task_name(index).decode("utf-8")
+
+    def get_task_stats(self, index: int) -> Optional[SchedTaskStats]:
+        """
+        Returns the execution statistics of a task
+
+        Args:
+            index: Index of the task, in the order of creation
+
+        Returns:
+            Execution statistics, or None if the index is invalid
+        """
+
+        stats = SchedTaskStats()
+        if not self._sched_get_task_stats(index, ctypes.byref(stats)):
+            return None
+
+        return stats
+
+    def start_vcd_recording(self, path: str, buffer_size: int) -> bool:
+        """
+        Starts recording the run state of the tasks and the activity of the peripherals to a VCD file.
+
+        Args:
+            path: Path of the VCD file.
+            buffer_size: Size of the write buffer in bytes.
+
+        Returns:
+            Whether the recording was started.
+        """
+
+        return self._start_vcd_recording(path.encode(), buffer_size)
+
+    def stop_vcd_recording(self) -> bool:
+        """
+        Stops the VCD recording, if any, and closes the file.
+
+        Returns:
+            Whether the file was written successfully.
+        """
+
+        return self._stop_vcd_recording()
+
     @property
     def gpio_count(self) -> int:
         """Number of GPIOs in the simulated system."""
@@ -237,6 +497,80 @@ class SilProxy:
 
         self._gpio_clear_output_pin_edge_callback(index)
 
+    def enable_gpio_edge_capture(self, index: int, capacity: int) -> bool:
+        """
+        Enables capturing the edges of a GPIO into a preallocated ring buffer.
+
+        Args:
+            index: Index of the GPIO to capture the edges of.
+            capacity: Capacity of the ring buffer in edges, 0 disables the capture.
+
+        Returns:
+            Whether enabling the capture was successful.
+        """
+
+        return self._gpio_enable_edge_capture(index, capacity)
+
+    def read_gpio_edges(self, index: int, max_count: int) -> tuple[array.array, array.array]:
+        """
+        Moves the oldest captured edges of a GPIO out of its ring buffer.
+
+        Args:
+            index: Index of the GPIO to read the edges of.
+            max_count: Maximum number of edges to read.
+
+        Returns:
+            Timestamps in microseconds and edge types of the edges. Both support the buffer protocol, e.g. for
+            ``numpy.frombuffer``.
+        """
+
+        timestamps = array.array("Q", bytes(8 * max_count))
+        edges = array.array("B", bytes(max_count))
+
+        n = self._gpio_read_edges(index, timestamps.buffer_info()[0], edges.buffer_info()[0], max_count)
+
+        del timestamps[n:]
+        del edges[n:]
+        return timestamps, edges
+
+    def get_gpio_edge_capture_drop_count(self, index: int) -> int:
+        """
+        Returns the number of edges that were overwritten in the capture of a GPIO before they were read.
+
+        Args:
+            index: Index of the GPIO.
+
+        Returns:
+            Number of dropped edges.
+        """
+
+        return self._gpio_get_edge_capture_drop_count(index)
+
+    def analyze_gpio_waveform(
+        self, index: int, glitch_threshold_us: int, jitter_bin_width_us: int, n_jitter_bins: int
+    ) -> tuple[GpioWaveformAnalysis, list[int]]:
+        """
+        Analyzes the square wave of the captured edges of a GPIO, without consuming them.
+
+        Args:
+            index: Index of the GPIO.
+            glitch_threshold_us: Pulses shorter than this are glitches, and are removed before the analysis.
+            jitter_bin_width_us: Width of a bin of the period jitter histogram.
+            n_jitter_bins: Number of bins of the period jitter histogram.
+
+        Returns:
+            Analysis result and period jitter histogram.
+        """
+
+        result = GpioWaveformAnalysis()
+        histogram = (ctypes.c_uint64 * n_jitter_bins)()
+
+        self._gpio_analyze_waveform(
+            index, glitch_threshold_us, jitter_bin_width_us, histogram, n_jitter_bins, ctypes.byref(result)
+        )
+
+        return result, list(histogram)
+
     @property
     def uart_count(self) -> int:
         """Number of UARTs in the simulated system."""
@@ -285,6 +619,113 @@ class SilProxy:
 
         self._uart_set_tx_callback(index, callback)
 
+    def simulate_uart_receive_batch(self, index: int, chunks: list[tuple[int, bytes]]) -> bool:
+        """
+        Simulates any number of receivals of data of the simulated UART in a single call.
+
+        Args:
+            index: UART index to simulate the receives for.
+            chunks: Pairs of timestamp and data to receive at that timestamp.
+
+        Returns:
+            Whether the receives were successful.
+        """
+
+        n = len(chunks)
+        data = b"".join(chunk for _, chunk in chunks)
+
+        timestamps = (ctypes.c_uint64 * n)(*(timestamp_us for timestamp_us, _ in chunks))
+        lens = (ctypes.c_size_t * n)(*(len(chunk) for _, chunk in chunks))
+        buf = ctypes.create_string_buffer(data)
+        buf_u8 = ctypes.cast(buf, ctypes.POINTER(ctypes.c_uint8))
+
+        return self._uart_simulate_receive_batch(index, timestamps, buf_u8, lens, n)
+
+    def clear_uart_tx_callback(self, index: int) -> bool:
+        """
+        Clears the transmit callback of a simulated UART.
+
+        Args:
+            index: UART index for which to clear the callback.
+
+        Returns:
+            Whether clearing the callback was successful.
+        """
+
+        return self._uart_clear_tx_callback(index)
+
+    def enable_uart_tx_capture(self, index: int, capacity: int) -> bool:
+        """
+        Enables capturing the transmitted frames of a simulated UART into a ring buffer.
+
+        Args:
+            index: UART index for which to enable the capture.
+            capacity: Capacity of the ring buffer in bytes, 0 disables the capture.
+
+        Returns:
+            Whether enabling the capture was successful.
+        """
+
+        return self._uart_enable_tx_capture(index, capacity)
+
+    def read_uart_tx_capture(self, index: int, max_size: int) -> bytes:
+        """
+        Reads complete records from the TX capture of a simulated UART. Every record consists of a 64-bit timestamp
+        and a 32-bit size in native byte order, followed by the frame data.
+
+        Args:
+            index: UART index to read the capture of.
+            max_size: Maximum number of bytes to read.
+
+        Returns:
+            Captured records.
+        """
+
+        buf = (ctypes.c_uint8 * max_size)()
+        n = self._uart_read_tx_capture(index, buf, max_size)
+        return bytes(buf[:n])
+
+    def get_uart_tx_capture_drop_count(self, index: int) -> int:
+        """
+        Returns the number of frames that the TX capture of a simulated UART dropped.
+
+        Args:
+            index: UART index.
+
+        Returns:
+            Number of dropped frames.
+        """
+
+        return self._uart_get_tx_capture_drop_count(index)
+
+    def set_uart_tx_start_callback(self, index: int, callback) -> bool:
+        """
+        Sets the callback for when a simulated UART starts transmitting data. The callback receives the start and end
+        time of the transmission in microseconds, followed by the data.
+
+        Args:
+            index: UART index for which to register the callback.
+            callback: Callback to set.
+
+        Returns:
+            Whether setting the callback was successful.
+        """
+
+        return self._uart_set_tx_start_callback(index, callback)
+
+    def clear_uart_tx_start_callback(self, index: int) -> bool:
+        """
+        Clears the transmit start callback of a simulated UART.
+
+        Args:
+            index: UART index for which to clear the callback.
+
+        Returns:
+            Whether clearing the callback was successful.
+        """
+
+        return self._uart_clear_tx_start_callback(index)
+
     @property
     def spi_master_count(self) -> int:
         """Number of SPI masters in the simulated system."""
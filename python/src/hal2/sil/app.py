@@ -1,6 +1,7 @@
 from typing import Callable
 
 import hal2.sil._lib as sil_lib
+from hal2.sil._proxy import ExecutionBackend
 
 import hal2.sil.scheduler as sched
 
@@ -32,15 +33,17 @@ class SilApp:
 
     _sil_lib: sil_lib.SilLib
 
-    def __init__(self, lib_path: str):
+    def __init__(self, lib_path: str, backend: ExecutionBackend = ExecutionBackend.THREADS):
         """
         Constructor.
 
         Args:
             lib_path: Path to the SIL library to simulate.
+            backend: Execution backend of the simulated tasks. Fibers avoid a host thread switch per simulated
+                context switch.
         """
 
-        self._sil_lib = sil_lib.SilLib(lib_path)
+        self._sil_lib = sil_lib.SilLib(lib_path, backend)
 
     def __enter__(self):
         self._sil_lib.__enter__()
@@ -123,10 +126,43 @@ class SilApp:
         with self._sil_lib.proxy() as proxy:
             return proxy.now
 
+    @property
+    def is_snapshot_safe(self) -> bool:
+        """
+        Whether the application can be snapshotted, which requires all tasks to run as fibers and no VCD recording
+        to run.
+        """
+
+        with self._sil_lib.proxy() as proxy:
+            return proxy.is_snapshot_safe
+
     def simulate_until(self, timestamp_us: int):
         with self._sil_lib.proxy() as proxy:
             proxy.simulate_until(timestamp_us)
 
+    def start_vcd_recording(self, path: str, buffer_size: int = 64 * 1024):
+        """
+        Starts recording a waveform of the application to a VCD file, which can be viewed with e.g. GTKWave. Records
+        the run state of the tasks, the GPIO levels, and the bytes on the UARTs and SPI masters, keyed on the simulated
+        time. The file is written through a buffer of fixed size, so that long simulations do not accumulate memory.
+        Must be called after the application was initialized, and is stopped when the application shuts down.
+
+        Args:
+            path: Path of the VCD file.
+            buffer_size: Size of the write buffer in bytes.
+        """
+
+        with self._sil_lib.proxy() as proxy:
+            proxy.start_vcd_recording(path, buffer_size)
+
+    def stop_vcd_recording(self):
+        """
+        Stops the VCD recording, if any, and closes the file.
+        """
+
+        with self._sil_lib.proxy() as proxy:
+            proxy.stop_vcd_recording()
+
     def _find_gpio_index(self, name: str) -> int:
         with self._sil_lib.proxy() as proxy:
             for i in range(proxy.gpio_count):
@@ -1,6 +1,8 @@
 from typing import Callable
 
+import array
 import ctypes
+import dataclasses
 import enum
 
 import hal2.sil._lib as sil_lib
@@ -13,6 +15,29 @@ class Edge(enum.IntEnum):
     FALLING = 1
 
 
+@dataclasses.dataclass
+class WaveformProperties:
+    """
+    Properties of a square wave, as measured by the native analyzer.
+    """
+
+    mean_frequency: float
+    mean_duty_cycle: float
+
+    full_periods: int
+    glitches: int
+
+    min_period: float
+    max_period: float
+    period_stddev: float
+
+    min_duty_cycle: float
+    max_duty_cycle: float
+
+    jitter_histogram: list[int]
+    """Number of periods per deviation from the mean period, the center bin starts at the mean period."""
+
+
 class Gpo:
     """
     Represents a General-Purpose Output (GPO) in a SIL application.
@@ -58,6 +83,79 @@ class Gpo:
 
             return edge_monitor.edges
 
+    def enable_edge_capture(self, capacity: int = 64 * 1024):
+        """
+        Captures the edges of the GPO into a preallocated ring buffer in the simulated system, instead of passing
+        every edge to Python separately. When the ring buffer is full, the oldest edges are overwritten.
+
+        Args:
+            capacity: Capacity of the ring buffer in edges.
+        """
+
+        with self._lib.proxy() as proxy:
+            proxy.enable_gpio_edge_capture(self._index, capacity)
+
+    def read_edges(self, max_count: int = 64 * 1024) -> tuple[array.array, array.array]:
+        """
+        Moves the oldest captured edges out of the ring buffer, after which :meth:`analyze_waveform` no longer sees
+        them.
+
+        Args:
+            max_count: Maximum number of edges to read.
+
+        Returns:
+            Timestamps in microseconds and :class:`Edge` values of the edges. Both support the buffer protocol, e.g.
+            for ``numpy.frombuffer``.
+        """
+
+        with self._lib.proxy() as proxy:
+            return proxy.read_gpio_edges(self._index, max_count)
+
+    @property
+    def edge_capture_drop_count(self) -> int:
+        """Number of captured edges that were overwritten before they were read."""
+
+        with self._lib.proxy() as proxy:
+            return proxy.get_gpio_edge_capture_drop_count(self._index)
+
+    def analyze_waveform(
+        self, glitch_threshold_us: int = 0, jitter_bin_width_us: int = 1, n_jitter_bins: int = 0
+    ) -> WaveformProperties:
+        """
+        Analyzes the square wave of the captured edges in the simulated system, without consuming them. Periods are
+        measured from rising edge to rising edge. Only the edges that are still in the ring buffer are analyzed: edges
+        that :meth:`read_edges` moved out of the ring are not part of the analysis, so analyze the waveform before
+        reading the edges to do both.
+
+        Args:
+            glitch_threshold_us: Pulses shorter than this are glitches, and are removed before the analysis.
+            jitter_bin_width_us: Width of a bin of the period jitter histogram.
+            n_jitter_bins: Number of bins of the period jitter histogram.
+
+        Returns:
+            Properties of the square wave.
+        """
+
+        us = 1_000_000
+
+        with self._lib.proxy() as proxy:
+            result, histogram = proxy.analyze_gpio_waveform(
+                self._index, glitch_threshold_us, jitter_bin_width_us, n_jitter_bins
+            )
+
+        return WaveformProperties(
+            mean_frequency=result.mean_frequency_hz,
+            mean_duty_cycle=result.mean_duty_cycle,
+            full_periods=result.n_periods,
+            glitches=result.n_glitches,
+            min_period=result.min_period_us / us,
+            max_period=result.max_period_us / us,
+            period_stddev=result.period_stddev_us / us,
+            min_duty_cycle=result.min_duty_cycle,
+            max_duty_cycle=result.max_duty_cycle,
+            jitter_histogram=histogram,
+        )
+
     def register_edge_callback(self, callback: Callable[[Edge], None]):
         """
         Registers an edge callback with the GPIO pin
@@ -1,6 +1,7 @@
-from typing import Optional
+from typing import Callable, Optional
 
 import ctypes
+import struct
 
 import hal2.sil._lib as sil_lib
 
@@ -12,6 +13,11 @@ class Uart:
 
     _rx_data: bytes
 
+    _capture_capacity: int
+
+    # Header of a TX capture record: timestamp and frame size, in native byte order
+    _CaptureHeader = struct.Struct("=QI")
+
     def __init__(self, lib: sil_lib.SilLib, index: int):
         """
         Constructor.
@@ -23,6 +29,7 @@ class Uart:
 
         self._lib = lib
         self._index = index
+        self._capture_capacity = 0
         callback_t = ctypes.CFUNCTYPE(
             None, ctypes.POINTER(ctypes.c_uint8), ctypes.c_size_t, use_errno=False, use_last_error=False
         )
@@ -53,6 +60,69 @@ class Uart:
 
             return proxy.simulate_uart_receive(self._index, timestamp_us, data)
 
+    def transmit_batch(self, chunks: list[tuple[int, bytes]]) -> bool:
+        """
+        Simulates any number of data transmissions to the simulated UART in a single call.
+
+        Args:
+            chunks: Pairs of timestamp in microseconds and data to transmit at that timestamp.
+
+        Returns:
+            Whether the transmissions were successful.
+        """
+
+        with self._lib.proxy() as proxy:
+            return proxy.simulate_uart_receive_batch(self._index, chunks)
+
+    def enable_tx_capture(self, capacity: int = 64 * 1024):
+        """
+        Captures the data transmitted by the simulated UART into a ring buffer, instead of passing every frame to
+        Python separately. Use :meth:`read_tx_capture` to drain the captured frames in bulk.
+
+        Args:
+            capacity: Capacity of the ring buffer in bytes. When the ring buffer is full, the oldest frames are
+                dropped. A capacity of 0 disables capturing, after which every frame is passed to Python again.
+        """
+
+        with self._lib.proxy() as proxy:
+            if capacity > 0:
+                proxy.clear_uart_tx_callback(self._index)
+            else:
+                proxy.set_uart_tx_callback(self._index, self._callback)
+
+            proxy.enable_uart_tx_capture(self._index, capacity)
+
+        self._capture_capacity = capacity
+
+    def read_tx_capture(self) -> list[tuple[int, bytes]]:
+        """
+        Drains the frames captured since the last call.
+
+        Returns:
+            Pairs of the timestamp at which the transmission ended and the transmitted data, oldest first.
+        """
+
+        frames = []
+
+        with self._lib.proxy() as proxy:
+            # A single record never exceeds the capacity of the ring buffer
+            while records := proxy.read_uart_tx_capture(self._index, self._capture_capacity):
+                offset = 0
+                while offset < len(records):
+                    timestamp_us, size = self._CaptureHeader.unpack_from(records, offset)
+                    offset += self._CaptureHeader.size
+                    frames.append((timestamp_us, records[offset : offset + size]))
+                    offset += size
+
+        return frames
+
+    @property
+    def tx_capture_drop_count(self) -> int:
+        """Number of frames that were dropped by the TX capture."""
+
+        with self._lib.proxy() as proxy:
+            return proxy.get_uart_tx_capture_drop_count(self._index)
+
     def receive(self, timeout: float) -> bytes:
         """
         Receives data from the simulated UART.
@@ -72,10 +142,45 @@ class Uart:
 
             # Keep on simulating events until either data is received, or the timeout is reached.
             while proxy.simulate_until_next_time_point(upper_bound_us):
+                if self._capture_capacity > 0:
+                    self._rx_data += b"".join(data for _, data in self.read_tx_capture())
+
                 if len(self._rx_data) > 0:
                     break
 
             return self._rx_data
 
+    def set_tx_start_callback(self, callback: Optional[Callable[[int, int, bytes], None]]):
+        """
+        Sets a callback for when the simulated UART starts a transmission. Unlike :meth:`receive`, the callback sees
+        a frame as soon as its transmission starts, which allows shared media to model the frame on the line.
+
+        Args:
+            callback: Callback receiving the start and end time of the transmission in microseconds, and the data.
+                If ``None``, clears the callback.
+        """
+
+        with self._lib.proxy() as proxy:
+            if callback is None:
+                proxy.clear_uart_tx_start_callback(self._index)
+                self._tx_start_callback = None
+                return
+
+            callback_t = ctypes.CFUNCTYPE(
+                None,
+                ctypes.c_uint64,
+                ctypes.c_uint64,
+                ctypes.POINTER(ctypes.c_uint8),
+                ctypes.c_size_t,
+                use_errno=False,
+                use_last_error=False,
+            )
+
+            # The C callback object must outlive its registration
+            self._tx_start_callback = callback_t(
+                lambda start_us, end_us, data, n: callback(start_us, end_us, ctypes.string_at(data, n))
+            )
+            proxy.set_uart_tx_start_callback(self._index, self._tx_start_callback)
+
     def _tx_callback(self, data, len):
         self._rx_data += ctypes.string_at(data, len)
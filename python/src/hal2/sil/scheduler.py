@@ -1,6 +1,33 @@
+from dataclasses import dataclass
+
 import hal2.sil._lib as sil_lib
 
 
+@dataclass
+class TaskStats:
+    """
+    Execution statistics of a simulated task, in simulated time.
+    """
+
+    index: int
+    """Index of the task in the order of creation."""
+
+    name: str
+    """Name of the task, which need not be unique."""
+
+    cpu_time_us: int
+    """CPU time charged to the task."""
+
+    blocked_time_us: int
+    """Time from blocking until running again."""
+
+    n_activations: int
+    """Number of times the task was resumed."""
+
+    n_preemptions: int
+    """Number of times the task was preempted by a higher-priority task."""
+
+
 class Scheduler:
     """
     Represents the simulated application scheduler
@@ -33,3 +60,50 @@ class Scheduler:
 
         with self._lib.proxy() as proxy:
             proxy.simulate_until(proxy.now + us)
+
+    def set_cpu_scale(self, scale: float):
+        """
+        Enables the calibrated cost model, which charges the host CPU time that tasks run for to them in simulated
+        time. Tasks that would overrun their period on the target then do so in the simulation as well. Code can also
+        be annotated with its CPU time on the target, which works without the model.
+
+        Args:
+            scale: Simulated time per host CPU time, e.g. 4.0 if the target runs the code four times slower than the
+                host. 0 disables the model.
+        """
+
+        with self._lib.proxy() as proxy:
+            proxy.set_cpu_scale(scale)
+
+    def enable_cpu_report(self, enable: bool = True):
+        """
+        Enables or disables printing a report of the execution statistics of all tasks when the scheduler shuts down.
+
+        Args:
+            enable: Whether to print the report.
+        """
+
+        with self._lib.proxy() as proxy:
+            proxy.enable_cpu_report(enable)
+
+    @property
+    def task_stats(self) -> list[TaskStats]:
+        """Execution statistics of all tasks, in the order of creation."""
+
+        result = []
+        with self._lib.proxy() as proxy:
+            for i in range(proxy.task_count):
+                stats = proxy.get_task_stats(i)
+                if stats is not None:
+                    result.append(
+                        TaskStats(
+                            i,
+                            proxy.get_task_name(i),
+                            stats.cpu_time_us,
+                            stats.blocked_time_us,
+                            stats.n_activations,
+                            stats.n_preemptions,
+                        )
+                    )
+
+        return result
@@ -0,0 +1,149 @@
+from typing import Callable, Iterable, Optional, TypeVar
+
+import os
+import pickle
+import sys
+import traceback
+
+import hal2.sil.app as sil_app
+
+T = TypeVar("T")
+
+
+class SilSnapshot:
+    """
+    Copy-on-write snapshot of a SIL application, based on ``fork()``.
+
+    Every run branches off the state of the application at the time the snapshot was taken, in a forked process, so
+    that many scenarios can start from a single warmed-up state instead of re-simulating everything from the epoch.
+    The application itself is left untouched by the runs. As threads do not survive a fork, all tasks of the
+    application must run as fibers, see :class:`hal2.sil.app.ExecutionBackend`. As all runs would write to the same
+    file, no VCD recording may run while the snapshot is taken.
+    """
+
+    _app: sil_app.SilApp
+
+    def __init__(self, app: sil_app.SilApp):
+        """
+        Constructor.
+
+        Args:
+            app: Application to snapshot. Must not be simulated while the snapshot is in use.
+
+        Raises:
+            RuntimeError: The platform or the application do not support snapshots.
+        """
+
+        if not hasattr(os, "fork"):
+            raise RuntimeError("Snapshots require a platform that supports fork()")
+
+        self._require_snapshot_safe(app)
+        self._app = app
+
+    def run(self, fn: Callable[[sil_app.SilApp], T]) -> T:
+        """
+        Runs a function on a copy of the application.
+
+        Args:
+            fn: Function to run, receives the copy of the application. Its result must be picklable.
+
+        Returns:
+            Result of the function.
+
+        Raises:
+            RuntimeError: The application no longer supports snapshots.
+            Exception: Exception raised by the function.
+        """
+
+        return self._unwrap(self._collect(self._fork(fn)))
+
+    def map(self, fns: Iterable[Callable[[sil_app.SilApp], T]], max_parallel: Optional[int] = None) -> list[T]:
+        """
+        Runs several functions on copies of the application, in parallel processes.
+
+        Args:
+            fns: Functions to run, each receives its own copy of the application.
+            max_parallel: Maximum number of processes to run at once. Defaults to the number of host cores.
+
+        Returns:
+            Results of the functions, in order.
+
+        Raises:
+            RuntimeError: The application no longer supports snapshots.
+            Exception: First exception raised by any of the functions.
+        """
+
+        max_parallel = max_parallel if max_parallel is not None else (os.cpu_count() or 1)
+
+        # All processes are collected before raising, so that none is left behind
+        pending = []
+        results = []
+        for fn in fns:
+            if len(pending) >= max_parallel:
+                results.append(self._collect(pending.pop(0)))
+            pending.append(self._fork(fn))
+
+        results.extend(self._collect(child) for child in pending)
+        return [self._unwrap(result) for result in results]
+
+    def _fork(self, fn: Callable[[sil_app.SilApp], T]) -> tuple[int, int]:
+        # The application may have started e.g. a VCD recording since the snapshot was taken
+        self._require_snapshot_safe(self._app)
+
+        r, w = os.pipe()
+
+        # Flush buffered output, so that it is not written by both processes
+        sys.stdout.flush()
+        sys.stderr.flush()
+
+        pid = os.fork()
+        if pid != 0:
+            os.close(w)
+            return pid, r
+
+        os.close(r)
+        try:
+            try:
+                payload = pickle.dumps((True, fn(self._app)))
+            except BaseException as e:  # noqa
+                try:
+                    payload = pickle.dumps((False, e, traceback.format_exc()))
+                except Exception:  # noqa
+                    payload = pickle.dumps((False, RuntimeError(repr(e)), traceback.format_exc()))
+
+            with os.fdopen(w, "wb") as f:
+                f.write(payload)
+
+            sys.stdout.flush()
+            sys.stderr.flush()
+        finally:
+            # Skip all cleanup, the parent still owns the application
+            os._exit(0)
+
+    @staticmethod
+    def _require_snapshot_safe(app: sil_app.SilApp):
+        if not app.is_snapshot_safe:
+            raise RuntimeError("Snapshots require all tasks to run as fibers, and no VCD recording to run")
+
+    @staticmethod
+    def _collect(child: tuple[int, int]) -> tuple:
+        pid, r = child
+
+        with os.fdopen(r, "rb") as f:
+            data = f.read()
+
+        _, status = os.waitpid(pid, 0)
+        if len(data) == 0:
+            return False, RuntimeError(f"Snapshot process {pid} terminated without a result (status {status})"), ""
+
+        return pickle.loads(data)
+
+    @staticmethod
+    def _unwrap(result: tuple):
+        if result[0]:
+            return result[1]
+
+        _, e, tb = result
+        if tb:
+            e.add_note(f"Raised in snapshot process:\n{tb}")
+        raise e
@@ -0,0 +1,296 @@
+from concurrent.futures import ThreadPoolExecutor, wait
+from dataclasses import dataclass
+from typing import Optional
+
+import os
+import threading
+
+import hal2.sil.app as sil_app
+import hal2.sil.peripherals.uart as uart
+
+
+@dataclass
+class _Frame:
+    """
+    Frame on a shared UART bus.
+    """
+
+    sender: uart.Uart
+    """UART that transmits the frame."""
+
+    start_us: int
+    """Start of the transmission."""
+
+    end_us: int
+    """End of the transmission."""
+
+    data: bytes
+    """Transmitted data."""
+
+    collided: bool = False
+    """Whether the frame overlaps with a frame of another UART."""
+
+
+class UartBus:
+    """
+    Shared half-duplex UART medium, e.g. an RS-485 line. A frame that is transmitted by one of the connected UARTs is
+    received by all other connected UARTs, one bus latency after the end of its transmission. Frames that overlap in
+    time collide, and are received by none of the UARTs. Frames that a receiving UART does not accept, e.g. because it
+    is not receiving, are dropped for that UART.
+    """
+
+    _latency_us: int
+
+    _uarts: list[uart.Uart]
+
+    _frames: list[_Frame]
+
+    _collision_count: int
+
+    _drop_count: int
+
+    def __init__(self, latency_us: int):
+        """
+        Constructor.
+
+        Args:
+            latency_us: Delay between the end of a transmission and the reception of the frame, e.g. the turnaround
+                time of the line. Bounds how far the connected applications can run ahead of each other.
+        """
+
+        if latency_us < 1:
+            raise ValueError("The latency of a UART bus must be at least 1 us")
+
+        self._latency_us = latency_us
+        self._uarts = []
+        self._frames = []
+        self._collision_count = 0
+        self._drop_count = 0
+        self._lock = threading.Lock()
+
+    @property
+    def latency_us(self) -> int:
+        """Delay between the end of a transmission and the reception of the frame."""
+
+        return self._latency_us
+
+    @property
+    def collision_count(self) -> int:
+        """Number of frames that were lost due to collisions."""
+
+        return self._collision_count
+
+    @property
+    def drop_count(self) -> int:
+        """Number of times that a receiving UART did not accept a frame."""
+
+        return self._drop_count
+
+    def connect(self, u: uart.Uart):
+        """
+        Connects a simulated UART to the bus.
+
+        Args:
+            u: UART to connect.
+        """
+
+        u.set_tx_start_callback(lambda start_us, end_us, data: self._on_tx_start(u, start_us, end_us, data))
+        self._uarts.append(u)
+
+    def _on_tx_start(self, sender: uart.Uart, start_us: int, end_us: int, data: bytes):
+        # Called from the threads that simulate the connected applications
+        if len(data) == 0:
+            return
+
+        with self._lock:
+            self._frames.append(_Frame(sender, start_us, end_us, data))
+
+    def _synchronize(self, now_us: int):
+        """
+        Delivers all frames whose transmission has ended. All connected applications must have been simulated until
+        the given time, so that every frame which could overlap with such a frame is known.
+
+        Args:
+            now_us: Time until which all connected applications were simulated.
+        """
+
+        for i, a in enumerate(self._frames):
+            for b in self._frames[i + 1 :]:
+                if a.sender is not b.sender and a.start_us < b.end_us and b.start_us < a.end_us:
+                    a.collided = True
+                    b.collided = True
+
+        in_flight = []
+        for frame in self._frames:
+            if frame.end_us > now_us:
+                in_flight.append(frame)
+                continue
+
+            if frame.collided:
+                self._collision_count += 1
+                continue
+
+            for receiver in self._uarts:
+                if receiver is not frame.sender and not receiver.transmit(frame.data, frame.end_us + self._latency_us):
+                    self._drop_count += 1
+
+        self._frames = in_flight
+
+
+class SilWorld:
+    """
+    Simulates several SIL applications on a shared virtual timeline, connected by shared media.
+
+    The applications advance in parallel on a fixed set of host threads, as conservative parallel discrete event
+    simulation: they are simulated up to a common synchronization point, at which the shared media exchange their
+    frames. As a frame is received no earlier than one bus latency after its transmission ended, synchronization
+    points that are at most the smallest bus latency apart guarantee that no application receives a frame in its
+    past.
+
+    Every application is assigned to a worker thread when it is added, and is only ever simulated on that thread, so
+    that its fibers are never resumed on another thread. The workers live until the world is closed.
+    """
+
+    _apps: list[sil_app.SilApp]
+
+    _groups: list[list[sil_app.SilApp]]
+
+    _workers: list[ThreadPoolExecutor]
+
+    _closed: bool
+
+    _buses: list[UartBus]
+
+    _now_us: int
+
+    _window_end_us: int
+
+    def __init__(self, n_workers: Optional[int] = None):
+        """
+        Constructor.
+
+        Args:
+            n_workers: Maximum number of host threads to simulate the applications on. Defaults to the number of
+                host cores.
+        """
+
+        self._apps = []
+        self._groups = []
+        self._workers = []
+        self._buses = []
+        self._now_us = 0
+        self._window_end_us = 0
+        self._n_workers = max(1, n_workers if n_workers is not None else (os.cpu_count() or 1))
+        self._closed = False
+
+    @property
+    def now(self) -> int:
+        """Current time of the shared timeline in microseconds."""
+
+        return self._now_us
+
+    def add_app(self, app: sil_app.SilApp):
+        """
+        Adds an application to the world. From then on, the application must only be simulated through the world.
+
+        Args:
+            app: Application to add, which must be at the current time of the world.
+        """
+
+        if app.now != self._now_us:
+            raise ValueError(f"Application is at {app.now} us, but the world is at {self._now_us} us")
+
+        # Applications are spread over the workers round-robin, a worker is started for each of the first groups
+        group = len(self._apps) % self._n_workers
+        if group == len(self._groups):
+            self._groups.append([])
+            self._workers.append(ThreadPoolExecutor(max_workers=1, thread_name_prefix=f"sil-world-{group}"))
+
+        self._groups[group].append(app)
+        self._apps.append(app)
+
+    def add_uart_bus(self, latency_us: int) -> UartBus:
+        """
+        Adds a shared UART bus to the world.
+
+        Args:
+            latency_us: Delay between the end of a transmission and the reception of the frame.
+
+        Returns:
+            UART bus, to connect the UARTs of the applications to.
+        """
+
+        bus = UartBus(latency_us)
+        self._buses.append(bus)
+        return bus
+
+    def simulate_until(self, timestamp_us: int):
+        """
+        Simulates all applications until the given timestamp.
+
+        Args:
+            timestamp_us: Time in microseconds until which to simulate.
+        """
+
+        if self._closed:
+            raise RuntimeError("Cannot simulate a closed world")
+
+        if timestamp_us <= self._now_us:
+            return
+
+        if len(self._apps) == 0:
+            self._now_us = timestamp_us
+            return
+
+        self._window_end_us = self._next_window_end(timestamp_us)
+        barrier = threading.Barrier(len(self._groups), action=lambda: self._synchronize(timestamp_us))
+        errors: list[Exception] = []
+
+        def work(apps: list[sil_app.SilApp]):
+            try:
+                while self._now_us < timestamp_us:
+                    for app in apps:
+                        app.simulate_until(self._window_end_us)
+
+                    barrier.wait()
+            except threading.BrokenBarrierError:
+                pass
+            except Exception as e:
+                errors.append(e)
+                barrier.abort()
+
+        # Every group is simulated by its own worker, which is the same thread in every call
+        wait([worker.submit(work, group) for worker, group in zip(self._workers, self._groups)])
+
+        if len(errors) > 0:
+            raise errors[0]
+
+    def close(self):
+        """
+        Stops the worker threads of the world. The world must not be simulated afterwards.
+        """
+
+        for worker in self._workers:
+            worker.shutdown()
+        self._closed = True
+
+    def __enter__(self):
+        return self
+
+    def __exit__(self, exc_type, exc_val, exc_tb):
+        self.close()
+
+    def _synchronize(self, timestamp_us: int):
+        # Runs on a single thread, while all other threads wait at the barrier
+        self._now_us = self._window_end_us
+
+        for bus in self._buses:
+            bus._synchronize(self._now_us)  # noqa
+
+        self._window_end_us = self._next_window_end(timestamp_us)
+
+    def _next_window_end(self, timestamp_us: int) -> int:
+        if len(self._buses) == 0:
+            return timestamp_us
+
+        return min(timestamp_us, self._now_us + min(bus.latency_us for bus in self._buses))
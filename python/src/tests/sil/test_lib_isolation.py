@@ -0,0 +1,95 @@
+import ctypes
+import gc
+import pathlib
+import shutil
+import subprocess
+
+import pytest
+
+from hal2.sil._lib import SilLib
+
+# Stand-in for a SIL application, which keeps its state in a global like applications do
+_APP_SOURCE = """
+#include <stdlib.h>
+
+static int counter = 0;
+
+void* Sil_CreateSystem(void) { return malloc(1); }
+void Sil_DestroySystem(void* handle) { free(handle); }
+
+void App_Increment(void) { ++counter; }
+int App_Counter(void) { return counter; }
+"""
+
+
+@pytest.fixture
+def app_lib(tmp_path: pathlib.Path) -> str:
+    compiler = shutil.which("cc")
+    if compiler is None:
+        pytest.skip("no C compiler available")
+
+    source = tmp_path / "app.c"
+    source.write_text(_APP_SOURCE)
+    lib = tmp_path / "libapp.so"
+    subprocess.run([compiler, "-shared", "-fPIC", "-o", str(lib), str(source)], check=True)
+    return str(lib)
+
+
+def _counter(lib: SilLib) -> int:
+    func = lib._c.App_Counter
+    func.restype = ctypes.c_int
+    return func()
+
+
+def test_sil_lib_instances_have_separate_globals(app_lib):
+    a = SilLib(app_lib)
+    b = SilLib(app_lib)
+
+    a._c.App_Increment()
+    a._c.App_Increment()
+    b._c.App_Increment()
+
+    assert _counter(a) == 2
+    assert _counter(b) == 1
+
+
+def test_sil_lib_loads_original_path_while_unused(app_lib):
+    a = SilLib(app_lib)
+    b = SilLib(app_lib)
+    assert a._c._name == app_lib
+    assert b._c._name != app_lib
+
+    # The path is free again once its instance is gone
+    del a
+    gc.collect()
+    c = SilLib(app_lib)
+    assert c._c._name == app_lib
+    assert b._c._name != app_lib
+
+
+def test_sil_lib_removes_private_copy(app_lib, tmp_path, monkeypatch):
+    copies = tmp_path / "copies"
+    copies.mkdir()
+    monkeypatch.setattr("tempfile.tempdir", str(copies))
+
+    original = SilLib(app_lib)
+    lib = SilLib(app_lib)
+    lib._c.App_Increment()
+
+    assert list(copies.iterdir()) == []
+    assert _counter(lib) == 1
+    assert _counter(original) == 0
+
+
+@pytest.mark.skipif(not pathlib.Path("/proc/self/maps").exists(), reason="needs /proc/self/maps")
+def test_sil_lib_unloads_private_copy(app_lib):
+    original = SilLib(app_lib)
+    copy = SilLib(app_lib)
+    copy_path = copy._c._name
+    assert copy_path in pathlib.Path("/proc/self/maps").read_text()
+
+    del copy
+    gc.collect()
+    assert copy_path not in pathlib.Path("/proc/self/maps").read_text()
+    assert app_lib in pathlib.Path("/proc/self/maps").read_text()
+    assert _counter(original) == 0
@@ -0,0 +1,114 @@
+import os
+
+import pytest
+
+from hal2.sil.snapshot import SilSnapshot
+
+
+class FakeApp:
+    """Application whose state is a Python counter, which forks along with the process."""
+
+    def __init__(self, snapshot_safe: bool = True):
+        self.is_snapshot_safe = snapshot_safe
+        self.now = 0
+        self.log: list[str] = []
+
+    def simulate_until(self, timestamp_us: int):
+        self.log.append(f"simulated until {timestamp_us}")
+        self.now = timestamp_us
+
+
+class ScenarioError(Exception):
+    pass
+
+
+class UnpicklableError(Exception):
+    def __init__(self):
+        super().__init__("unpicklable")
+        self.handle = lambda: None
+
+
+def _simulate(app: FakeApp) -> tuple[int, list[str]]:
+    app.simulate_until(app.now + 100)
+    return app.now, app.log
+
+
+def test_snapshot_run_leaves_parent_state_unchanged():
+    app = FakeApp()
+    app.simulate_until(50)
+    snapshot = SilSnapshot(app)
+
+    assert snapshot.run(_simulate) == (150, ["simulated until 50", "simulated until 150"])
+    assert snapshot.run(_simulate) == (150, ["simulated until 50", "simulated until 150"])
+
+    assert app.now == 50
+    assert app.log == ["simulated until 50"]
+
+
+def test_snapshot_run_propagates_exceptions_of_the_child():
+    def fail(app: FakeApp):
+        app.simulate_until(10)
+        raise ScenarioError("scenario failed")
+
+    app = FakeApp()
+
+    with pytest.raises(ScenarioError, match="scenario failed") as e:
+        SilSnapshot(app).run(fail)
+
+    assert any("Raised in snapshot process" in note for note in e.value.__notes__)
+    assert app.log == []
+
+
+def test_snapshot_run_replaces_unpicklable_exceptions():
+    def fail(_: FakeApp):
+        raise UnpicklableError()
+
+    with pytest.raises(RuntimeError, match="UnpicklableError"):
+        SilSnapshot(FakeApp()).run(fail)
+
+
+def test_snapshot_run_reports_children_that_exit_without_result():
+    def exit_early(_: FakeApp):
+        os._exit(3)
+
+    with pytest.raises(RuntimeError, match="terminated without a result"):
+        SilSnapshot(FakeApp()).run(exit_early)
+
+
+def test_snapshot_map_returns_results_in_order():
+    def advance_by(duration_us: int):
+        return lambda app: (app.simulate_until(app.now + duration_us), app.now)[1]
+
+    app = FakeApp()
+    results = SilSnapshot(app).map([advance_by(d) for d in (30, 10, 20, 40)], max_parallel=2)
+
+    assert results == [30, 10, 20, 40]
+    assert app.now == 0
+
+
+def test_snapshot_map_collects_all_children_before_raising():
+    def fail(_: FakeApp):
+        raise ScenarioError("first")
+
+    with pytest.raises(ScenarioError, match="first"):
+        SilSnapshot(FakeApp()).map([fail, _simulate, fail], max_parallel=1)
+
+    # No child is left behind as a zombie
+    with pytest.raises(ChildProcessError):
+        os.waitpid(-1, os.WNOHANG)
+
+
+def test_snapshot_requires_snapshot_safe_app():
+    with pytest.raises(RuntimeError, match="fibers"):
+        SilSnapshot(FakeApp(snapshot_safe=False))
+
+
+def test_snapshot_refuses_to_run_once_app_is_no_longer_snapshot_safe():
+    app = FakeApp()
+    snapshot = SilSnapshot(app)
+
+    # E.g. the application started a VCD recording
+    app.is_snapshot_safe = False
+
+    with pytest.raises(RuntimeError, match="VCD"):
+        snapshot.run(_simulate)
@@ -0,0 +1,195 @@
+import threading
+
+import pytest
+
+from hal2.sil.world import SilWorld
+
+
+class FakeUart:
+    """UART that transmits scheduled frames, and records the frames it receives."""
+
+    def __init__(self, app: "FakeApp", frames: list[tuple[int, int, bytes]]):
+        self._app = app
+        self._pending = sorted(frames)
+        self._callback = None
+        self.accepting = True
+        self.received: list[tuple[int, bytes]] = []
+
+    def set_tx_start_callback(self, callback):
+        self._callback = callback
+
+    def transmit(self, data: bytes, timestamp_us: int) -> bool:
+        # Like the simulated UART, only accepts receptions that are not in the past
+        if not self.accepting or timestamp_us < self._app.now:
+            return False
+
+        self.received.append((timestamp_us, data))
+        return True
+
+    def start_due_frames(self, timestamp_us: int):
+        while self._pending and self._pending[0][0] <= timestamp_us:
+            start_us, end_us, data = self._pending.pop(0)
+            if self._callback is not None:
+                self._callback(start_us, end_us, data)
+
+
+class FakeApp:
+    """Application that only advances its time, and transmits frames on its UART when they start."""
+
+    def __init__(self, frames: list[tuple[int, int, bytes]] = ()):
+        self.now = 0
+        self.uart = FakeUart(self, list(frames))
+        self.windows: list[int] = []
+
+    def simulate_until(self, timestamp_us: int):
+        self.uart.start_due_frames(timestamp_us)
+        self.windows.append(timestamp_us)
+        self.now = timestamp_us
+
+
+def _connected_world(latency_us: int, *apps: FakeApp, n_workers: int = 2):
+    world = SilWorld(n_workers)
+    bus = world.add_uart_bus(latency_us)
+    for app in apps:
+        world.add_app(app)
+        bus.connect(app.uart)
+
+    return world, bus
+
+
+def test_world_advances_apps_in_windows_of_the_bus_latency():
+    a = FakeApp()
+    b = FakeApp()
+    world, _ = _connected_world(30, a, b)
+
+    world.simulate_until(100)
+
+    assert world.now == 100
+    assert a.windows == [30, 60, 90, 100]
+    assert b.windows == [30, 60, 90, 100]
+
+
+def test_world_without_buses_simulates_in_one_window():
+    a = FakeApp()
+    world = SilWorld(1)
+    world.add_app(a)
+
+    world.simulate_until(500)
+
+    assert a.windows == [500]
+    assert world.now == 500
+
+
+def test_world_delivers_frames_to_other_nodes_after_the_latency():
+    a = FakeApp([(5, 20, b"ping")])
+    b = FakeApp([(70, 80, b"pong")])
+    c = FakeApp()
+    world, bus = _connected_world(25, a, b, c, n_workers=3)
+
+    world.simulate_until(200)
+
+    assert a.uart.received == [(105, b"pong")]
+    assert b.uart.received == [(45, b"ping")]
+    assert c.uart.received == [(45, b"ping"), (105, b"pong")]
+    assert bus.collision_count == 0
+    assert bus.drop_count == 0
+
+
+def test_world_delivers_frames_that_end_after_the_window_later():
+    a = FakeApp([(5, 120, b"long")])
+    b = FakeApp()
+    world, _ = _connected_world(10, a, b)
+
+    world.simulate_until(100)
+    assert b.uart.received == []
+
+    world.simulate_until(200)
+    assert b.uart.received == [(130, b"long")]
+
+
+def test_world_drops_overlapping_frames_of_different_nodes():
+    a = FakeApp([(10, 40, b"a"), (100, 110, b"a2")])
+    b = FakeApp([(30, 50, b"b")])
+    c = FakeApp()
+    world, bus = _connected_world(20, a, b, c)
+
+    world.simulate_until(200)
+
+    assert c.uart.received == [(130, b"a2")]
+    assert b.uart.received == [(130, b"a2")]
+    assert bus.collision_count == 2
+
+
+def test_world_counts_frames_that_receivers_do_not_accept():
+    a = FakeApp([(10, 20, b"x")])
+    b = FakeApp()
+    c = FakeApp()
+    c.uart.accepting = False
+    world, bus = _connected_world(10, a, b, c)
+
+    world.simulate_until(100)
+
+    assert b.uart.received == [(30, b"x")]
+    assert c.uart.received == []
+    assert bus.drop_count == 1
+
+
+def test_world_rejects_apps_that_are_not_at_its_time():
+    world = SilWorld(1)
+    world.simulate_until(100)
+
+    with pytest.raises(ValueError):
+        world.add_app(FakeApp())
+
+
+def test_world_propagates_errors_of_apps():
+    class FailingApp(FakeApp):
+        def simulate_until(self, timestamp_us: int):
+            if timestamp_us > 20:
+                raise RuntimeError("app failed")
+            super().simulate_until(timestamp_us)
+
+    failing = FailingApp()
+    other = FakeApp()
+    world, _ = _connected_world(10, failing, other)
+
+    with pytest.raises(RuntimeError, match="app failed"):
+        world.simulate_until(100)
+
+    assert world.now == 20
+
+
+def test_world_simulates_every_app_on_the_same_thread_across_calls():
+    class ThreadRecordingApp(FakeApp):
+        def __init__(self):
+            super().__init__()
+            self.threads: set[int] = set()
+
+        def simulate_until(self, timestamp_us: int):
+            self.threads.add(threading.get_ident())
+            super().simulate_until(timestamp_us)
+
+    apps = [ThreadRecordingApp() for _ in range(3)]
+    with SilWorld(2) as world:
+        bus = world.add_uart_bus(10)
+        for app in apps:
+            world.add_app(app)
+            bus.connect(app.uart)
+
+        for timestamp_us in range(50, 501, 50):
+            world.simulate_until(timestamp_us)
+
+    assert all(len(app.threads) == 1 for app in apps)
+    assert threading.get_ident() not in set.union(*(app.threads for app in apps))
+    # Apps of the same worker share its thread
+    assert apps[0].threads == apps[2].threads
+    assert apps[0].threads != apps[1].threads
+
+
+def test_world_cannot_be_simulated_after_closing():
+    world = SilWorld(1)
+    world.add_app(FakeApp())
+    world.close()
+
+    with pytest.raises(RuntimeError):
+        world.simulate_until(100)
@@ -0,0 +1,68 @@
+#include <atomic>
+#include <cstddef>
+#include <memory>
+#include <optional>
+#include <string>
+#include <vector>
+
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+
+import hstd;
+
+using namespace ::testing;
+
+namespace {
+
+/** Atomic type of a system, which only provides what hstd::Atomic requires */
+struct SystemAtomic : std::atomic<std::size_t> {
+  using std::atomic<std::size_t>::atomic;
+};
+
+}   // namespace
+
+TEST(MpscQueue, PopsElementsInInsertionOrderAcrossWrapAround) {
+  hstd::MpscQueue<std::string, 4, SystemAtomic> queue{};
+
+  for (int lap = 0; lap < 3; ++lap) {
+    ASSERT_TRUE(queue.Push("a"));
+    ASSERT_TRUE(queue.Push("b"));
+    ASSERT_TRUE(queue.Push("c"));
+    ASSERT_EQ(queue.Pop(), "a");
+    ASSERT_EQ(queue.Pop(), "b");
+    ASSERT_EQ(queue.Pop(), "c");
+    ASSERT_EQ(queue.Pop(), std::nullopt);
+  }
+}
+
+TEST(MpscQueue, RejectsPushWhenFull) {
+  hstd::MpscQueue<int, 2> queue{};
+
+  ASSERT_TRUE(queue.Push(1));
+  ASSERT_TRUE(queue.Push(2));
+  ASSERT_FALSE(queue.Push(3));
+
+  std::vector<int> values{};
+  queue.ReadAll([&](int v) { values.push_back(v); });
+  ASSERT_THAT(values, ElementsAre(1, 2));
+  ASSERT_TRUE(queue.Push(3));
+}
+
+TEST(MpscQueue, PopReleasesElement) {
+  hstd::MpscQueue<std::shared_ptr<int>, 2> queue{};
+  const auto                               element = std::make_shared<int>(1);
+
+  ASSERT_TRUE(queue.Push(element));
+  ASSERT_EQ(element.use_count(), 2);
+
+  // The slot does not keep a copy of the popped element
+  ASSERT_EQ(queue.Pop(), element);
+  ASSERT_EQ(element.use_count(), 1);
+}
+
+TEST(MpscQueue, AlignsHeadAndTailToRequestedAlignment) {
+  static_assert(alignof(hstd::MpscQueue<int, 4, std::atomic<std::size_t>, 64>)
+                == 64);
+  static_assert(sizeof(hstd::MpscQueue<int, 4, std::atomic<std::size_t>, 64>)
+                >= 128);
+}
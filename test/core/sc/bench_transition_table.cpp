@@ -0,0 +1,155 @@
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <format>
+#include <iostream>
+#include <string_view>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+import hstd;
+
+import statechart;
+
+/**
+ * Micro-benchmark of the dispatch latency of StateChartRunner for each
+ * transition table encoding, for a 30 state, 40 event chart with 2
+ * transitions per state, which is typical for protocol state charts. Events
+ * go through ApplyEvent, so the timing includes the member function pointer
+ * call of the handler and the state change
+ */
+
+namespace {
+
+constexpr std::size_t NS = 30;
+constexpr std::size_t NE = 40;
+
+struct BenchSystem {
+  template <typename T>
+  using Atomic = std::atomic<T>;
+
+  using AtomicFlag = std::atomic_flag;
+};
+
+template <std::size_t I>
+struct State {};
+
+template <std::size_t I>
+struct Event {};
+
+/** Events handled in state s, which move on by one and two states */
+constexpr std::size_t StepEvent(std::size_t s) { return (s * 7) % NE; }
+constexpr std::size_t JumpEvent(std::size_t s) { return (s * 13 + 5) % NE; }
+
+template <std::size_t S, std::size_t E, std::size_t D>
+struct Transition {
+  State<D> operator()(State<S>, Event<E>) const { return {}; }
+};
+
+template <typename Seq>
+struct ChartTypes;
+
+template <std::size_t... Is>
+struct ChartTypes<std::index_sequence<Is...>> {
+  using States = sc::States<State<Is>...>;
+
+  using Transitions =
+      sc::Transitions<Transition<Is, StepEvent(Is), (Is + 1) % NS>...,
+                      Transition<Is, JumpEvent(Is), (Is + 2) % NS>...>;
+};
+
+template <typename Seq>
+struct EventTypes;
+
+template <std::size_t... Is>
+struct EventTypes<std::index_sequence<Is...>> {
+  using Events = sc::Events<Event<Is>...>;
+};
+
+using Types = ChartTypes<std::make_index_sequence<NS>>;
+using BenchChart =
+    sc::StateChart<Types::States,
+                   EventTypes<std::make_index_sequence<NE>>::Events>::
+        Chart<Types::Transitions>;
+
+template <sc::TableEncoding Enc>
+using Runner = sc::StateChartRunner<BenchSystem, BenchChart, 4, Enc>;
+
+/** Applies the event with a runtime index, through a table of ApplyEvent */
+template <typename R>
+using ApplyFn = bool (*)(R&);
+
+template <typename R, std::size_t... Is>
+constexpr std::array<ApplyFn<R>, NE> MakeAppliers(std::index_sequence<Is...>) {
+  return {[](R& runner) { return runner.ApplyEvent(Event<Is>{}); }...};
+}
+
+constexpr std::size_t NIterations = 10'000'000;
+
+template <sc::TableEncoding Enc>
+void Run(std::string_view name, const std::vector<uint8_t>& inputs) {
+  static constexpr auto Appliers =
+      MakeAppliers<Runner<Enc>>(std::make_index_sequence<NE>());
+  using Table = std::remove_cvref_t<decltype(Runner<Enc>::JumpTable)>;
+
+  Runner<Enc> runner{hstd::Marker<BenchSystem>(),
+                     BenchChart{State<0>{}, Types::Transitions{}}};
+
+  const auto start = std::chrono::steady_clock::now();
+
+  std::size_t n_handled = 0;
+  for (std::size_t i = 0; i < NIterations; ++i) {
+    n_handled += Appliers[inputs[i % inputs.size()]](runner) ? 1 : 0;
+  }
+
+  const auto elapsed = std::chrono::duration<double, std::nano>(
+      std::chrono::steady_clock::now() - start);
+  std::cout << std::format("{:<8} {:>6} bytes  {:>6.2f} ns/dispatch  ({} "
+                           "handled)\n",
+                           name, Table::SizeBytes,
+                           elapsed.count() / NIterations, n_handled);
+}
+
+}   // namespace
+
+int main() {
+  // Pseudo-random events, half of which are handled in the state the chart
+  // is in at that point
+  std::vector<uint8_t> inputs{};
+  std::size_t          state = 0;
+  uint32_t             lcg   = 12345;
+  for (std::size_t i = 0; i < 4096; ++i) {
+    lcg          = lcg * 1664525U + 1013904223U;
+    const auto e = (lcg >> 20) % 2 == 0
+                       ? ((lcg >> 21) % 2 == 0 ? StepEvent(state)
+                                               : JumpEvent(state))
+                       : (lcg >> 12) % NE;
+    if (e == StepEvent(state)) {
+      state = (state + 1) % NS;
+    } else if (e == JumpEvent(state)) {
+      state = (state + 2) % NS;
+    }
+    inputs.push_back(static_cast<uint8_t>(e));
+  }
+
+  using Automatic = Runner<sc::TableEncoding::Automatic>;
+  constexpr auto Selected =
+      std::remove_cvref_t<decltype(Automatic::JumpTable)>::Encoding;
+  std::cout << std::format(
+      "{} transitions, {} unique handlers of {} bytes, automatic selection: "
+      "{}\n",
+      Automatic::NTransitions, Automatic::NHandlers,
+      sizeof(Automatic::JumpTable.Lookup(0, 0)),
+      Selected == sc::TableEncoding::Sparse    ? "sparse"
+      : Selected == sc::TableEncoding::Indexed ? "indexed"
+                                               : "dense");
+
+  Run<sc::TableEncoding::Dense>("dense", inputs);
+  Run<sc::TableEncoding::Indexed>("indexed", inputs);
+  Run<sc::TableEncoding::Sparse>("sparse", inputs);
+
+  return 0;
+}
@@ -0,0 +1,156 @@
+#include <atomic>
+#include <string>
+#include <vector>
+
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+
+import hstd;
+
+import statechart;
+
+using namespace ::testing;
+
+namespace {
+
+struct TestSystem {
+  template <typename T>
+  using Atomic = std::atomic<T>;
+
+  using AtomicFlag = std::atomic_flag;
+};
+
+std::vector<std::string>& Trace() {
+  static std::vector<std::string> trace{};
+  return trace;
+}
+
+// Operational
+// +- Idle
+// +- Active
+//    +- Heating
+//    +- Cooling
+// Fault
+struct Operational {
+  void OnEntry() { Trace().emplace_back("enter Operational"); }
+  void OnExit() { Trace().emplace_back("exit Operational"); }
+};
+
+struct Idle : sc::Substate<Operational> {};
+
+struct Active : sc::Substate<Operational> {
+  void OnEntry() { Trace().emplace_back("enter Active"); }
+  void OnExit() { Trace().emplace_back("exit Active"); }
+};
+
+struct Heating : sc::Substate<Active> {
+  void OnEntry() { Trace().emplace_back("enter Heating"); }
+  void OnExit() { Trace().emplace_back("exit Heating"); }
+};
+
+struct Cooling : sc::Substate<Active> {};
+
+struct Fault {
+  void OnEntry() { Trace().emplace_back("enter Fault"); }
+};
+
+struct Start {};
+struct Swap {};
+struct Stop {};
+struct Error {};
+struct Reset {};
+
+using HeaterChart =
+    sc::StateChart<sc::States<Idle, Heating, Cooling, Fault>,
+                   sc::Events<Start, Swap, Stop, Error, Reset>>;
+
+auto MakeRunner() {
+  return sc::StateChartRunner{
+      hstd::Marker<TestSystem>(),
+      HeaterChart::Chart{
+          Idle{},
+          sc::Transitions{
+              [](Idle, Start) { return Heating{}; },
+              [](Heating, Swap) { return Cooling{}; },
+              [](Cooling, Swap) { return Heating{}; },
+              // Inherited by Heating and Cooling
+              [](Active, Stop) { return Idle{}; },
+              // Inherited by all operational states
+              [](Operational, Error) { return Fault{}; },
+              // Overrides the inherited transition
+              [](Cooling, Error) { return Idle{}; },
+              [](Fault, Reset) { return Idle{}; },
+          },
+      },
+  };
+}
+
+}   // namespace
+
+class StateChartHierarchyTest : public Test {
+ public:
+  void SetUp() override { Trace().clear(); }
+};
+
+TEST_F(StateChartHierarchyTest, EntersInitialStateOutermostFirst) {
+  auto runner = MakeRunner();
+
+  ASSERT_THAT(Trace(), ElementsAre("enter Operational"));
+}
+
+TEST_F(StateChartHierarchyTest, ResolvesInheritedTransitions) {
+  auto runner = MakeRunner();
+
+  ASSERT_TRUE(runner.ApplyEvent(Start{}));
+  ASSERT_TRUE(runner.ApplyEvent(Swap{}));
+  ASSERT_TRUE(runner.Visit(sc::IsInState<Cooling>()));
+
+  // Cooling inherits Stop from Active
+  ASSERT_TRUE(runner.ApplyEvent(Stop{}));
+  ASSERT_TRUE(runner.Visit(sc::IsInState<Idle>()));
+
+  // Idle inherits Error from Operational
+  ASSERT_TRUE(runner.ApplyEvent(Error{}));
+  ASSERT_TRUE(runner.Visit(sc::IsInState<Fault>()));
+
+  // Stop is not handled outside of Active
+  ASSERT_FALSE(runner.ApplyEvent(Stop{}));
+}
+
+TEST_F(StateChartHierarchyTest, SubstateTransitionOverridesInheritedOne) {
+  auto runner = MakeRunner();
+
+  ASSERT_TRUE(runner.ApplyEvent(Start{}));
+  ASSERT_TRUE(runner.ApplyEvent(Swap{}));
+  ASSERT_TRUE(runner.ApplyEvent(Error{}));
+
+  ASSERT_TRUE(runner.Visit(sc::IsInState<Idle>()));
+}
+
+TEST_F(StateChartHierarchyTest, CallsHooksUpToCommonAncestor) {
+  auto runner = MakeRunner();
+  Trace().clear();
+
+  ASSERT_TRUE(runner.ApplyEvent(Start{}));
+  ASSERT_THAT(Trace(), ElementsAre("enter Active", "enter Heating"));
+
+  Trace().clear();
+  ASSERT_TRUE(runner.ApplyEvent(Swap{}));
+  ASSERT_THAT(Trace(), ElementsAre("exit Heating"));
+
+  Trace().clear();
+  ASSERT_TRUE(runner.ApplyEvent(Swap{}));
+  ASSERT_TRUE(runner.ApplyEvent(Error{}));
+  ASSERT_THAT(Trace(), ElementsAre("enter Heating", "exit Heating", "exit Active",
+                                   "exit Operational", "enter Fault"));
+}
+
+TEST_F(StateChartHierarchyTest, InheritedTransitionsAreInTransitionTable) {
+  using Runner = decltype(MakeRunner());
+
+  // Cooling (2) inherits Stop (2) from Active, Idle (0) does not
+  ASSERT_NE(Runner::JumpTable.Lookup(2, 2), nullptr);
+  ASSERT_EQ(Runner::JumpTable.Lookup(0, 2), nullptr);
+  // Idle: Start, Error; Heating, Cooling: Swap, Stop, Error; Fault: Reset
+  ASSERT_EQ(Runner::NTransitions, 9);
+}
@@ -0,0 +1,117 @@
+#include <atomic>
+#include <cstdint>
+#include <type_traits>
+
+#include <gtest/gtest.h>
+
+import hstd;
+
+import statechart;
+
+namespace {
+
+struct TestSystem {
+  template <typename T>
+  using Atomic = std::atomic<T>;
+
+  using AtomicFlag = std::atomic_flag;
+};
+
+struct Idle {};
+struct Counting {
+  uint32_t count{0};
+};
+struct Done {};
+
+struct Start {};
+struct Tick {};
+struct Stop {};
+
+using CounterChart =
+    sc::StateChart<sc::States<Idle, Counting, Done>, sc::Events<Start, Tick, Stop>>;
+
+auto MakeChart() {
+  return CounterChart::Chart{
+      Idle{},
+      sc::Transitions{
+          [](Idle, Start) { return Counting{}; },
+          [](Counting c, Tick) { return Counting{c.count + 1}; },
+          [](Counting, Stop) { return Done{}; },
+      },
+  };
+}
+
+template <std::size_t QD>
+auto MakeRunner() {
+  return sc::StateChartRunner<TestSystem, decltype(MakeChart()), QD>{
+      hstd::Marker<TestSystem>(), MakeChart()};
+}
+
+uint32_t CountOf(const auto& runner) {
+  return runner
+      .Visit(sc::TryGetStateValue<Counting>(
+          [](const Counting& c) { return c.count; }))
+      .value_or(0);
+}
+
+}   // namespace
+
+TEST(StateChartRunner, AppliesEventsImmediately) {
+  auto runner = MakeRunner<4>();
+
+  ASSERT_TRUE(runner.ApplyEvent(Start{}));
+  ASSERT_TRUE(runner.ApplyEvent(Tick{}));
+  ASSERT_FALSE(runner.ApplyEvent(Start{}));
+
+  ASSERT_EQ(CountOf(runner), 1);
+}
+
+TEST(StateChartRunner, UsesDenseTableUnlessSmallerEncodingIsRequested) {
+  using Default = decltype(MakeRunner<4>());
+  static_assert(std::remove_cvref_t<decltype(Default::JumpTable)>::Encoding
+                == sc::TableEncoding::Dense);
+
+  // The chart is sparse enough that automatic selection picks another encoding
+  using Automatic = sc::StateChartRunner<TestSystem, decltype(MakeChart()), 4,
+                                         sc::TableEncoding::Automatic>;
+  static_assert(std::remove_cvref_t<decltype(Automatic::JumpTable)>::Encoding
+                != sc::TableEncoding::Dense);
+}
+
+TEST(StateChartRunner, ProcessesBurstOfEnqueuedEventsInOrder) {
+  auto runner = MakeRunner<8>();
+
+  ASSERT_TRUE(runner.EnqueueEvent(Start{}));
+  for (int i = 0; i < 5; ++i) {
+    ASSERT_TRUE(runner.EnqueueEvent(Tick{}));
+  }
+
+  runner.ProcessEnqueuedEvent();
+  ASSERT_EQ(CountOf(runner), 5);
+
+  ASSERT_TRUE(runner.EnqueueEvent(Stop{}));
+  runner.ProcessEnqueuedEvent();
+  ASSERT_TRUE(runner.Visit(sc::IsInState<Done>()));
+}
+
+TEST(StateChartRunner, RejectsEventsWhenQueueIsFull) {
+  auto runner = MakeRunner<2>();
+
+  ASSERT_TRUE(runner.EnqueueEvent(Start{}));
+  ASSERT_TRUE(runner.EnqueueEvent(Tick{}));
+  ASSERT_FALSE(runner.EnqueueEvent(Tick{}));
+
+  runner.ProcessEnqueuedEvent();
+  ASSERT_EQ(CountOf(runner), 1);
+  ASSERT_TRUE(runner.EnqueueEvent(Tick{}));
+}
+
+TEST(StateChartRunner, AppliesPendingEventsBeforeImmediateEvent) {
+  auto runner = MakeRunner<4>();
+
+  ASSERT_TRUE(runner.EnqueueEvent(Start{}));
+  ASSERT_TRUE(runner.EnqueueEvent(Tick{}));
+  ASSERT_TRUE(runner.ApplyEvent(Tick{}));
+
+  ASSERT_EQ(CountOf(runner), 2);
+}
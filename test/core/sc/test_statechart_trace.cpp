@@ -0,0 +1,137 @@
+#include <atomic>
+#include <cstdint>
+#include <string>
+#include <string_view>
+
+#include <gtest/gtest.h>
+
+import hstd;
+
+import statechart;
+
+namespace {
+
+struct TestSystem {
+  template <typename T>
+  using Atomic = std::atomic<T>;
+
+  using AtomicFlag = std::atomic_flag;
+};
+
+struct TestClock {
+  static uint32_t Get() noexcept { return now; }
+
+  static inline uint32_t now = 0;
+};
+
+struct Idle {};
+struct Running {};
+
+struct Start {};
+struct Stop {};
+struct Poll {};
+
+using PumpChart =
+    sc::StateChart<sc::States<Idle, Running>, sc::Events<Start, Stop, Poll>>;
+
+auto MakeChart() {
+  return PumpChart::Chart{
+      Idle{},
+      sc::Transitions{
+          [](Idle, Start) { return Running{}; },
+          [](Running, Stop) { return Idle{}; },
+          [](Running, Poll) { return Running{}; },
+      },
+  };
+}
+
+using Chart  = decltype(MakeChart());
+using Tracer = sc::Tracer<Chart, TestClock, 4>;
+using Runner = sc::StateChartRunner<TestSystem, Chart, 4,
+                                    sc::TableEncoding::Dense, Tracer>;
+
+}   // namespace
+
+TEST(StateChartTrace, RecordsTransitionsAndResidency) {
+  TestClock::now = 100;
+  Runner runner{hstd::Marker<TestSystem>(), MakeChart()};
+
+  TestClock::now = 110;
+  ASSERT_TRUE(runner.ApplyEvent(Start{}));
+  TestClock::now = 150;
+  ASSERT_TRUE(runner.ApplyEvent(Poll{}));
+  TestClock::now = 200;
+  ASSERT_TRUE(runner.ApplyEvent(Stop{}));
+  // Not handled, so not recorded
+  ASSERT_FALSE(runner.ApplyEvent(Stop{}));
+
+  const auto& tracer = runner.GetObserver();
+  ASSERT_EQ(tracer.GetTransitionCount(), 3);
+  ASSERT_EQ(tracer.GetRecordCount(), 3);
+
+  const auto& first = tracer.GetRecord(0);
+  ASSERT_EQ(first.timestamp, 110);
+  ASSERT_EQ(first.from, 0);
+  ASSERT_EQ(first.event, 0);
+  ASSERT_EQ(first.to, 1);
+
+  ASSERT_EQ(tracer.GetStateStatistics(0).n_entries, 2);
+  ASSERT_EQ(tracer.GetStateStatistics(0).residency, 10);
+  // Self-transitions re-enter the state
+  ASSERT_EQ(tracer.GetStateStatistics(1).n_entries, 2);
+  ASSERT_EQ(tracer.GetStateStatistics(1).residency, 90);
+}
+
+TEST(StateChartTrace, RecordsEnqueuedEvents) {
+  Runner runner{hstd::Marker<TestSystem>(), MakeChart()};
+
+  ASSERT_TRUE(runner.EnqueueEvent(Start{}));
+  ASSERT_TRUE(runner.EnqueueEvent(Stop{}));
+  runner.ProcessEnqueuedEvent();
+
+  const auto& tracer = runner.GetObserver();
+  ASSERT_EQ(tracer.GetTransitionCount(), 2);
+  ASSERT_EQ(tracer.GetRecord(1).event, 1);
+  ASSERT_EQ(tracer.GetRecord(1).to, 0);
+}
+
+TEST(StateChartTrace, RingBufferKeepsLatestTransitions) {
+  Runner runner{hstd::Marker<TestSystem>(), MakeChart()};
+
+  ASSERT_TRUE(runner.ApplyEvent(Start{}));
+  for (uint32_t i = 0; i < 5; ++i) {
+    TestClock::now = i;
+    ASSERT_TRUE(runner.ApplyEvent(Poll{}));
+  }
+
+  const auto& tracer = runner.GetObserver();
+  ASSERT_EQ(tracer.GetTransitionCount(), 6);
+  ASSERT_EQ(tracer.GetRecordCount(), Tracer::Capacity);
+  for (uint32_t i = 0; i < Tracer::Capacity; ++i) {
+    ASSERT_EQ(tracer.GetRecord(i).timestamp, i + 1);
+  }
+}
+
+TEST(StateChartTrace, WritesTimelineWithTypeNames) {
+  TestClock::now = 0;
+  Runner runner{hstd::Marker<TestSystem>(), MakeChart()};
+
+  TestClock::now = 5;
+  ASSERT_TRUE(runner.ApplyEvent(Start{}));
+  TestClock::now = 12;
+  ASSERT_TRUE(runner.ApplyEvent(Stop{}));
+
+  std::string timeline;
+  sc::WriteTimeline(runner.GetObserver(),
+                    [&timeline](std::string_view part) { timeline += part; });
+
+  ASSERT_EQ(timeline, "5: Idle --Start--> Running\n"
+                      "12: Running --Stop--> Idle\n"
+                      "Idle: 2 entries, 5 ticks\n"
+                      "Running: 1 entries, 7 ticks\n");
+}
+
+TEST(StateChartTrace, TypeNameIsUnqualified) {
+  ASSERT_EQ(sc::TypeName<Idle>(), "Idle");
+  ASSERT_EQ(sc::TypeName<sc::NullObserver>(), "NullObserver");
+}
@@ -0,0 +1,74 @@
+#include <array>
+#include <cstddef>
+
+#include <gtest/gtest.h>
+
+import statechart;
+
+namespace {
+
+using Handler = void (*)();
+
+void HandlerA() {}
+void HandlerB() {}
+void HandlerC() {}
+
+constexpr std::size_t NS = 4;
+constexpr std::size_t NE = 6;
+
+constexpr std::array<std::array<Handler, NE>, NS> Cells{{
+    {&HandlerA, nullptr, nullptr, nullptr, nullptr, &HandlerB},
+    {nullptr, nullptr, nullptr, nullptr, nullptr, nullptr},
+    {nullptr, &HandlerC, nullptr, nullptr, nullptr, &HandlerB},
+    {nullptr, nullptr, nullptr, &HandlerA, nullptr, nullptr},
+}};
+
+constexpr std::size_t NT = 5;
+constexpr std::size_t NH = 3;
+
+template <typename Table>
+void ExpectMatchesCells(const Table& table) {
+  for (std::size_t s = 0; s < NS; ++s) {
+    for (std::size_t e = 0; e < NE; ++e) {
+      EXPECT_EQ(table.Lookup(s, e), Cells[s][e]) << "s=" << s << ", e=" << e;
+    }
+  }
+}
+
+}   // namespace
+
+TEST(TransitionTable, AllEncodingsMatchDenseCells) {
+  static constexpr sc::DenseTable<Handler, NS, NE>       dense{Cells};
+  static constexpr sc::IndexedTable<Handler, NS, NE, NH> indexed{Cells};
+  static constexpr sc::SparseTable<Handler, NS, NE, NT>  sparse{Cells};
+
+  ExpectMatchesCells(dense);
+  ExpectMatchesCells(indexed);
+  ExpectMatchesCells(sparse);
+}
+
+TEST(TransitionTable, IndexedTableDeduplicatesHandlers) {
+  static constexpr sc::IndexedTable<Handler, NS, NE, NH> indexed{Cells};
+
+  ASSERT_EQ(indexed.indices[0][0], indexed.indices[3][3]);
+  ASSERT_EQ(indexed.indices[0][5], indexed.indices[2][5]);
+  ASSERT_EQ(indexed.handlers.size(), NH + 1);
+  ASSERT_EQ(indexed.handlers[0], nullptr);
+}
+
+TEST(TransitionTable, CountsTransitionsAndUniqueHandlers) {
+  static_assert(sc::CountTransitions(Cells) == NT);
+  static_assert(sc::CountUniqueHandlers(Cells) == NH);
+}
+
+TEST(TransitionTable, SelectsSmallestEncoding) {
+  // Few cells: a dense table of pointers is smallest
+  static_assert(sc::SelectTableEncoding<Handler, 2, 2, 4>()
+                == sc::TableEncoding::Dense);
+  // Many cells with a moderate fill: indices into a handler table
+  static_assert(sc::SelectTableEncoding<Handler, 30, 40, 400>()
+                == sc::TableEncoding::Indexed);
+  // Many cells with very few transitions: per state lists
+  static_assert(sc::SelectTableEncoding<Handler, 30, 40, 60>()
+                == sc::TableEncoding::Sparse);
+}
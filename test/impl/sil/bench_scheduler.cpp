@@ -0,0 +1,151 @@
+#include <chrono>
+#include <cstddef>
+#include <format>
+#include <functional>
+#include <iostream>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <utility>
+#include <vector>
+
+import hal.sil;
+
+/**
+ * Micro-benchmark of the rate of simulated context switches of the SIL
+ * scheduler, for both execution backends. Covers tasks that block on a
+ * timeout, and tasks that hand over through a synchronization primitive,
+ * which is how the simulated RTOS primitives wake each other
+ */
+
+namespace {
+
+using namespace std::chrono_literals;
+
+constexpr sil::TimePointUs SimulatedTime{50'000};
+constexpr std::size_t      NTimerTasks = 4;
+
+/** Spawns simulated tasks on the execution backend of a scheduler */
+class TaskSpawner {
+ public:
+  explicit TaskSpawner(sil::Scheduler& sched)
+      : sched{sched} {}
+
+  TaskSpawner(const TaskSpawner&)            = delete;
+  TaskSpawner& operator=(const TaskSpawner&) = delete;
+
+  ~TaskSpawner() {
+    for (auto& thread : threads) {
+      thread.join();
+    }
+  }
+
+  void Spawn(std::string_view name, unsigned prio, std::function<void()> fn) {
+    if (sched.GetExecutionBackend() == sil::ExecutionBackend::Fibers) {
+      sched.SpawnFiber(name, prio, std::move(fn));
+      return;
+    }
+
+    sched.AnnounceThread();
+    threads.emplace_back([this, name = std::string{name}, prio,
+                          fn = std::move(fn)] {
+      sched.InitializeThread(name, prio);
+      fn();
+      sched.DeInitializeThread();
+    });
+  }
+
+ private:
+  sil::Scheduler&          sched;
+  std::vector<std::thread> threads{};
+};
+
+/** Tasks of distinct priorities that each block for 1us in a loop */
+void SpawnTimerTasks(sil::Scheduler& sched, TaskSpawner& spawner,
+                     std::size_t& n_switches) {
+  for (std::size_t i = 0; i < NTimerTasks; ++i) {
+    spawner.Spawn(std::format("timer{}", i), static_cast<unsigned>(i), [&] {
+      while (sched.GetState() != sil::SchedulerState::Stopping) {
+        sched.BlockCurrentThreadFor(1us);
+        n_switches++;
+      }
+    });
+  }
+}
+
+/**
+ * A task that signals a flag every 1us, which preempts a higher-priority task
+ * that waits for it
+ */
+void SpawnSyncTasks(sil::Scheduler& sched, TaskSpawner& spawner,
+                    std::size_t& n_switches, bool& flag) {
+  spawner.Spawn("waiter", 0, [&] {
+    while (sched.GetState() != sil::SchedulerState::Stopping) {
+      sched.BlockCurrentThreadOnSynchronizationPrimitive(
+          &flag,
+          [&]() -> std::optional<bool> {
+            return flag ? std::optional{true} : std::nullopt;
+          },
+          sched.Now() + 1ms);
+      flag = false;
+      n_switches++;
+    }
+  });
+
+  spawner.Spawn("signaler", 1, [&] {
+    while (sched.GetState() != sil::SchedulerState::Stopping) {
+      flag = true;
+      sched.CheckSyncPrimitivePreemption();
+      n_switches++;
+
+      sched.BlockCurrentThreadFor(1us);
+      n_switches++;
+    }
+  });
+}
+
+void Run(std::string_view name, sil::ExecutionBackend backend, bool sync) {
+  sil::Scheduler sched{};
+  sched.SetExecutionBackend(backend);
+
+  std::size_t n_switches = 0;
+  bool        flag       = false;
+  {
+    TaskSpawner spawner{sched};
+    if (sync) {
+      SpawnSyncTasks(sched, spawner, n_switches, flag);
+    } else {
+      SpawnTimerTasks(sched, spawner, n_switches);
+    }
+
+    // Switches at the epoch are part of the startup
+    sched.Start();
+    n_switches = 0;
+
+    const auto start = std::chrono::steady_clock::now();
+    sched.RunUntil(SimulatedTime);
+    const auto elapsed = std::chrono::duration<double, std::nano>(
+        std::chrono::steady_clock::now() - start);
+
+    std::cout << std::format("{:<16} {:>10} switches  {:>8.1f} ns/switch  "
+                             "{:>6.2f} M switches/s\n",
+                             name, n_switches,
+                             elapsed.count() / static_cast<double>(n_switches),
+                             static_cast<double>(n_switches)
+                                 / elapsed.count() * 1e3);
+
+    sched.Shutdown();
+  }
+}
+
+}   // namespace
+
+int main() {
+  Run("threads, timer", sil::ExecutionBackend::Threads, false);
+  Run("threads, sync", sil::ExecutionBackend::Threads, true);
+  Run("fibers, timer", sil::ExecutionBackend::Fibers, false);
+  Run("fibers, sync", sil::ExecutionBackend::Fibers, true);
+
+  return 0;
+}
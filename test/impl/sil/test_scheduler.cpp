@@ -0,0 +1,435 @@
+#include <array>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <optional>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <tuple>
+#include <utility>
+#include <variant>
+#include <vector>
+
+#include <time.h>
+
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+
+import hal.sil;
+
+using namespace ::testing;
+using namespace std::chrono_literals;
+
+namespace {
+
+/** Recurses until the stack overflows */
+std::size_t Recurse(std::size_t depth) {
+  std::array<volatile std::byte, 1024> frame{};
+  frame[0] = std::byte{1};
+  return depth == 0 ? 0
+                    : Recurse(depth - 1) + static_cast<std::size_t>(frame[0]);
+}
+
+/** Returns the CPU time of the calling host thread */
+std::chrono::nanoseconds HostCpuTime() {
+  timespec ts{};
+  clock_gettime(CLOCK_THREAD_CPUTIME_ID, &ts);
+  return std::chrono::seconds{ts.tv_sec} + std::chrono::nanoseconds{ts.tv_nsec};
+}
+
+}   // namespace
+
+class FiberSchedulerTest : public Test {
+ public:
+  void SetUp() override {
+    sched.SetExecutionBackend(sil::ExecutionBackend::Fibers);
+  }
+
+  sil::Scheduler sched{};
+};
+
+TEST_F(FiberSchedulerTest, BlockedFiberResumesAtTimeout) {
+  std::vector<uint64_t> wakeups{};
+  sched.SpawnFiber("blocker", 0, [&] {
+    for (int i = 0; i < 3; ++i) {
+      sched.BlockCurrentThreadFor(100us);
+      wakeups.push_back(sched.Now().count());
+    }
+  });
+
+  sched.Start();
+  sched.RunUntil(sil::TimePointUs{250});
+  ASSERT_THAT(wakeups, ElementsAre(100, 200));
+  ASSERT_EQ(sched.Now(), sil::TimePointUs{250});
+
+  sched.RunUntil(sil::TimePointUs{1'000});
+  ASSERT_THAT(wakeups, ElementsAre(100, 200, 300));
+
+  sched.Shutdown();
+}
+
+TEST_F(FiberSchedulerTest, FibersOfEqualPriorityTakeTurnsWhenYielding) {
+  std::vector<std::string> runs{};
+  for (const auto* name : {"a", "b"}) {
+    sched.SpawnFiber(name, 0, [&, name] {
+      for (int i = 0; i < 3; ++i) {
+        runs.emplace_back(name);
+        sched.BlockCurrentThreadFor(0us);
+      }
+    });
+  }
+
+  sched.Start();
+  sched.RunUntil(sil::TimePointUs{10});
+  ASSERT_THAT(runs, ElementsAre("a", "b", "a", "b", "a", "b"));
+
+  sched.Shutdown();
+}
+
+TEST_F(FiberSchedulerTest, ReadyFibersRunInPriorityOrder) {
+  std::vector<std::string> runs{};
+  for (const auto& [name, prio] :
+       {std::pair{"low", 2U}, std::pair{"high", 0U}, std::pair{"mid", 1U}}) {
+    sched.SpawnFiber(name, prio, [&, name] {
+      sched.BlockCurrentThreadFor(100us);
+      runs.emplace_back(name);
+    });
+  }
+
+  sched.Start();
+  sched.RunUntil(sil::TimePointUs{200});
+  ASSERT_THAT(runs, ElementsAre("high", "mid", "low"));
+
+  sched.Shutdown();
+}
+
+TEST_F(FiberSchedulerTest, SignaledFiberPreemptsLowerPriorityFiber) {
+  bool                     flag = false;
+  std::vector<std::string> log{};
+
+  sched.SpawnFiber("waiter", 0, [&] {
+    const auto result = sched.BlockCurrentThreadOnSynchronizationPrimitive(
+        &flag,
+        [&]() -> std::optional<bool> {
+          return flag ? std::optional{true} : std::nullopt;
+        },
+        sil::TimePointUs{1'000});
+    log.push_back(std::string{std::holds_alternative<bool>(result)
+                                  ? "waiter woken at "
+                                  : "waiter timed out at "} +
+                  std::to_string(sched.Now().count()));
+  });
+
+  sched.SpawnFiber("signaler", 1, [&] {
+    sched.BlockCurrentThreadFor(50us);
+    flag = true;
+    sched.CheckSyncPrimitivePreemption();
+    log.push_back("signaler resumed at " +
+                  std::to_string(sched.Now().count()));
+  });
+
+  sched.Start();
+  sched.RunUntil(sil::TimePointUs{100});
+  ASSERT_THAT(log,
+              ElementsAre("waiter woken at 50", "signaler resumed at 50"));
+
+  sched.Shutdown();
+}
+
+TEST_F(FiberSchedulerTest, BusyTaskDefersLowerPriorityTasks) {
+  std::vector<std::pair<std::string, uint64_t>> done{};
+  sched.SpawnFiber("high", 0, [&] {
+    sched.BlockCurrentThreadFor(5us);
+    sched.ChargeCurrentTask(100us);
+    done.emplace_back("high", sched.Now().count());
+  });
+  sched.SpawnFiber("low", 1, [&] {
+    sched.BlockCurrentThreadFor(10us);
+    done.emplace_back("low", sched.Now().count());
+  });
+
+  sched.Start();
+  sched.RunUntil(sil::TimePointUs{1'000});
+
+  // The timeout of the low-priority task expires while the CPU is busy
+  ASSERT_THAT(done, ElementsAre(Pair("high", 105), Pair("low", 105)));
+  ASSERT_EQ(sched.GetTaskStats(0).cpu_time, sil::DurationUs{100});
+
+  sched.Shutdown();
+}
+
+TEST_F(FiberSchedulerTest, PreemptionShiftsEndOfBusyWindow) {
+  std::vector<std::pair<std::string, uint64_t>> done{};
+  sched.SpawnFiber("low", 1, [&] {
+    sched.ChargeCurrentTask(100us);
+    done.emplace_back("low", sched.Now().count());
+  });
+  sched.SpawnFiber("high", 0, [&] {
+    sched.BlockCurrentThreadFor(20us);
+    sched.ChargeCurrentTask(30us);
+    done.emplace_back("high", sched.Now().count());
+  });
+
+  sched.Start();
+  sched.RunUntil(sil::TimePointUs{1'000});
+
+  // The low-priority task gets its 100 us of CPU time once the high-priority
+  // task is done with its 30 us
+  ASSERT_THAT(done, ElementsAre(Pair("high", 50), Pair("low", 130)));
+
+  const auto& low = sched.GetTaskStats(0);
+  ASSERT_EQ(low.cpu_time, sil::DurationUs{100});
+  ASSERT_EQ(low.n_preemptions, 1);
+  ASSERT_EQ(sched.GetTaskStats(1).n_preemptions, 0);
+
+  sched.Shutdown();
+}
+
+TEST_F(FiberSchedulerTest, ExplicitChargeFollowsHostTimeOfTask) {
+  sched.SetCpuScale(10.0);
+
+  uint64_t done = 0;
+  sched.SpawnFiber("worker", 0, [&] {
+    // Run for at least 100 us of host CPU time, which is 1 ms on the target
+    const auto start = HostCpuTime();
+    while (HostCpuTime() - start < 100us) {
+    }
+
+    sched.ChargeCurrentTask(10us);
+    done = sched.Now().count();
+  });
+
+  sched.Start();
+  sched.RunUntil(sil::TimePointUs{1'000'000});
+  ASSERT_GE(done, 1'010);
+  ASSERT_GE(sched.GetTaskStats(0).cpu_time, sil::DurationUs{1'010});
+
+  sched.Shutdown();
+}
+
+TEST_F(FiberSchedulerTest, BusyTaskIsReportedAsRunning) {
+  std::vector<std::tuple<std::size_t, bool, uint64_t>> runs{};
+  sched.SetTaskRunCallback([&](std::size_t task, bool running) {
+    runs.emplace_back(task, running, sched.Now().count());
+  });
+
+  sched.SpawnFiber("low", 1, [&] {
+    sched.BlockCurrentThreadFor(10us);
+    sched.ChargeCurrentTask(100us);
+    sched.BlockCurrentThreadFor(1'000us);
+  });
+  sched.SpawnFiber("high", 0, [&] {
+    sched.BlockCurrentThreadFor(50us);
+    sched.ChargeCurrentTask(20us);
+    sched.BlockCurrentThreadFor(1'000us);
+  });
+
+  sched.Start();
+  runs.clear();
+  sched.RunUntil(sil::TimePointUs{500});
+
+  // The low task runs for its CPU time, except while the high task preempts
+  // it with its own
+  ASSERT_THAT(runs,
+              ElementsAre(std::tuple{0, true, 10}, std::tuple{1, true, 50},
+                          std::tuple{0, false, 50}, std::tuple{0, true, 70},
+                          std::tuple{1, false, 70}, std::tuple{0, false, 130}));
+
+  sched.Shutdown();
+}
+
+TEST_F(FiberSchedulerTest, ExceptionOfFiberIsRethrownByRunUntil) {
+  bool resumed = false;
+  sched.SpawnFiber("thrower", 0, [&] {
+    sched.BlockCurrentThreadFor(10us);
+    throw std::runtime_error{"task failed"};
+  });
+  sched.SpawnFiber("other", 1, [&] {
+    sched.BlockCurrentThreadFor(20us);
+    resumed = true;
+  });
+
+  sched.Start();
+  ASSERT_THROW(sched.RunUntil(sil::TimePointUs{100}), std::runtime_error);
+  ASSERT_EQ(sched.Now(), sil::TimePointUs{10});
+
+  // The other fibers keep running
+  sched.RunUntil(sil::TimePointUs{100});
+  ASSERT_TRUE(resumed);
+
+  sched.Shutdown();
+}
+
+TEST_F(FiberSchedulerTest, StackOverflowFaultsOnGuardPage) {
+  GTEST_FLAG_SET(death_test_style, "threadsafe");
+
+  ASSERT_DEATH(
+      {
+        sched.SpawnFiber(
+            "overflow", 0, [] { Recurse(1'000'000); }, 64 * 1024);
+        sched.Start();
+      },
+      "");
+}
+
+class ThreadSchedulerTest : public Test {
+ public:
+  void SetUp() override {
+    sched.SetExecutionBackend(sil::ExecutionBackend::Threads);
+  }
+
+  void TearDown() override {
+    sched.Shutdown();
+    for (auto& thread : threads) {
+      thread.join();
+    }
+  }
+
+  /**
+   * Creates a task that runs on its own host thread, like the tasks of the
+   * SIL RTOS
+   * @param name Task name
+   * @param prio Task priority
+   * @param fn Task body
+   */
+  void SpawnThread(std::string name, unsigned prio, std::function<void()> fn) {
+    threads.emplace_back([this, name, prio, fn = std::move(fn)] {
+      sched.InitializeThread(name, prio);
+      fn();
+      sched.DeInitializeThread();
+    });
+    sched.AnnounceThread();
+  }
+
+  sil::Scheduler           sched{};
+  std::vector<std::thread> threads{};
+};
+
+TEST_F(ThreadSchedulerTest, BlockedThreadResumesAtTimeout) {
+  std::vector<uint64_t> wakeups{};
+  SpawnThread("blocker", 0, [&] {
+    for (int i = 0; i < 3; ++i) {
+      sched.BlockCurrentThreadFor(100us);
+      wakeups.push_back(sched.Now().count());
+    }
+  });
+
+  sched.Start();
+  sched.RunUntil(sil::TimePointUs{250});
+  ASSERT_THAT(wakeups, ElementsAre(100, 200));
+  ASSERT_EQ(sched.Now(), sil::TimePointUs{250});
+
+  sched.RunUntil(sil::TimePointUs{1'000});
+  ASSERT_THAT(wakeups, ElementsAre(100, 200, 300));
+}
+
+TEST_F(ThreadSchedulerTest, SignaledThreadWakesWithValueOfPredicate) {
+  int                      value = 0;
+  std::vector<std::string> log{};
+
+  // The predicate refers to state of the waiter, which outlives the wait
+  SpawnThread("waiter", 0, [&] {
+    const int  expected = 42;
+    const auto result   = sched.BlockCurrentThreadOnSynchronizationPrimitive(
+        &value,
+        [&value, &expected]() -> std::optional<int> {
+          return value == expected ? std::optional{value} : std::nullopt;
+        },
+        sil::TimePointUs{1'000});
+    log.push_back(std::holds_alternative<int>(result)
+                      ? "waiter woken with " +
+                            std::to_string(std::get<int>(result)) + " at " +
+                            std::to_string(sched.Now().count())
+                      : "waiter timed out");
+  });
+
+  SpawnThread("signaler", 1, [&] {
+    // A change that does not satisfy the predicate keeps the waiter blocked
+    sched.BlockCurrentThreadFor(20us);
+    value = 7;
+    sched.CheckSyncPrimitivePreemption();
+
+    sched.BlockCurrentThreadFor(30us);
+    value = 42;
+    sched.CheckSyncPrimitivePreemption();
+    log.push_back("signaler resumed at " +
+                  std::to_string(sched.Now().count()));
+  });
+
+  sched.Start();
+  sched.RunUntil(sil::TimePointUs{100});
+  ASSERT_THAT(log, ElementsAre("waiter woken with 42 at 50",
+                               "signaler resumed at 50"));
+}
+
+TEST_F(ThreadSchedulerTest, WaitOnSyncPrimitiveTimesOut) {
+  bool                    flag = false;
+  std::optional<uint64_t> timed_out_at{};
+
+  SpawnThread("waiter", 0, [&] {
+    const auto result = sched.BlockCurrentThreadOnSynchronizationPrimitive(
+        &flag,
+        [&]() -> std::optional<bool> {
+          return flag ? std::optional{true} : std::nullopt;
+        },
+        sil::TimePointUs{300});
+    if (std::holds_alternative<sil::TimeoutExpired>(result)) {
+      timed_out_at = sched.Now().count();
+    }
+  });
+
+  sched.Start();
+  sched.RunUntil(sil::TimePointUs{1'000});
+  ASSERT_EQ(timed_out_at, 300);
+}
+
+TEST_F(ThreadSchedulerTest, DeInitializedThreadIsNoLongerATask) {
+  std::string             error{};
+  std::optional<uint64_t> other_resumed_at{};
+
+  threads.emplace_back([&] {
+    sched.InitializeThread("task", 0);
+    sched.BlockCurrentThreadFor(10us);
+    sched.DeInitializeThread();
+
+    // The thread was released, and cannot block as a task anymore
+    try {
+      sched.BlockCurrentThreadFor(10us);
+    } catch (const std::runtime_error& e) {
+      error = e.what();
+    }
+  });
+  sched.AnnounceThread();
+
+  SpawnThread("other", 1, [&] {
+    sched.BlockCurrentThreadFor(50us);
+    other_resumed_at = sched.Now().count();
+  });
+
+  sched.Start();
+  sched.RunUntil(sil::TimePointUs{100});
+  threads.front().join();
+  threads.erase(threads.begin());
+
+  ASSERT_THAT(error, HasSubstr("No ThreadState"));
+  ASSERT_EQ(other_resumed_at, 50);
+  ASSERT_EQ(sched.GetTaskStats(0).n_activations, 2);
+}
+
+TEST_F(ThreadSchedulerTest, RunUntilThrowsWhenCalledFromTask) {
+  std::string error{};
+  SpawnThread("task", 0, [&] {
+    try {
+      sched.RunUntil(sil::TimePointUs{100});
+    } catch (const std::runtime_error& e) {
+      error = e.what();
+    }
+  });
+
+  sched.Start();
+  sched.RunUntil(sil::TimePointUs{10});
+  ASSERT_THAT(error, HasSubstr("cannot be called from a simulated task"));
+  ASSERT_EQ(sched.Now(), sil::TimePointUs{10});
+}
@@ -0,0 +1,155 @@
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <random>
+#include <tuple>
+#include <vector>
+
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+
+import hal.sil;
+
+using namespace ::testing;
+
+namespace {
+
+/** Item that only has a position in the queue */
+class FakeItem final : public sil::SchedulerItem {
+ public:
+  explicit FakeItem(int id)
+      : id{id} {}
+
+  [[nodiscard]] sil::ItemPrio GetPriority() const override { return {}; }
+  [[nodiscard]] bool          IsRunning() const override { return true; }
+  [[nodiscard]] bool IsPending(sil::TimePointUs) const override { return false; }
+  [[nodiscard]] std::optional<sil::TimePointUs> GetTimeout() const override {
+    return std::nullopt;
+  }
+  [[nodiscard]] bool IsWaitingOnSyncPrimitive() const override { return false; }
+  sil::RunType       Run() override { return sil::RunType::Synchronous; }
+
+  int id;
+};
+
+/** Removes all items from the queue, and returns their IDs in queue order */
+std::vector<int> Drain(sil::TimeoutQueue& queue) {
+  std::vector<int> ids{};
+  while (auto* const top = queue.Top()) {
+    ids.push_back(static_cast<FakeItem*>(top)->id);
+    queue.Remove(*top);
+  }
+  return ids;
+}
+
+}   // namespace
+
+class TimeoutQueueTest : public Test {
+ public:
+  std::array<FakeItem, 5> items{FakeItem{0}, FakeItem{1}, FakeItem{2},
+                                FakeItem{3}, FakeItem{4}};
+  sil::TimeoutQueue       queue{};
+};
+
+TEST_F(TimeoutQueueTest, EmptyQueueHasNoTop) {
+  ASSERT_EQ(queue.Top(), nullptr);
+
+  // Removing an item that is not queued does nothing
+  queue.Remove(items[0]);
+  ASSERT_EQ(queue.Top(), nullptr);
+}
+
+TEST_F(TimeoutQueueTest, OrdersItemsByTimeout) {
+  queue.Update(items[0], sil::TimePointUs{300});
+  queue.Update(items[1], sil::TimePointUs{100});
+  queue.Update(items[2], sil::TimePointUs{500});
+  queue.Update(items[3], sil::TimePointUs{200});
+  queue.Update(items[4], sil::TimePointUs{400});
+
+  ASSERT_EQ(queue.Top(), &items[1]);
+  ASSERT_THAT(Drain(queue), ElementsAre(1, 3, 0, 4, 2));
+}
+
+TEST_F(TimeoutQueueTest, UpdateMovesQueuedItems) {
+  queue.Update(items[0], sil::TimePointUs{100});
+  queue.Update(items[1], sil::TimePointUs{200});
+  queue.Update(items[2], sil::TimePointUs{300});
+
+  queue.Update(items[0], sil::TimePointUs{400});
+  ASSERT_EQ(queue.Top(), &items[1]);
+
+  queue.Update(items[2], sil::TimePointUs{50});
+  ASSERT_THAT(Drain(queue), ElementsAre(2, 1, 0));
+}
+
+TEST_F(TimeoutQueueTest, RemoveKeepsRemainingItemsOrdered) {
+  for (std::size_t i = 0; i < items.size(); ++i) {
+    queue.Update(items[i], sil::TimePointUs{100 * (i + 1)});
+  }
+
+  queue.Remove(items[0]);
+  queue.Remove(items[3]);
+  queue.Remove(items[3]);
+  ASSERT_THAT(Drain(queue), ElementsAre(1, 2, 4));
+
+  // Removed items can be queued again
+  queue.Update(items[3], sil::TimePointUs{10});
+  ASSERT_EQ(queue.Top(), &items[3]);
+}
+
+TEST_F(TimeoutQueueTest, EqualTimeoutsAreOrderedByQueueTime) {
+  queue.Update(items[2], sil::TimePointUs{100});
+  queue.Update(items[0], sil::TimePointUs{100});
+  queue.Update(items[1], sil::TimePointUs{100});
+
+  // Requeueing an item with the same timeout moves it to the back
+  queue.Update(items[2], sil::TimePointUs{100});
+  ASSERT_THAT(Drain(queue), ElementsAre(0, 1, 2));
+}
+
+TEST_F(TimeoutQueueTest, MatchesSortedReferenceUnderRandomOperations) {
+  std::vector<FakeItem> many{};
+  for (int i = 0; i < 64; ++i) {
+    many.emplace_back(i);
+  }
+
+  // Reference of the queued items as (timeout, queue order, id)
+  std::vector<std::tuple<uint64_t, uint64_t, int>> reference{};
+  uint64_t                                         order = 0;
+
+  std::mt19937 rng{42};
+  for (int op = 0; op < 10'000; ++op) {
+    auto&      item    = many[rng() % many.size()];
+    const auto queued  = std::ranges::find_if(reference, [&](const auto& r) {
+      return std::get<2>(r) == item.id;
+    });
+    const bool remove  = rng() % 4 == 0;
+    const auto timeout = uint64_t{rng() % 32};
+
+    if (queued != reference.end()) {
+      reference.erase(queued);
+    }
+    if (remove) {
+      queue.Remove(item);
+    } else {
+      queue.Update(item, sil::TimePointUs{timeout});
+      reference.emplace_back(timeout, order++, item.id);
+    }
+
+    const auto expected = std::ranges::min_element(reference);
+    if (expected == reference.end()) {
+      ASSERT_EQ(queue.Top(), nullptr);
+    } else {
+      ASSERT_EQ(static_cast<FakeItem*>(queue.Top())->id, std::get<2>(*expected));
+    }
+  }
+
+  std::ranges::sort(reference);
+  std::vector<int> expected_ids{};
+  for (const auto& r : reference) {
+    expected_ids.push_back(std::get<2>(r));
+  }
+  ASSERT_EQ(Drain(queue), expected_ids);
+}
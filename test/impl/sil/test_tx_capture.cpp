@@ -0,0 +1,150 @@
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <span>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+
+import hal.sil;
+
+using namespace ::testing;
+
+namespace {
+
+std::span<const std::byte> Bytes(std::string_view str) {
+  return std::as_bytes(std::span{str});
+}
+
+/** Parses records into pairs of timestamp and frame data */
+std::vector<std::pair<uint64_t, std::string>>
+ParseRecords(std::span<const std::byte> records) {
+  std::vector<std::pair<uint64_t, std::string>> frames{};
+
+  while (!records.empty()) {
+    uint64_t timestamp = 0;
+    uint32_t size      = 0;
+    std::memcpy(&timestamp, records.data(), sizeof(timestamp));
+    std::memcpy(&size, records.data() + sizeof(timestamp), sizeof(size));
+
+    const auto data = records.subspan(sil::TxCapture::HeaderSize, size);
+    frames.emplace_back(timestamp,
+                        std::string{reinterpret_cast<const char*>(data.data()),
+                                    data.size()});
+    records = records.subspan(sil::TxCapture::HeaderSize + size);
+  }
+
+  return frames;
+}
+
+/** Reads all records through a buffer of the given size */
+std::vector<std::pair<uint64_t, std::string>> ReadAll(sil::TxCapture& capture,
+                                                      std::size_t buf_size) {
+  std::vector<std::byte> buf(buf_size);
+  std::vector<std::byte> records{};
+
+  while (const auto n = capture.Read(buf)) {
+    records.insert(records.end(), buf.begin(),
+                   buf.begin() + static_cast<std::ptrdiff_t>(n));
+  }
+
+  return ParseRecords(records);
+}
+
+}   // namespace
+
+class TxCaptureTest : public Test {
+ public:
+  /** Capacity of the ring that holds three records of four bytes */
+  static constexpr std::size_t Capacity = 3 * (sil::TxCapture::HeaderSize + 4);
+
+  void SetUp() override { capture.Enable(Capacity); }
+
+  sil::TxCapture capture{};
+};
+
+TEST_F(TxCaptureTest, DisabledCaptureIgnoresFrames) {
+  capture.Enable(0);
+  ASSERT_FALSE(capture.IsEnabled());
+
+  capture.Write(sil::TimePointUs{10}, Bytes("abcd"));
+  ASSERT_THAT(ReadAll(capture, Capacity), IsEmpty());
+  ASSERT_EQ(capture.GetDropCount(), 0);
+}
+
+TEST_F(TxCaptureTest, ReadsFramesOldestFirst) {
+  capture.Write(sil::TimePointUs{10}, Bytes("abcd"));
+  capture.Write(sil::TimePointUs{20}, Bytes("ef"));
+  capture.Write(sil::TimePointUs{30}, Bytes(""));
+
+  ASSERT_THAT(ReadAll(capture, Capacity),
+              ElementsAre(Pair(10, "abcd"), Pair(20, "ef"), Pair(30, "")));
+  ASSERT_THAT(ReadAll(capture, Capacity), IsEmpty());
+}
+
+TEST_F(TxCaptureTest, RecordsWrapAroundTheEndOfTheRing) {
+  // Every round of writes starts at another offset, so that both headers and
+  // data are split at the end of the ring
+  for (uint64_t i = 0; i < 20; ++i) {
+    const auto data = std::string(1 + i % 5, static_cast<char>('a' + i));
+    capture.Write(sil::TimePointUs{i}, Bytes(data));
+    ASSERT_THAT(ReadAll(capture, Capacity), ElementsAre(Pair(i, data)));
+  }
+
+  ASSERT_EQ(capture.GetDropCount(), 0);
+}
+
+TEST_F(TxCaptureTest, FullRingDropsOldestRecords) {
+  capture.Write(sil::TimePointUs{10}, Bytes("aaaa"));
+  capture.Write(sil::TimePointUs{20}, Bytes("bbbb"));
+  capture.Write(sil::TimePointUs{30}, Bytes("cccc"));
+  capture.Write(sil::TimePointUs{40}, Bytes("dddd"));
+  ASSERT_EQ(capture.GetDropCount(), 1);
+
+  // A larger record makes room by dropping as many records as needed
+  capture.Write(sil::TimePointUs{50}, Bytes("eeeeeeeeeeeeeeee"));
+  ASSERT_EQ(capture.GetDropCount(), 3);
+
+  ASSERT_THAT(ReadAll(capture, Capacity),
+              ElementsAre(Pair(40, "dddd"), Pair(50, "eeeeeeeeeeeeeeee")));
+}
+
+TEST_F(TxCaptureTest, RecordLargerThanRingIsDropped) {
+  capture.Write(sil::TimePointUs{10}, Bytes("abcd"));
+  capture.Write(sil::TimePointUs{20}, Bytes(std::string(Capacity, 'x')));
+  ASSERT_EQ(capture.GetDropCount(), 1);
+
+  // The records in the ring are kept
+  ASSERT_THAT(ReadAll(capture, Capacity), ElementsAre(Pair(10, "abcd")));
+}
+
+TEST_F(TxCaptureTest, ReadsOnlyCompleteRecords) {
+  capture.Write(sil::TimePointUs{10}, Bytes("abcd"));
+  capture.Write(sil::TimePointUs{20}, Bytes("ef"));
+
+  // A buffer smaller than the oldest record reads nothing
+  std::vector<std::byte> buf(sil::TxCapture::HeaderSize + 3);
+  ASSERT_EQ(capture.Read(buf), 0);
+
+  // A buffer that fits one and a half record reads the first record
+  buf.resize(sil::TxCapture::HeaderSize * 2 + 5);
+  const auto n = capture.Read(buf);
+  ASSERT_EQ(n, sil::TxCapture::HeaderSize + 4);
+  ASSERT_THAT(ParseRecords(std::span{buf}.first(n)),
+              ElementsAre(Pair(10, "abcd")));
+
+  ASSERT_THAT(ReadAll(capture, Capacity), ElementsAre(Pair(20, "ef")));
+}
+
+TEST_F(TxCaptureTest, EnableDiscardsCapturedRecords) {
+  capture.Write(sil::TimePointUs{10}, Bytes("abcd"));
+  capture.Write(sil::TimePointUs{20}, Bytes(std::string(Capacity, 'x')));
+
+  capture.Enable(Capacity);
+  ASSERT_EQ(capture.GetDropCount(), 0);
+  ASSERT_THAT(ReadAll(capture, Capacity), IsEmpty());
+}
@@ -0,0 +1,246 @@
+#include <array>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <span>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <variant>
+#include <vector>
+
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+
+import hal.sil;
+
+import rtos.concepts;
+
+using namespace ::testing;
+using namespace std::chrono_literals;
+
+extern "C" bool Uart_SimulateReceiveBatch(sil::System*       handle,
+                                          std::size_t        index,
+                                          const uint64_t*    timestamps_us,
+                                          const uint8_t*     data,
+                                          const std::size_t* chunk_lens,
+                                          std::size_t        n_chunks);
+
+namespace {
+
+/** Minimal OS on top of the scheduler of the current system */
+struct TestOs {
+  class EventGroup {
+   public:
+    void SetBits(uint32_t b) {
+      bits |= b;
+      sched().CheckSyncPrimitivePreemption();
+    }
+
+    void SetBitsFromInterrupt(uint32_t b) { bits |= b; }
+
+    uint32_t ClearBits(uint32_t b) { return std::exchange(bits, bits & ~b); }
+
+    uint32_t ReadBits() const { return bits; }
+
+    std::optional<uint32_t> Wait(uint32_t bits_to_wait, auto timeout,
+                                 bool clear_on_exit = true,
+                                 bool wait_for_all  = false) {
+      const auto unblock_reason =
+          sched().BlockCurrentThreadOnSynchronizationPrimitive(
+              this,
+              [this, bits_to_wait, wait_for_all]() -> std::optional<uint32_t> {
+                const auto set_bits = bits & bits_to_wait;
+                if (wait_for_all ? set_bits == bits_to_wait : set_bits != 0) {
+                  return bits;
+                }
+                return std::nullopt;
+              },
+              sched().Now() + timeout);
+
+      const auto* const result = std::get_if<uint32_t>(&unblock_reason);
+      if (result == nullptr) {
+        return std::nullopt;
+      }
+      if (clear_on_exit) {
+        bits &= ~bits_to_wait;
+      }
+      return *result;
+    }
+
+   private:
+    static sil::Scheduler& sched() {
+      return sil::System::Current().GetScheduler();
+    }
+
+    uint32_t bits{0};
+  };
+
+  class Mutex {
+   public:
+    bool Lock(auto) { return true; }
+    void Unlock() {}
+  };
+
+  template <typename Impl, std::size_t StackSize = 0>
+  class Task {
+   public:
+    explicit Task(std::string_view) {}
+  };
+
+  struct System {};
+
+  static constexpr std::size_t MiniStackSize       = 0;
+  static constexpr std::size_t SmallStackSize      = 0;
+  static constexpr std::size_t MediumStackSize     = 0;
+  static constexpr std::size_t LargeStackSize      = 0;
+  static constexpr std::size_t ExtraLargeStackSize = 0;
+};
+
+static_assert(rtos::concepts::Rtos<TestOs>);
+
+using TestUart = sil::RtosUart<TestOs>;
+
+std::span<const std::byte> Bytes(std::string_view str) {
+  return std::as_bytes(std::span{str});
+}
+
+}   // namespace
+
+class UartTest : public Test {
+ public:
+  void SetUp() override {
+    sys.GetScheduler().SetExecutionBackend(sil::ExecutionBackend::Fibers);
+    sys.SetErrorCallback(
+        [this](const char* msg) { errors.emplace_back(msg); });
+  }
+
+  void TearDown() override { sys.GetScheduler().Shutdown(); }
+
+  /**
+   * Spawns firmware that receives chunks in a loop, and records when they were
+   * received
+   * @param delay Time to spend between two receives
+   */
+  void SpawnReceiver(sil::DurationUs delay = sil::DurationUs{0}) {
+    auto& sched = sys.GetScheduler();
+    sched.SpawnFiber("receiver", 0, [this, &sched, delay] {
+      std::array<std::byte, 8> buf{};
+      while (sched.GetState() != sil::SchedulerState::Stopping) {
+        if (const auto rx = uart.Receive(buf, 1'000ms)) {
+          received.emplace_back(
+              sched.Now().count(),
+              std::string{reinterpret_cast<const char*>(rx->data()),
+                          rx->size()});
+          sched.BlockCurrentThreadFor(delay);
+        }
+      }
+    });
+    sched.Start();
+  }
+
+  void RunUntil(uint64_t time_us) {
+    sys.GetScheduler().RunUntil(sil::TimePointUs{time_us});
+  }
+
+  sil::System              sys{};
+  const sil::System::Scope scope{sys};
+  TestUart&                uart{sys.DefineUart<TestUart>("uart")};
+
+  std::vector<std::pair<uint64_t, std::string>> received{};
+  std::vector<std::string>                      errors{};
+};
+
+TEST_F(UartTest, ChunksAreReceivedInTimestampOrder) {
+  SpawnReceiver();
+
+  uart.SimulateRx(sil::TimePointUs{30}, Bytes("ccc"));
+  uart.SimulateRx(sil::TimePointUs{10}, Bytes("a"));
+  uart.SimulateRx(sil::TimePointUs{20}, Bytes("bb"));
+
+  RunUntil(100);
+  ASSERT_THAT(received,
+              ElementsAre(Pair(10, "a"), Pair(20, "bb"), Pair(30, "ccc")));
+}
+
+TEST_F(UartTest, ChunksWithEqualTimestampsAreReceivedSeparately) {
+  SpawnReceiver();
+
+  uart.SimulateRx(sil::TimePointUs{40}, Bytes("dd"));
+  uart.SimulateRx(sil::TimePointUs{40}, Bytes("e"));
+  uart.SimulateRx(sil::TimePointUs{40}, Bytes("fff"));
+
+  RunUntil(100);
+  ASSERT_THAT(received,
+              ElementsAre(Pair(40, "dd"), Pair(40, "e"), Pair(40, "fff")));
+}
+
+TEST_F(UartTest, ChunksAreHeldUntilTheNextReceive) {
+  SpawnReceiver(sil::DurationUs{100});
+
+  uart.SimulateRx(sil::TimePointUs{10}, Bytes("abc"));
+  uart.SimulateRx(sil::TimePointUs{20}, Bytes("de"));
+  uart.SimulateRx(sil::TimePointUs{150}, Bytes("f"));
+
+  RunUntil(500);
+  ASSERT_THAT(received,
+              ElementsAre(Pair(10, "abc"), Pair(110, "de"), Pair(210, "f")));
+}
+
+TEST_F(UartTest, ChunkAfterTimedOutReceiveIsHeld) {
+  auto& sched = sys.GetScheduler();
+  sched.SpawnFiber("receiver", 0, [this, &sched] {
+    std::array<std::byte, 8> buf{};
+    ASSERT_FALSE(uart.Receive(buf, 1ms).has_value());
+
+    // The chunk must not be written into the buffer of the timed out receive
+    sched.BlockCurrentThreadFor(2ms);
+    ASSERT_THAT(buf, Each(std::byte{0}));
+
+    const auto rx = uart.Receive(buf, 1ms);
+    ASSERT_TRUE(rx.has_value());
+    received.emplace_back(
+        sched.Now().count(),
+        std::string{reinterpret_cast<const char*>(rx->data()), rx->size()});
+  });
+  sched.Start();
+
+  uart.SimulateRx(sil::TimePointUs{1'500}, Bytes("late"));
+  RunUntil(5'000);
+  ASSERT_THAT(received, ElementsAre(Pair(3'000, "late")));
+}
+
+TEST_F(UartTest, BatchIsReceivedInTimestampOrder) {
+  SpawnReceiver();
+
+  const std::array<uint64_t, 3>    timestamps{30, 10, 10};
+  const std::array<std::size_t, 3> chunk_lens{1, 2, 3};
+  const std::string_view           data = "abbccc";
+  ASSERT_TRUE(Uart_SimulateReceiveBatch(
+      &sys, 0, timestamps.data(),
+      reinterpret_cast<const uint8_t*>(data.data()), chunk_lens.data(),
+      chunk_lens.size()));
+
+  RunUntil(100);
+  ASSERT_THAT(received,
+              ElementsAre(Pair(10, "bb"), Pair(10, "ccc"), Pair(30, "a")));
+  ASSERT_THAT(errors, IsEmpty());
+}
+
+TEST_F(UartTest, BatchWithChunkInThePastQueuesNothing) {
+  SpawnReceiver();
+  RunUntil(50);
+
+  const std::array<uint64_t, 3>    timestamps{60, 40, 70};
+  const std::array<std::size_t, 3> chunk_lens{1, 1, 1};
+  const std::string_view           data = "abc";
+  ASSERT_FALSE(Uart_SimulateReceiveBatch(
+      &sys, 0, timestamps.data(),
+      reinterpret_cast<const uint8_t*>(data.data()), chunk_lens.data(),
+      chunk_lens.size()));
+  ASSERT_THAT(errors, ElementsAre(HasSubstr("chunk 1")));
+
+  RunUntil(1'000);
+  ASSERT_THAT(received, IsEmpty());
+}
@@ -0,0 +1,146 @@
+#include <array>
+#include <cmath>
+#include <cstdint>
+#include <initializer_list>
+#include <span>
+#include <utility>
+#include <vector>
+
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+
+import hal.sil;
+
+using namespace ::testing;
+
+namespace {
+
+/**
+ * Square wave of (high time, low time) periods, starting with a rising edge at
+ * t = 0 and ending with the rising edge that completes the last period
+ */
+std::vector<sil::EdgeRecord>
+SquareWave(std::initializer_list<std::pair<uint64_t, uint64_t>> periods) {
+  std::vector<sil::EdgeRecord> edges{};
+  uint64_t                     t = 0;
+
+  for (const auto& [high, low] : periods) {
+    edges.push_back({sil::TimePointUs{t}, sil::Edge::Rising});
+    edges.push_back({sil::TimePointUs{t + high}, sil::Edge::Falling});
+    t += high + low;
+  }
+  edges.push_back({sil::TimePointUs{t}, sil::Edge::Rising});
+
+  return edges;
+}
+
+sil::WaveformAnalysis Analyze(const std::vector<sil::EdgeRecord>& edges,
+                              const sil::WaveformOptions& opts = {}) {
+  return sil::AnalyzeWaveform(edges, opts, {});
+}
+
+}   // namespace
+
+TEST(WaveformTest, MeasuresFrequencyAndDutyCycle) {
+  const auto result = Analyze(SquareWave({{25, 75}, {50, 50}, {75, 25}}));
+
+  ASSERT_EQ(result.n_periods, 3);
+  ASSERT_EQ(result.n_glitches, 0);
+  ASSERT_DOUBLE_EQ(result.mean_frequency, 10'000.0);
+  ASSERT_DOUBLE_EQ(result.mean_duty_cycle, 0.5);
+  ASSERT_DOUBLE_EQ(result.min_duty_cycle, 0.25);
+  ASSERT_DOUBLE_EQ(result.max_duty_cycle, 0.75);
+  ASSERT_EQ(result.min_period, sil::DurationUs{100});
+  ASSERT_EQ(result.max_period, sil::DurationUs{100});
+  ASSERT_DOUBLE_EQ(result.period_stddev_us, 0.0);
+}
+
+TEST(WaveformTest, RemovesPulsesShorterThanGlitchThreshold) {
+  // Two periods, with a pulse of 2 us in the low phase of the first one
+  auto edges = SquareWave({{50, 50}, {50, 50}});
+  edges.insert(edges.begin() + 2,
+               {{sil::TimePointUs{70}, sil::Edge::Rising},
+                {sil::TimePointUs{72}, sil::Edge::Falling}});
+
+  // Without a threshold, the glitch splits the first period in two
+  const auto unfiltered = Analyze(edges);
+  ASSERT_EQ(unfiltered.n_periods, 3);
+  ASSERT_EQ(unfiltered.n_glitches, 0);
+  ASSERT_EQ(unfiltered.min_period, sil::DurationUs{30});
+
+  const auto filtered =
+      Analyze(edges, {.glitch_threshold = sil::DurationUs{5}});
+  ASSERT_EQ(filtered.n_periods, 2);
+  ASSERT_EQ(filtered.n_glitches, 1);
+  ASSERT_EQ(filtered.min_period, sil::DurationUs{100});
+  ASSERT_DOUBLE_EQ(filtered.mean_duty_cycle, 0.5);
+}
+
+TEST(WaveformTest, HistogramBinsPeriodDeviationFromMean) {
+  // Mean period of 100 us, with deviations of 0, 0, +10, -10, +30 and -30 us
+  const auto edges =
+      SquareWave({{50, 50}, {50, 50}, {50, 60}, {50, 40}, {50, 80}, {50, 20}});
+
+  std::array<uint64_t, 5> histogram{};
+  const auto              result = sil::AnalyzeWaveform(
+      edges, {.jitter_bin_width = sil::DurationUs{10}}, histogram);
+
+  // Deviations of +-30 us are outside of the histogram, and land in the
+  // outermost bins
+  ASSERT_EQ(result.n_periods, 6);
+  ASSERT_THAT(histogram, ElementsAre(1, 1, 2, 1, 1));
+  ASSERT_EQ(result.min_period, sil::DurationUs{70});
+  ASSERT_EQ(result.max_period, sil::DurationUs{130});
+  ASSERT_DOUBLE_EQ(result.period_stddev_us, std::sqrt(2'000.0 / 6.0));
+}
+
+TEST(WaveformTest, EmptyRingHasNoPeriods) {
+  sil::EdgeCapture capture{};
+  capture.Enable(16);
+
+  std::array<uint64_t, 3> histogram{7, 7, 7};
+  const auto result = sil::AnalyzeWaveform(capture, {}, histogram);
+
+  ASSERT_EQ(result.n_periods, 0);
+  ASSERT_DOUBLE_EQ(result.mean_frequency, 0.0);
+  ASSERT_DOUBLE_EQ(result.min_duty_cycle, 0.0);
+  ASSERT_THAT(histogram, ElementsAre(0, 0, 0));
+}
+
+TEST(WaveformTest, FullRingOverwritesOldestEdges) {
+  sil::EdgeCapture capture{};
+  capture.Enable(4);
+
+  for (const auto& record : SquareWave({{50, 50}, {50, 50}, {50, 50}})) {
+    capture.Write(record.timestamp, record.edge);
+  }
+  ASSERT_EQ(capture.GetCount(), 4);
+  ASSERT_EQ(capture.GetDropCount(), 3);
+  ASSERT_EQ(capture[0].timestamp, sil::TimePointUs{150});
+
+  std::array<uint64_t, 8> timestamps{};
+  std::array<uint8_t, 8>  edges{};
+  ASSERT_EQ(capture.Read(timestamps, edges), 4);
+  ASSERT_THAT(std::span{timestamps}.first(4), ElementsAre(150, 200, 250, 300));
+  ASSERT_THAT(std::span{edges}.first(4), ElementsAre(1, 0, 1, 0));
+}
+
+TEST(WaveformTest, AnalysisOfRingExcludesEdgesThatWereRead) {
+  sil::EdgeCapture capture{};
+  capture.Enable(16);
+  for (const auto& record : SquareWave({{20, 80}, {50, 50}, {50, 50}})) {
+    capture.Write(record.timestamp, record.edge);
+  }
+
+  // Analyzing does not consume the edges
+  ASSERT_EQ(sil::AnalyzeWaveform(capture, {}, {}).n_periods, 3);
+  ASSERT_EQ(capture.GetCount(), 7);
+
+  std::array<uint64_t, 2> timestamps{};
+  std::array<uint8_t, 2>  edges{};
+  ASSERT_EQ(capture.Read(timestamps, edges), 2);
+
+  const auto result = sil::AnalyzeWaveform(capture, {}, {});
+  ASSERT_EQ(result.n_periods, 2);
+  ASSERT_DOUBLE_EQ(result.mean_duty_cycle, 0.5);
+}
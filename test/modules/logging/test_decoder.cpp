@@ -0,0 +1,175 @@
+#include <array>
+#include <cstdint>
+#include <memory>
+#include <span>
+#include <string>
+#include <vector>
+
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+
+import logging;
+import logging.decoder;
+
+using namespace ::testing;
+
+namespace {
+
+using HelloMsg = logging::Message<"Hello World!">;
+using CountMsg = logging::Message<"Count={count}, stdev={stdev}", uint32_t, float>;
+using HexMsg   = logging::Message<"Reg={reg:04X}", uint16_t>;
+
+using MyModule    = logging::Module<0xABCD, "My.Module", HelloMsg, CountMsg, HexMsg>;
+using OtherModule = logging::Module<0x0001, "Other.Module", HelloMsg>;
+
+constexpr auto SpecJson = R"({
+  "modules": [
+    {
+      "id": 43981,
+      "name": "My.Module",
+      "enums": {},
+      "messages": [
+        {"id": 1, "message_template": "Hello World!", "arguments": []},
+        {"id": 2, "message_template": "Count={count}, stdev={stdev}", "arguments": [
+          {"name": "count", "type": "uint32", "format": null},
+          {"name": "stdev", "type": "float32", "format": null}
+        ]},
+        {"id": 3, "message_template": "Reg={reg:04X}", "arguments": [
+          {"name": "reg", "type": "uint16", "format": "04X"}
+        ]}
+      ]
+    },
+    {
+      "id": 1,
+      "name": "Other.Module",
+      "enums": {},
+      "messages": [
+        {"id": 1, "message_template": "Hello World!", "arguments": []}
+      ]
+    }
+  ]
+})";
+
+}   // namespace
+
+class Decoder : public Test {
+ public:
+  void SetUp() override {
+    spec = std::make_unique<logging::decoder::Spec>(logging::decoder::Spec::FromString(SpecJson));
+  }
+
+  template <typename Mod, typename Msg>
+  void Append(uint32_t ts, logging::Level level, const Msg& msg) {
+    std::array<std::byte, 64> buffer{};
+    const auto encoded = logging::encoding::Binary::Encode<Mod>(ts, level, msg, buffer);
+    stream.insert(stream.end(), encoded.begin(), encoded.end());
+  }
+
+  std::vector<std::string> FeedAll(std::span<const std::byte> data) {
+    std::vector<std::string>          result{};
+    const logging::decoder::Formatter formatter{*spec};
+
+    decoder.Feed(data, [&result, &formatter](const logging::decoder::Frame& frame) {
+      result.push_back(formatter.Format(frame).value_or("<error>"));
+    });
+
+    return result;
+  }
+
+ protected:
+  std::unique_ptr<logging::decoder::Spec> spec{nullptr};
+  logging::decoder::StreamDecoder         decoder{};
+  std::vector<std::byte>                  stream{};
+};
+
+TEST_F(Decoder, DecodesAndFormatsFrames) {
+  Append<MyModule>(10'000, logging::Level::Info, HelloMsg{});
+  Append<MyModule>(10'001, logging::Level::Error, CountMsg{123, 12.34F});
+  Append<MyModule>(10'002, logging::Level::Debug, HexMsg{0xBEU});
+
+  ASSERT_THAT(FeedAll(stream), ElementsAre("Hello World!", "Count=123, stdev=12.340", "Reg=00BE"));
+
+  const auto& stats = decoder.Statistics();
+  ASSERT_EQ(stats.frames_decoded, 3);
+  ASSERT_EQ(stats.crc_errors, 0);
+  ASSERT_EQ(stats.bytes_skipped, 0);
+}
+
+TEST_F(Decoder, HandlesArbitraryChunking) {
+  Append<MyModule>(10'000, logging::Level::Info, HelloMsg{});
+  Append<MyModule>(10'001, logging::Level::Error, CountMsg{123, 12.34F});
+
+  std::vector<std::string> messages{};
+  for (std::size_t i = 0; i < stream.size(); ++i) {
+    const auto decoded = FeedAll(std::span{stream}.subspan(i, 1));
+    messages.insert(messages.end(), decoded.begin(), decoded.end());
+  }
+
+  ASSERT_THAT(messages, ElementsAre("Hello World!", "Count=123, stdev=12.340"));
+}
+
+TEST_F(Decoder, ResynchronizesAfterGarbageAndCorruption) {
+  // Garbage containing a start byte
+  stream = {std::byte{0x00}, std::byte{'L'}, std::byte{0x12}, std::byte{0x34}};
+  Append<MyModule>(10'000, logging::Level::Info, HelloMsg{});
+
+  // Corrupted frame
+  const auto corrupt_pos = stream.size() + logging::decoder::HeaderSize;
+  Append<MyModule>(10'001, logging::Level::Error, CountMsg{123, 12.34F});
+  stream[corrupt_pos] ^= std::byte{0xFF};
+
+  Append<MyModule>(10'002, logging::Level::Warn, HexMsg{0x1234U});
+
+  ASSERT_THAT(FeedAll(stream), ElementsAre("Hello World!", "Reg=1234"));
+
+  const auto& stats = decoder.Statistics();
+  ASSERT_EQ(stats.frames_decoded, 2);
+  ASSERT_GE(stats.crc_errors, 1);
+  ASSERT_GE(stats.bytes_skipped, 4);
+}
+
+TEST_F(Decoder, AppliesFilter) {
+  Append<MyModule>(10'000, logging::Level::Debug, HelloMsg{});
+  Append<MyModule>(10'001, logging::Level::Error, HexMsg{0x1U});
+  Append<OtherModule>(10'002, logging::Level::Fatal, HelloMsg{});
+
+  logging::decoder::Filter filter{};
+  filter.SetMinLevel(logging::Level::Info);
+  const std::array<uint16_t, 1> modules{0xABCD};
+  filter.SetModules(modules);
+  decoder.SetFilter(std::move(filter));
+
+  ASSERT_THAT(FeedAll(stream), ElementsAre("Reg=0001"));
+  ASSERT_EQ(decoder.Statistics().frames_decoded, 3);
+  ASSERT_EQ(decoder.Statistics().frames_filtered, 2);
+}
+
+TEST_F(Decoder, ReportsUnknownMessages) {
+  using UnknownMsg    = logging::Message<"Unknown">;
+  using UnknownModule = logging::Module<0x1234, "Unknown.Module", UnknownMsg>;
+  Append<UnknownModule>(10'000, logging::Level::Info, UnknownMsg{});
+
+  const logging::decoder::Formatter formatter{*spec};
+  decoder.Feed(stream, [&formatter](const logging::decoder::Frame& frame) {
+    ASSERT_EQ(formatter.ModuleName(frame).error(), logging::decoder::FormatError::UnknownModule);
+    ASSERT_EQ(formatter.Format(frame).error(), logging::decoder::FormatError::UnknownModule);
+  });
+  ASSERT_EQ(decoder.Statistics().frames_decoded, 1);
+}
+
+TEST_F(Decoder, FormatsRepeatedRecords) {
+  std::array<std::byte, 64> buffer{};
+  const auto encoded = logging::encoding::Binary::EncodeRepeated<MyModule, CountMsg>(
+      10'000, logging::Level::Warn, 42, buffer);
+
+  ASSERT_THAT(FeedAll(encoded),
+              ElementsAre("Suppressed 42 repetitions of \"Count={count}, stdev={stdev}\""));
+}
+
+TEST_F(Decoder, FormatsSpanRecords) {
+  std::array<std::byte, 64> buffer{};
+  const auto encoded = logging::encoding::Binary::EncodeSpan<MyModule, HelloMsg>(
+      10'000, logging::SpanEdge::End, 1234, buffer);
+
+  ASSERT_THAT(FeedAll(encoded), ElementsAre("Span end \"Hello World!\" @ 1234 cycles"));
+}
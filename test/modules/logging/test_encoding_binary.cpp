@@ -87,4 +87,53 @@ TEST_F(BinaryEncoding, EncodeMessageWithData) {
       10'000, logging::Level::Error, CountMsg{123, f}, buffer);
 
   ASSERT_THAT(encode_result, ElementsAreArray(expected));
-}
\ No newline at end of file
+}
+
+TEST_F(BinaryEncoding, EncodedSizeMatchesEncodedMessage) {
+  static_assert(logging::encoding::Binary::EncodedSize<MyModule, HelloMsg>() == 12);
+  static_assert(logging::encoding::Binary::EncodedSize<MyModule, CountMsg>() == 20);
+
+  std::array<std::byte, logging::encoding::Binary::EncodedSize<MyModule, CountMsg>()> exact{};
+  const auto encode_result = logging::encoding::Binary::Encode<MyModule>(
+      10'000, logging::Level::Error, CountMsg{123, 1.0F}, exact);
+
+  ASSERT_EQ(encode_result.size(), exact.size());
+}
+
+TEST_F(BinaryEncoding, EncodeRepeatedRecord) {
+  const auto expected = MsgBuilder()
+                            .Write<uint8_t>('L')       // Start byte
+                            .Write<uint32_t>(10'000)   // Timestamp
+                            .Write<uint8_t>(40)        // Log Level - Warn
+                            .Write<uint16_t>(0xABCD)   // Module ID
+                            .Write<uint8_t>(0)         // Reserved "repeated" message ID
+                            .Write<uint8_t>(5)         // 5 data bytes
+                            .Write<uint8_t>(2)         // Suppressed message ID
+                            .Write<uint32_t>(42)       // Repetitions
+                            .WriteCrc16()              // CRC
+                            .Bytes();
+
+  const auto encode_result = logging::encoding::Binary::EncodeRepeated<MyModule, CountMsg>(
+      10'000, logging::Level::Warn, 42, buffer);
+
+  ASSERT_THAT(encode_result, ElementsAreArray(expected));
+}
+
+TEST_F(BinaryEncoding, EncodeSpanRecord) {
+  const auto expected = MsgBuilder()
+                            .Write<uint8_t>('L')          // Start byte
+                            .Write<uint32_t>(10'000)      // Timestamp
+                            .Write<uint8_t>(10)           // Log Level - Trace
+                            .Write<uint16_t>(0xABCD)      // Module ID
+                            .Write<uint8_t>(0xFE)         // Reserved "span begin" message ID
+                            .Write<uint8_t>(5)            // 5 data bytes
+                            .Write<uint8_t>(1)            // Span message ID
+                            .Write<uint32_t>(0x12345678)  // Cycle counter
+                            .WriteCrc16()                 // CRC
+                            .Bytes();
+
+  const auto encode_result = logging::encoding::Binary::EncodeSpan<MyModule, HelloMsg>(
+      10'000, logging::SpanEdge::Begin, 0x12345678, buffer);
+
+  ASSERT_THAT(encode_result, ElementsAreArray(expected));
+}
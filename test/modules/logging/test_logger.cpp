@@ -0,0 +1,222 @@
+#include <array>
+#include <chrono>
+#include <cstdint>
+#include <span>
+#include <vector>
+
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+
+import logging;
+
+import hal.test.helpers;
+
+using namespace ::testing;
+using namespace ::hal::test::helpers;
+
+namespace {
+
+using HelloMsg = logging::Message<"Hello World!">;
+using CountMsg = logging::Message<"Count={}, stdev={}", uint32_t, float>;
+
+using MyModule = logging::Module<0xABCD, "My.Module", HelloMsg, CountMsg>;
+
+struct FakeClock {
+  using rep        = uint32_t;
+  using period     = std::milli;
+  using duration   = std::chrono::duration<rep, period>;
+  using time_point = std::chrono::time_point<FakeClock>;
+
+  static constexpr bool is_steady = true;
+
+  static time_point now() noexcept { return time_point{duration{current}}; }
+
+  static inline rep current = 10'000;
+};
+
+/** @brief Sink that only supports writing encoded messages. */
+struct WriteSink {
+  void Write(std::span<const std::byte> data) { bytes.insert(bytes.end(), data.begin(), data.end()); }
+
+  std::vector<std::byte> bytes{};
+};
+
+/** @brief Sink that allows encoding into its own buffer. */
+struct ReserveSink {
+  void Write(std::span<const std::byte> data) {
+    n_writes++;
+    bytes.insert(bytes.end(), data.begin(), data.end());
+  }
+
+  std::span<std::byte> Reserve(std::size_t n) {
+    if (n > buffer.size() - used) {
+      return {};
+    }
+    return std::span{buffer}.subspan(used, n);
+  }
+
+  void Commit(std::size_t n) { used += n; }
+
+  std::array<std::byte, 32> buffer{};
+  std::size_t               used{0};
+  std::size_t               n_writes{0};
+  std::vector<std::byte>    bytes{};
+};
+
+static_assert(!logging::concepts::ReservingSink<WriteSink>);
+static_assert(logging::concepts::ReservingSink<ReserveSink>);
+
+using Logger      = logging::Logger<FakeClock, logging::encoding::Binary, WriteSink, MyModule>;
+using CountLimits = logging::RateLimits<logging::RateLimit<CountMsg, 2, 100>>;
+
+}   // namespace
+
+class ModuleLoggerTest : public Test {
+ public:
+  void SetUp() override {
+    FakeClock::current = 10'000;
+    Logger::Module<MyModule, CountLimits>::ResetRateLimits();
+  }
+};
+
+TEST_F(ModuleLoggerTest, WritesEncodedMessageToSink) {
+  WriteSink sink{};
+  logging::Logger<FakeClock, logging::encoding::Binary, WriteSink, MyModule> logger{sink};
+
+  auto module = logger.GetModule<MyModule>();
+  module.Error(CountMsg{123, 12.34F});
+
+  std::array<std::byte, 64> expected_buf{};
+  const auto expected = logging::encoding::Binary::Encode<MyModule>(
+      10'000, logging::Level::Error, CountMsg{123, 12.34F}, expected_buf);
+  ASSERT_THAT(sink.bytes, ElementsAreArray(expected));
+}
+
+TEST_F(ModuleLoggerTest, EncodesIntoReservedSinkMemory) {
+  ReserveSink sink{};
+  logging::Logger<FakeClock, logging::encoding::Binary, ReserveSink, MyModule> logger{sink};
+
+  auto module = logger.GetModule<MyModule>();
+  module.Info(HelloMsg{});
+
+  std::array<std::byte, 64> expected_buf{};
+  const auto expected = logging::encoding::Binary::Encode<MyModule>(
+      10'000, logging::Level::Info, HelloMsg{}, expected_buf);
+
+  ASSERT_EQ(sink.n_writes, 0);
+  ASSERT_EQ(sink.used, expected.size());
+  ASSERT_THAT(std::span{sink.buffer}.first(sink.used), ElementsAreArray(expected));
+}
+
+TEST_F(ModuleLoggerTest, DropsMessageWhenReserveFails) {
+  ReserveSink sink{};
+  logging::Logger<FakeClock, logging::encoding::Binary, ReserveSink, MyModule> logger{sink};
+
+  auto module = logger.GetModule<MyModule>();
+  module.Info(CountMsg{1, 2.0F});   // 20 bytes
+  module.Info(CountMsg{1, 2.0F});   // Does not fit anymore
+
+  ASSERT_EQ(sink.n_writes, 0);
+  ASSERT_EQ(sink.used, 20);
+}
+
+TEST_F(ModuleLoggerTest, RateLimitsMessagesAndReportsRepetitions) {
+  WriteSink sink{};
+  Logger    logger{sink};
+  auto      module = logger.GetModule<MyModule, CountLimits>();
+
+  // Burst of 2 is let through, the remaining messages are suppressed.
+  for (uint32_t i = 0; i < 5; ++i) {
+    module.Warn(CountMsg{i, 0.0F});
+  }
+  // Messages without a rate limit are unaffected.
+  module.Warn(HelloMsg{});
+
+  constexpr auto CountSize = logging::encoding::Binary::EncodedSize<MyModule, CountMsg>();
+  constexpr auto HelloSize = logging::encoding::Binary::EncodedSize<MyModule, HelloMsg>();
+  ASSERT_EQ(sink.bytes.size(), 2 * CountSize + HelloSize);
+
+  // After a refill period, a summary record precedes the next message.
+  sink.bytes.clear();
+  FakeClock::current += 100;
+  module.Warn(CountMsg{5, 0.0F});
+
+  std::array<std::byte, 64> expected_buf{};
+  const auto expected = logging::encoding::Binary::EncodeRepeated<MyModule, CountMsg>(
+      FakeClock::current, logging::Level::Warn, 3, expected_buf);
+
+  ASSERT_EQ(sink.bytes.size(), logging::encoding::Binary::RepeatedSize + CountSize);
+  ASSERT_THAT(std::span{sink.bytes}.first(expected.size()), ElementsAreArray(expected));
+
+  // The bucket holds a single token after one refill period.
+  sink.bytes.clear();
+  module.Warn(CountMsg{6, 0.0F});
+  ASSERT_TRUE(sink.bytes.empty());
+}
+
+TEST_F(ModuleLoggerTest, RateLimitsModuleLoggersThatAreObtainedPerMessage) {
+  WriteSink sink{};
+  Logger    logger{sink};
+
+  for (uint32_t i = 0; i < 5; ++i) {
+    logger.GetModule<MyModule, CountLimits>().Warn(CountMsg{i, 0.0F});
+  }
+
+  constexpr auto CountSize = logging::encoding::Binary::EncodedSize<MyModule, CountMsg>();
+  ASSERT_EQ(sink.bytes.size(), 2 * CountSize);
+}
+
+TEST_F(ModuleLoggerTest, FlushRateLimitsReportsRepetitionsThatStopped) {
+  WriteSink sink{};
+  Logger    logger{sink};
+  auto      module = logger.GetModule<MyModule, CountLimits>();
+
+  // Nothing is suppressed yet.
+  module.FlushRateLimits();
+  ASSERT_TRUE(sink.bytes.empty());
+
+  for (uint32_t i = 0; i < 5; ++i) {
+    module.Error(CountMsg{i, 0.0F});
+  }
+
+  sink.bytes.clear();
+  FakeClock::current += 20;
+  module.FlushRateLimits();
+
+  std::array<std::byte, 64> expected_buf{};
+  const auto expected = logging::encoding::Binary::EncodeRepeated<MyModule, CountMsg>(
+      FakeClock::current, logging::Level::Error, 3, expected_buf);
+  ASSERT_THAT(sink.bytes, ElementsAreArray(expected));
+
+  // The summary is only reported once.
+  sink.bytes.clear();
+  module.FlushRateLimits();
+  ASSERT_TRUE(sink.bytes.empty());
+}
+
+TEST_F(ModuleLoggerTest, ScopedSpanLogsBeginAndEndRecords) {
+  WriteSink sink{};
+  Logger    logger{sink};
+  auto      module = logger.GetModule<MyModule>();
+
+  EXPECT_CALL(MockPerformanceTimer::MockInstance(), MockGet())
+      .WillOnce(Return(1'000))
+      .WillOnce(Return(1'500));
+
+  {
+    logging::ScopedSpan<decltype(module), HelloMsg, MockPerformanceTimer> span{module};
+  }
+
+  std::array<std::byte, 64> begin_buf{};
+  std::array<std::byte, 64> end_buf{};
+  const auto                begin = logging::encoding::Binary::EncodeSpan<MyModule, HelloMsg>(
+      10'000, logging::SpanEdge::Begin, 1'000, begin_buf);
+  const auto end = logging::encoding::Binary::EncodeSpan<MyModule, HelloMsg>(
+      10'000, logging::SpanEdge::End, 1'500, end_buf);
+
+  ASSERT_EQ(sink.bytes.size(), begin.size() + end.size());
+  ASSERT_THAT(std::span{sink.bytes}.first(begin.size()), ElementsAreArray(begin));
+  ASSERT_THAT(std::span{sink.bytes}.last(end.size()), ElementsAreArray(end));
+
+  MockPerformanceTimer::Reset();
+}
@@ -0,0 +1,90 @@
+#include <cstdint>
+#include <thread>
+#include <vector>
+
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+
+import seq.abstract;
+import seq.port.queue.atomic_queue;
+
+using namespace ::testing;
+
+static_assert(seq::concepts::Queue<seq::port::AtomicQueue<seq::EventRecord, 8>, seq::EventRecord>);
+
+TEST(AtomicQueue, PopsInInsertionOrder) {
+  seq::port::AtomicQueue<uint32_t, 4> queue{};
+
+  ASSERT_TRUE(queue.Push(1));
+  ASSERT_TRUE(queue.Push(2));
+  ASSERT_TRUE(queue.Push(3));
+
+  ASSERT_EQ(queue.Pop(), 1);
+  ASSERT_EQ(queue.Pop(), 2);
+  ASSERT_EQ(queue.Pop(), 3);
+  ASSERT_EQ(queue.Pop(), std::nullopt);
+}
+
+TEST(AtomicQueue, RejectsPushWhenFull) {
+  seq::port::AtomicQueue<uint32_t, 4> queue{};
+
+  for (uint32_t i = 0; i < 4; ++i) {
+    ASSERT_TRUE(queue.Push(i));
+  }
+  ASSERT_FALSE(queue.Push(4));
+
+  // Popping frees a slot again.
+  ASSERT_EQ(queue.Pop(), 0);
+  ASSERT_TRUE(queue.Push(4));
+}
+
+TEST(AtomicQueue, ReadAllEmptiesQueueAcrossWrapAround) {
+  seq::port::AtomicQueue<uint32_t, 4> queue{};
+  std::vector<uint32_t>               read{};
+
+  for (uint32_t lap = 0; lap < 3; ++lap) {
+    for (uint32_t i = 0; i < 3; ++i) {
+      ASSERT_TRUE(queue.Push(lap * 3 + i));
+    }
+    queue.ReadAll([&read](uint32_t value) { read.push_back(value); });
+  }
+
+  ASSERT_THAT(read, ElementsAre(0, 1, 2, 3, 4, 5, 6, 7, 8));
+  ASSERT_EQ(queue.Pop(), std::nullopt);
+}
+
+TEST(AtomicQueue, ConcurrentProducersDeliverEveryElementInPerProducerOrder) {
+  constexpr uint32_t NProducers   = 4;
+  constexpr uint32_t NPerProducer = 20'000;
+
+  seq::port::AtomicQueue<seq::EventRecord, 64> queue{};
+
+  std::vector<std::thread> producers{};
+  for (uint32_t p = 0; p < NProducers; ++p) {
+    producers.emplace_back([&queue, p] {
+      for (uint32_t i = 0; i < NPerProducer; ++i) {
+        while (!queue.Push(seq::EventRecord{.timestamp = 0, .id = p, .data = i})) {
+          std::this_thread::yield();
+        }
+      }
+    });
+  }
+
+  std::vector<uint32_t> next(NProducers, 0);
+  uint32_t              n_received = 0;
+  while (n_received < NProducers * NPerProducer) {
+    queue.ReadAll([&](const seq::EventRecord& record) {
+      EXPECT_LT(record.id, NProducers);
+      EXPECT_EQ(record.data, next[record.id]);
+      next[record.id]++;
+      n_received++;
+    });
+  }
+
+  for (auto& producer : producers) {
+    producer.join();
+  }
+
+  ASSERT_THAT(next, Each(NPerProducer));
+  ASSERT_EQ(queue.Pop(), std::nullopt);
+}
@@ -0,0 +1,137 @@
+#include <cstdint>
+#include <deque>
+#include <optional>
+#include <utility>
+#include <vector>
+
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+
+import seq;
+import seq.port.queue.atomic_queue;
+
+using namespace ::testing;
+
+namespace {
+
+using PinEvent   = seq::Event<uint8_t{1}, uint8_t{1}, uint16_t{1}, uint32_t>;
+using TickEvent  = seq::Event<uint8_t{1}, uint8_t{1}, uint16_t{2}, uint32_t>;
+using DataEvent  = seq::Event<uint8_t{1}, uint8_t{1}, uint16_t{3}, uint32_t>;
+using OtherEvent = seq::Event<uint8_t{1}, uint8_t{1}, uint16_t{4}, uint32_t>;
+
+using Policies = seq::EventPolicies<seq::EventPolicy<PinEvent, seq::QueuePolicy::LatestWins>,
+                                    seq::EventPolicy<TickEvent, seq::QueuePolicy::Count>,
+                                    seq::EventPolicy<DataEvent, seq::QueuePolicy::DropOldest>>;
+
+/** @brief Bounded queue that supports evicting its oldest element. */
+template <std::size_t N>
+struct OverwritingQueue {
+  bool Push(const seq::EventRecord& record) {
+    if (records.size() == N) {
+      return false;
+    }
+    records.push_back(record);
+    return true;
+  }
+
+  std::optional<seq::EventRecord> PushOverwrite(const seq::EventRecord& record) {
+    std::optional<seq::EventRecord> evicted{};
+    if (records.size() == N) {
+      evicted = records.front();
+      records.pop_front();
+    }
+    records.push_back(record);
+    return evicted;
+  }
+
+  std::optional<seq::EventRecord> Pop() {
+    if (records.empty()) {
+      return std::nullopt;
+    }
+    const auto result = records.front();
+    records.pop_front();
+    return result;
+  }
+
+  std::deque<seq::EventRecord> records{};
+};
+
+static_assert(seq::concepts::OverwritingQueue<OverwritingQueue<4>, seq::EventRecord>);
+static_assert(
+    !seq::concepts::OverwritingQueue<seq::port::AtomicQueue<seq::EventRecord, 4>, seq::EventRecord>);
+
+seq::EventRecord Record(uint32_t id, uint32_t data) {
+  return {.timestamp = 0, .id = id, .data = data};
+}
+
+template <typename Q>
+std::vector<std::pair<uint32_t, uint32_t>> Drain(seq::Coalescer<Policies>& coalescer, Q& queue) {
+  std::vector<std::pair<uint32_t, uint32_t>> result{};
+  while (const auto record = queue.Pop()) {
+    const auto taken = coalescer.Take(*record);
+    result.emplace_back(taken.id, taken.data);
+  }
+  return result;
+}
+
+}   // namespace
+
+TEST(Coalescer, LatestWinsKeepsSinglePendingEventWithLatestData) {
+  seq::Coalescer<Policies>                    coalescer{};
+  seq::port::AtomicQueue<seq::EventRecord, 8> queue{};
+
+  coalescer.Push(queue, Record(PinEvent::Id, 1));
+  coalescer.Push(queue, Record(PinEvent::Id, 2));
+  coalescer.Push(queue, Record(PinEvent::Id, 3));
+
+  ASSERT_THAT(Drain(coalescer, queue), ElementsAre(Pair(PinEvent::Id, 3)));
+  ASSERT_EQ(coalescer.Statistics().coalesced, 2);
+
+  // After dispatching, the next push is queued again.
+  coalescer.Push(queue, Record(PinEvent::Id, 4));
+  ASSERT_THAT(Drain(coalescer, queue), ElementsAre(Pair(PinEvent::Id, 4)));
+}
+
+TEST(Coalescer, CountMergesPushesIntoCount) {
+  seq::Coalescer<Policies>                    coalescer{};
+  seq::port::AtomicQueue<seq::EventRecord, 8> queue{};
+
+  for (int i = 0; i < 5; ++i) {
+    coalescer.Push(queue, Record(TickEvent::Id, 0));
+  }
+  coalescer.Push(queue, Record(OtherEvent::Id, 7));
+
+  ASSERT_THAT(Drain(coalescer, queue),
+              ElementsAre(Pair(TickEvent::Id, 5), Pair(OtherEvent::Id, 7)));
+}
+
+TEST(Coalescer, CountsAndReportsDroppedEvents) {
+  seq::Coalescer<Policies>                    coalescer{};
+  seq::port::AtomicQueue<seq::EventRecord, 2> queue{};
+
+  for (uint32_t i = 0; i < 5; ++i) {
+    coalescer.Push(queue, Record(OtherEvent::Id, i));
+  }
+
+  ASSERT_EQ(coalescer.Statistics().dropped, 3);
+  ASSERT_EQ(coalescer.TakeUnreportedDrops(), 3);
+  ASSERT_EQ(coalescer.TakeUnreportedDrops(), 0);
+}
+
+TEST(Coalescer, DropOldestEvictsOldestQueuedEvent) {
+  seq::Coalescer<Policies> coalescer{};
+  OverwritingQueue<2>      queue{};
+
+  coalescer.Push(queue, Record(PinEvent::Id, 1));
+  coalescer.Push(queue, Record(DataEvent::Id, 2));
+  coalescer.Push(queue, Record(DataEvent::Id, 3));
+
+  ASSERT_EQ(coalescer.Statistics().evicted, 1);
+  ASSERT_EQ(coalescer.Statistics().dropped, 0);
+  ASSERT_THAT(Drain(coalescer, queue),
+              ElementsAre(Pair(DataEvent::Id, 2), Pair(DataEvent::Id, 3)));
+
+  // The evicted latest-wins event is queued again on its next push.
+  coalescer.Push(queue, Record(PinEvent::Id, 4));
+  ASSERT_THAT(Drain(coalescer, queue), ElementsAre(Pair(PinEvent::Id, 4)));
+}
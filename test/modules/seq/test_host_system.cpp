@@ -0,0 +1,42 @@
+#include <atomic>
+#include <chrono>
+#include <thread>
+
+#include <gtest/gtest.h>
+
+import seq.abstract;
+import seq.port.system.host;
+
+using namespace std::chrono_literals;
+
+static_assert(seq::concepts::NotifiableSystem<seq::port::HostSystem>);
+static_assert(seq::concepts::TicklessSystem<seq::port::HostSystem, std::chrono::microseconds>);
+
+TEST(HostSystem, PendingNotificationWakesNextWait) {
+  seq::port::HostSystem::Notify();
+
+  // Must return immediately, as the notification arrived before the wait.
+  seq::port::HostSystem::WaitForNextEvent();
+}
+
+TEST(HostSystem, WaitWakesOnNotifyFromOtherThread) {
+  std::atomic_bool woken{false};
+
+  std::thread waiter{[&woken] {
+    seq::port::HostSystem::WaitForNextEvent();
+    woken = true;
+  }};
+
+  std::this_thread::sleep_for(10ms);
+  seq::port::HostSystem::Notify();
+  waiter.join();
+
+  ASSERT_TRUE(woken);
+}
+
+TEST(HostSystem, TimedWaitReturnsAfterTimeout) {
+  const auto start = std::chrono::steady_clock::now();
+  seq::port::HostSystem::WaitForNextEvent(std::chrono::microseconds{5'000});
+
+  ASSERT_GE(std::chrono::steady_clock::now() - start, 5ms);
+}
@@ -0,0 +1,170 @@
+#include <chrono>
+#include <cstdint>
+#include <deque>
+#include <optional>
+#include <utility>
+#include <vector>
+
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+
+import seq;
+
+using namespace ::testing;
+
+namespace {
+
+using Duration = std::chrono::duration<uint32_t, std::micro>;
+
+using LowEvent   = seq::Event<uint8_t{1}, uint8_t{1}, uint16_t{1}, uint32_t>;
+using MidEvent   = seq::Event<uint8_t{1}, uint8_t{2}, uint16_t{1}, uint32_t>;
+using AlarmEvent = seq::Event<uint8_t{1}, uint8_t{1}, uint16_t{2}, uint32_t>;
+using ServoEvent = seq::Event<uint8_t{1}, uint8_t{1}, uint16_t{3}, uint32_t>;
+
+/** @brief Alarm with a priority declared in the OS settings. */
+using HighAlarmEvent = seq::PrioritizedEvent<AlarmEvent, 2>;
+/** @brief Event that only has its priority when emitted as the prioritized event. */
+using UrgentEvent = seq::PrioritizedEvent<ServoEvent, 2>;
+
+/** @brief Thrown by the system when the OS loop waits, i.e. after it handled all queued events. */
+struct LoopIdle {};
+
+struct IdleSystem {
+  static void WaitForNextEvent() { throw LoopIdle{}; }
+};
+
+struct FakeClock {
+  static Duration Now() noexcept { return Duration{ticks}; }
+
+  static inline uint32_t ticks = 0;
+};
+
+/** @brief Unbounded FIFO queue. */
+struct DequeQueue {
+  bool Push(const seq::EventRecord& record) {
+    records.push_back(record);
+    return true;
+  }
+
+  std::optional<seq::EventRecord> Pop() {
+    if (records.empty()) {
+      return std::nullopt;
+    }
+    const auto result = records.front();
+    records.pop_front();
+    return result;
+  }
+
+  std::deque<seq::EventRecord> records{};
+};
+
+/** @brief Three priority levels, module 2 has priority 1 and the alarm has priority 2. */
+template <std::size_t Budget>
+struct Settings : seq::PriorityOsSettings<IdleSystem, DequeQueue, 3, Budget> {
+  using Clock           = FakeClock;
+  using EventPriorities = seq::EventPriorities<HighAlarmEvent>;
+
+  static constexpr bool TrackLatency = true;
+
+  static constexpr std::size_t PriorityOf(seq::EventIdRecord id) noexcept {
+    return id.mod_id == 2 ? 1 : 0;
+  }
+};
+
+/** @brief Module that records the (event ID, data) of the events it handles. */
+struct RecordingModule {
+  void operator()(uint32_t id, uint32_t data) {
+    events.emplace_back(id, data);
+    FakeClock::ticks += handling_time;
+  }
+
+  std::vector<std::pair<uint32_t, uint32_t>> events{};
+  uint32_t                                   handling_time{0};
+};
+
+/** @brief Runs the OS loop until it has handled all queued events. */
+template <typename Os>
+void RunUntilIdle(Os& os, RecordingModule& module) {
+  ASSERT_THROW(os.Run(module), LoopIdle);
+}
+
+}   // namespace
+
+class PriorityTest : public Test {
+ public:
+  void SetUp() override { FakeClock::ticks = 1'000; }
+};
+
+TEST_F(PriorityTest, DispatchesHighestPriorityFirst) {
+  using Os = seq::Os<Settings<0>>;
+  Os              os{};
+  RecordingModule module{};
+
+  LowEvent::Emit<Os::EventSink>(1);
+  MidEvent::Emit<Os::EventSink>(2);
+  LowEvent::Emit<Os::EventSink>(3);
+  UrgentEvent::Emit<Os::EventSink>(4);
+  MidEvent::Emit<Os::EventSink>(5);
+
+  RunUntilIdle(os, module);
+  ASSERT_THAT(module.events,
+              ElementsAre(Pair(UrgentEvent::Id, 4), Pair(MidEvent::Id, 2), Pair(MidEvent::Id, 5),
+                          Pair(LowEvent::Id, 1), Pair(LowEvent::Id, 3)));
+}
+
+TEST_F(PriorityTest, DeclaredPriorityAppliesToEveryPushOfTheEvent) {
+  using Os = seq::Os<Settings<0>>;
+  Os              os{};
+  RecordingModule module{};
+
+  MidEvent::Emit<Os::EventSink>(1);
+  AlarmEvent::Emit<Os::EventSink>(2);
+  Os::EventSink::Push(AlarmEvent::Id, 3);
+  HighAlarmEvent::Emit<Os::EventSink>(4);
+
+  RunUntilIdle(os, module);
+  ASSERT_THAT(module.events,
+              ElementsAre(Pair(AlarmEvent::Id, 2), Pair(AlarmEvent::Id, 3),
+                          Pair(AlarmEvent::Id, 4), Pair(MidEvent::Id, 1)));
+}
+
+TEST_F(PriorityTest, BudgetLetsLowerPrioritiesProgress) {
+  using Os = seq::Os<Settings<2>>;
+  Os              os{};
+  RecordingModule module{};
+
+  for (uint32_t i = 0; i < 3; ++i) {
+    UrgentEvent::Emit<Os::EventSink>(i);
+    LowEvent::Emit<Os::EventSink>(i);
+  }
+
+  RunUntilIdle(os, module);
+  ASSERT_THAT(module.events,
+              ElementsAre(Pair(UrgentEvent::Id, 0), Pair(UrgentEvent::Id, 1),
+                          Pair(LowEvent::Id, 0), Pair(LowEvent::Id, 1),
+                          Pair(UrgentEvent::Id, 2), Pair(LowEvent::Id, 2)));
+}
+
+TEST_F(PriorityTest, TracksWorstCaseLatencyPerPriority) {
+  using Os = seq::Os<Settings<0>>;
+  Os              os{};
+  RecordingModule module{.handling_time = 10};
+
+  LowEvent::Emit<Os::EventSink>(0);
+  FakeClock::ticks += 5;
+  LowEvent::Emit<Os::EventSink>(1);
+  UrgentEvent::Emit<Os::EventSink>(2);
+  UrgentEvent::Emit<Os::EventSink>(3);
+
+  // Urgent events wait 0 and 10 ticks, low events wait 25 and 30 ticks.
+  RunUntilIdle(os, module);
+  const auto& stats = os.GetLatencyStatistics();
+  ASSERT_EQ(stats[2].max_latency, 10);
+  ASSERT_EQ(stats[2].n_events, 2);
+  ASSERT_EQ(stats[1].n_events, 0);
+  ASSERT_EQ(stats[0].max_latency, 30);
+  ASSERT_EQ(stats[0].n_events, 2);
+
+  os.ResetLatencyStatistics();
+  ASSERT_EQ(os.GetLatencyStatistics()[0].n_events, 0);
+}
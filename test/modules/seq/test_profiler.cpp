@@ -0,0 +1,120 @@
+#include <array>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+
+import hstd;
+
+import seq;
+
+import hal.test.helpers;
+
+using namespace ::testing;
+using namespace ::hal::test::helpers;
+
+namespace {
+
+using TestProfiler = seq::Profiler<MockPerformanceTimer, 2, 2, 1>;
+
+}   // namespace
+
+class ProfilerTest : public Test {
+ public:
+  void TearDown() override { MockPerformanceTimer::Reset(); }
+};
+
+TEST_F(ProfilerTest, AccountsHandlerCyclesPerEventAndModule) {
+  TestProfiler profiler{};
+
+  EXPECT_CALL(MockPerformanceTimer::MockInstance(), MockGet())
+      .WillOnce(Return(100))
+      .WillOnce(Return(150))
+      .WillOnce(Return(200))
+      .WillOnce(Return(230))
+      .WillOnce(Return(300))
+      .WillOnce(Return(380));
+
+  int n_calls = 0;
+  profiler.BeginEvent(0x1234);
+  profiler.Call<0>([&n_calls] { n_calls++; });
+  profiler.Call<1>([&n_calls] { n_calls++; });
+  profiler.BeginEvent(0x1234);
+  profiler.Call<0>([&n_calls] { n_calls++; });
+
+  ASSERT_EQ(n_calls, 3);
+
+  const auto& profile = profiler.Get();
+  ASSERT_EQ(profile.n_events, 1);
+  ASSERT_EQ(profile.event_ids[0], 0x1234);
+  ASSERT_EQ(profile.handlers[0][0].n_calls, 2);
+  ASSERT_EQ(profile.handlers[0][0].max_cycles, 80);
+  ASSERT_EQ(profile.handlers[0][0].total_cycles, 130);
+  ASSERT_EQ(profile.handlers[0][1].n_calls, 1);
+  ASSERT_EQ(profile.handlers[0][1].total_cycles, 30);
+}
+
+TEST_F(ProfilerTest, CountsUntrackedEventsWhenTableIsFull) {
+  TestProfiler profiler{};
+
+  profiler.BeginEvent(1);
+  profiler.BeginEvent(2);
+  profiler.BeginEvent(3);
+  profiler.BeginEvent(1);
+
+  ASSERT_EQ(profiler.Get().n_events, 2);
+  ASSERT_EQ(profiler.Get().n_untracked, 1);
+}
+
+TEST_F(ProfilerTest, MeasuresIdleRatioAndMostEventsDrainedPerPass) {
+  TestProfiler profiler{};
+
+  EXPECT_CALL(MockPerformanceTimer::MockInstance(), MockGet())
+      .WillOnce(Return(0))      // Start
+      .WillOnce(Return(250))    // BeginWait
+      .WillOnce(Return(1000));  // EndWait
+
+  profiler.Start();
+  profiler.QueueDrained(0, 3);
+  profiler.QueueDrained(0, 1);
+  profiler.BeginWait();
+  profiler.EndWait();
+
+  const auto& profile = profiler.Get();
+  ASSERT_EQ(profile.busy_cycles, 250);
+  ASSERT_EQ(profile.idle_cycles, 750);
+  ASSERT_FLOAT_EQ(profile.IdleRatio(), 0.75F);
+  ASSERT_EQ(profile.max_drained_per_pass[0], 3);
+}
+
+TEST_F(ProfilerTest, DumpsCompactBinaryProfile) {
+  TestProfiler profiler{};
+
+  EXPECT_CALL(MockPerformanceTimer::MockInstance(), MockGet())
+      .WillOnce(Return(10))
+      .WillOnce(Return(52));
+
+  profiler.BeginEvent(0xAABBCCDD);
+  profiler.Call<1>([] {});
+
+  std::array<std::byte, TestProfiler::Snapshot::DumpSize> buffer{};
+  const auto dump = profiler.Get().Dump(buffer);
+
+  // Header, the most drained events of one priority and a single event ID with two modules.
+  ASSERT_EQ(dump.size(), 24 + 4 + 4 + 2 * 16);
+  ASSERT_EQ(dump[0], TestProfiler::Snapshot::DumpMagic);
+  ASSERT_EQ(dump[1], std::byte{2});
+  ASSERT_EQ(dump[2], std::byte{1});
+  ASSERT_EQ(dump[3], std::byte{1});
+  ASSERT_EQ((hstd::BytesToInt<uint32_t, std::endian::little>(dump.subspan(28))), 0xAABBCCDD);
+
+  // Second module: calls, max cycles, total cycles.
+  ASSERT_EQ((hstd::BytesToInt<uint32_t, std::endian::little>(dump.subspan(48))), 1);
+  ASSERT_EQ((hstd::BytesToInt<uint32_t, std::endian::little>(dump.subspan(52))), 42);
+  ASSERT_EQ((hstd::BytesToInt<uint64_t, std::endian::little>(dump.subspan(56))), 42);
+
+  std::array<std::byte, 8> too_small{};
+  ASSERT_TRUE(profiler.Get().Dump(too_small).empty());
+}
@@ -0,0 +1,94 @@
+#include <cstdint>
+#include <tuple>
+#include <utility>
+#include <vector>
+
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+
+import seq;
+
+using namespace ::testing;
+
+namespace {
+
+using StartEvent = seq::Event<uint8_t{1}, uint8_t{1}, uint16_t{1}, uint32_t>;
+using StopEvent  = seq::Event<uint8_t{1}, uint8_t{1}, uint16_t{2}, uint32_t>;
+using OtherEvent = seq::Event<uint8_t{1}, uint8_t{1}, uint16_t{3}, uint32_t>;
+
+/** @brief Calls of all modules, as (module, event ID). */
+using CallLog = std::vector<std::pair<int, uint32_t>>;
+
+/** @brief Module that receives every event. */
+template <int N>
+struct AllModule {
+  void operator()(uint32_t id, uint32_t) { log.emplace_back(N, id); }
+
+  CallLog& log;
+};
+
+/** @brief Module that only receives the events it subscribed to. */
+template <int N, typename... Events>
+struct SubscribedModule {
+  using Subscriptions = seq::Subscriptions<Events...>;
+
+  void operator()(uint32_t id, uint32_t) { log.emplace_back(N, id); }
+
+  CallLog& log;
+};
+
+template <typename... Modules>
+void Dispatch(std::tuple<Modules&...> modules, uint32_t id) {
+  seq::NullDispatchObserver obs{};
+  seq::EventRouter<seq::NullDispatchObserver, Modules...>::Dispatch(
+      modules, obs, {.timestamp = 0, .id = id, .data = 0});
+}
+
+}   // namespace
+
+TEST(EventRouter, DispatchesEveryEventToUnsubscribedModules) {
+  CallLog      log{};
+  AllModule<0> a{log};
+  AllModule<1> b{log};
+
+  Dispatch(std::tie(a, b), StartEvent::Id);
+  Dispatch(std::tie(a, b), OtherEvent::Id);
+
+  ASSERT_THAT(log, ElementsAre(Pair(0, StartEvent::Id), Pair(1, StartEvent::Id),
+                               Pair(0, OtherEvent::Id), Pair(1, OtherEvent::Id)));
+}
+
+TEST(EventRouter, DispatchesOnlySubscribedEventsToSubscribedModules) {
+  CallLog                                    log{};
+  SubscribedModule<0, StartEvent>            a{log};
+  SubscribedModule<1, StartEvent, StopEvent> b{log};
+
+  Dispatch(std::tie(a, b), StartEvent::Id);
+  Dispatch(std::tie(a, b), StopEvent::Id);
+  Dispatch(std::tie(a, b), OtherEvent::Id);
+
+  ASSERT_THAT(log, ElementsAre(Pair(0, StartEvent::Id), Pair(1, StartEvent::Id),
+                               Pair(1, StopEvent::Id)));
+}
+
+TEST(EventRouter, CallsMixedModulesInDeclarationOrder) {
+  CallLog                         log{};
+  SubscribedModule<0, StartEvent> a{log};
+  AllModule<1>                    b{log};
+  SubscribedModule<2, StopEvent>  c{log};
+  AllModule<3>                    d{log};
+
+  Dispatch(std::tie(a, b, c, d), StartEvent::Id);
+  ASSERT_THAT(log, ElementsAre(Pair(0, StartEvent::Id), Pair(1, StartEvent::Id),
+                               Pair(3, StartEvent::Id)));
+
+  log.clear();
+  Dispatch(std::tie(a, b, c, d), StopEvent::Id);
+  ASSERT_THAT(log, ElementsAre(Pair(1, StopEvent::Id), Pair(2, StopEvent::Id),
+                               Pair(3, StopEvent::Id)));
+
+  // Events without subscribers only reach the unsubscribed modules
+  log.clear();
+  Dispatch(std::tie(a, b, c, d), OtherEvent::Id);
+  ASSERT_THAT(log, ElementsAre(Pair(1, OtherEvent::Id), Pair(3, OtherEvent::Id)));
+}
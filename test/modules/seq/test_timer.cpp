@@ -0,0 +1,156 @@
+#include <chrono>
+#include <cstdint>
+#include <optional>
+#include <utility>
+#include <vector>
+
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+
+import seq;
+
+using namespace ::testing;
+
+namespace {
+
+using Duration = std::chrono::duration<uint32_t, std::micro>;
+
+struct FakeClock {
+  static Duration Now() noexcept { return Duration{ticks}; }
+
+  static inline uint32_t ticks = 0;
+};
+
+using Timers = seq::TimerService<FakeClock, Duration, 4>;
+
+/** @brief Expires all due timers, and returns the (event ID, timestamp) of the emitted events. */
+std::vector<std::pair<uint32_t, uint32_t>> Expire(Timers& timers) {
+  std::vector<std::pair<uint32_t, uint32_t>> events{};
+  timers.Expire([&events](const seq::EventRecord& event) {
+    events.emplace_back(event.id, event.timestamp);
+  });
+  return events;
+}
+
+}   // namespace
+
+class TimerServiceTest : public Test {
+ public:
+  void SetUp() override { FakeClock::ticks = 1'000; }
+};
+
+TEST_F(TimerServiceTest, OneShotTimerExpiresOnce) {
+  Timers timers{};
+  ASSERT_TRUE(timers.Start(1, 0, Duration{100}, Duration::zero()).has_value());
+  ASSERT_EQ(timers.TimeUntilNextDeadline(), Duration{100});
+
+  FakeClock::ticks = 1'099;
+  ASSERT_THAT(Expire(timers), IsEmpty());
+
+  FakeClock::ticks = 1'100;
+  ASSERT_THAT(Expire(timers), ElementsAre(Pair(1, 1'100)));
+
+  FakeClock::ticks = 1'500;
+  ASSERT_THAT(Expire(timers), IsEmpty());
+  ASSERT_EQ(timers.TimeUntilNextDeadline(), std::nullopt);
+}
+
+TEST_F(TimerServiceTest, PeriodicTimerRepeatsAndSkipsMissedPeriods) {
+  Timers timers{};
+  ASSERT_TRUE(timers.Start(2, 0, Duration{100}, Duration{100}).has_value());
+
+  FakeClock::ticks = 1'100;
+  ASSERT_THAT(Expire(timers), ElementsAre(Pair(2, 1'100)));
+  ASSERT_EQ(timers.TimeUntilNextDeadline(), Duration{100});
+
+  // Missed periods result in a single event, after which the timer stays on its period grid.
+  FakeClock::ticks = 1'450;
+  ASSERT_THAT(Expire(timers), ElementsAre(Pair(2, 1'200)));
+  ASSERT_EQ(timers.TimeUntilNextDeadline(), Duration{50});
+}
+
+TEST_F(TimerServiceTest, ExpiresTimersInDeadlineOrder) {
+  Timers timers{};
+  timers.Start(1, 0, Duration{300}, Duration::zero());
+  timers.Start(2, 0, Duration{100}, Duration::zero());
+  timers.Start(3, 0, Duration{200}, Duration::zero());
+
+  FakeClock::ticks = 2'000;
+  ASSERT_THAT(Expire(timers), ElementsAre(Pair(2, 1'100), Pair(3, 1'200), Pair(1, 1'300)));
+}
+
+TEST_F(TimerServiceTest, CancelStopsTimerAndInvalidatesHandle) {
+  Timers     timers{};
+  const auto a = timers.Start(1, 0, Duration{100}, Duration{100});
+  const auto b = timers.Start(2, 0, Duration{200}, Duration::zero());
+  ASSERT_TRUE(a.has_value());
+  ASSERT_TRUE(b.has_value());
+
+  ASSERT_TRUE(timers.Cancel(*a));
+  ASSERT_FALSE(timers.Cancel(*a));
+  ASSERT_EQ(timers.TimeUntilNextDeadline(), Duration{200});
+
+  // The freed slot is reused, but the old handle does not cancel the new timer.
+  const auto c = timers.Start(3, 0, Duration{50}, Duration::zero());
+  ASSERT_TRUE(c.has_value());
+  ASSERT_FALSE(timers.Cancel(*a));
+
+  FakeClock::ticks = 1'200;
+  ASSERT_THAT(Expire(timers), ElementsAre(Pair(3, 1'050), Pair(2, 1'200)));
+}
+
+TEST_F(TimerServiceTest, FailsToStartWhenAllSlotsAreInUse) {
+  Timers timers{};
+  for (uint32_t i = 0; i < 4; ++i) {
+    ASSERT_TRUE(timers.Start(i, 0, Duration{100}, Duration::zero()).has_value());
+  }
+  ASSERT_FALSE(timers.Start(4, 0, Duration{100}, Duration::zero()).has_value());
+}
+
+TEST_F(TimerServiceTest, DeadlinesSurviveClockWrap) {
+  FakeClock::ticks = 0xFFFF'FF00U;
+
+  Timers timers{};
+  timers.Start(1, 0, Duration{0x200}, Duration::zero());
+  timers.Start(2, 0, Duration{0x80}, Duration{0x100});
+
+  FakeClock::ticks = 0xFFFF'FFF0U;
+  ASSERT_THAT(Expire(timers), ElementsAre(Pair(2, 0xFFFF'FF80U)));
+
+  // The clock wraps before the next deadlines.
+  FakeClock::ticks = 0x100;
+  ASSERT_THAT(Expire(timers), ElementsAre(Pair(2, 0x80), Pair(1, 0x100)));
+  ASSERT_EQ(timers.TimeUntilNextDeadline(), Duration{0x80});
+}
+
+TEST_F(TimerServiceTest, ClockWrapsWhileIdleDoNotAffectNewTimers) {
+  Timers timers{};
+  Expire(timers);
+
+  // The clock wraps while no timer is active.
+  FakeClock::ticks = 500;
+  Expire(timers);
+  FakeClock::ticks = 400;
+
+  timers.Start(1, 0, Duration{200}, Duration::zero());
+  ASSERT_EQ(timers.TimeUntilNextDeadline(), Duration{200});
+
+  FakeClock::ticks = 599;
+  ASSERT_THAT(Expire(timers), IsEmpty());
+  FakeClock::ticks = 600;
+  ASSERT_THAT(Expire(timers), ElementsAre(Pair(1, 600)));
+}
+
+TEST_F(TimerServiceTest, WaitsAtMostHalfAClockWrap) {
+  FakeClock::ticks = 0;
+
+  Timers timers{};
+  timers.Start(1, 0, Duration{0xFFFF'FFF0U}, Duration::zero());
+  ASSERT_EQ(timers.TimeUntilNextDeadline(), Duration{0x7FFF'FFFFU});
+
+  // Polling within each half wrap keeps track of the time.
+  FakeClock::ticks = 0x7FFF'FFFFU;
+  ASSERT_THAT(Expire(timers), IsEmpty());
+  FakeClock::ticks = 0xFFFF'FFF0U;
+  ASSERT_THAT(Expire(timers), ElementsAre(Pair(1, 0xFFFF'FFF0U)));
+}